@@ -1,27 +1,40 @@
 #pragma once
 #include "TradingSystem/IMarketData.h"
+#include "TradingSystem/ISessionFilter.h"
+#include "TradingSystem/ReplayClock.h"
 #include <atomic>
+#include <memory>
 #include <thread>
 #include <string>
 #include <vector>
 #include <unordered_set>
 
 namespace ts {
-class BacktestMarketData : public IMarketData {
+class BacktestMarketData : public IMarketData, public ISessionFilter {
  public:
-  explicit BacktestMarketData(int speed_ms = 5);
+  explicit BacktestMarketData(int speed_ms = 5); // speed_ms为每行固定间隔，0为不限速
+  // 改为按事件时间节拍回放：speed为倍速，单个间隔夹紧到max_gap_ms
+  void set_replay_clock(double speed, int64_t max_gap_ms);
   ~BacktestMarketData() override;
-  bool connect(const std::string& front) override; // front作为CSV文件路径
+  bool connect(const std::string& front) override; // front作为CSV文件路径（扩展名.ticks时按二进制Tick库回放）
   bool login(const std::string& broker_id, const std::string& user_id, const std::string& password) override;
   bool subscribe(const std::vector<std::string>& instruments) override;
   void set_market_data_handler(MarketDataHandler handler) override;
+  bool finished() const override { return done_.load(std::memory_order_acquire); }
+  int64_t replay_start_ms() override;
+  void stop() override;
+  void set_session_calendar(const SessionCalendar* calendar) override { calendar_ = calendar; }
  private:
   void run_loop();
+  void run_store();
   std::string file_;
   int speed_ms_{5};
   MarketDataHandler handler_;
+  const SessionCalendar* calendar_{nullptr};
+  std::unique_ptr<ReplayClock> clock_;
   std::unordered_set<std::string> sub_set_;
   std::atomic<bool> running_{false};
+  std::atomic<bool> done_{false};
   std::thread worker_;
 };
 } // namespace ts
\ No newline at end of file
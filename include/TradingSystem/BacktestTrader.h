@@ -1,22 +1,18 @@
 #pragma once
 #include <string>
 #include <unordered_map>
-#include <deque>
+#include <list>
 #include "TradingSystem/ITrader.h"
 #include "TradingSystem/IBacktestMatching.h"
 #include "TradingSystem/Event.h"
+#include "TradingSystem/InstrumentMeta.h"
+#include "TradingSystem/MetricsRegistry.h"
 
 namespace ts {
 
-struct InstrumentMeta {
-  double tick_size{1.0};
-  int contract_multiplier{1};
-  double slippage_tick{0.0};
-};
-
 class BacktestTrader : public ITrader, public IBacktestMatching {
  public:
-  BacktestTrader() = default;
+  BacktestTrader();
   ~BacktestTrader() override = default;
 
   bool connect(const std::string& front) override;
@@ -25,40 +21,63 @@ class BacktestTrader : public ITrader, public IBacktestMatching {
 
   std::string place_order(const OrderRequest& order) override;
   bool cancel_order(const std::string& order_id) override;
+  // 队列优先级：同价减量保留排队位置；改价或加量视为新委托，移到同价队尾并立即尝试撮合
+  std::string modify_order(const std::string& order_id, double new_price, int new_qty) override;
 
   // IBacktestMatching
   void on_market_data(const MarketDataEvent& ev) override;
   void configure(const std::string& meta_path, const std::string& rules_path) override;
+  // 场景覆盖须在configure之后调用；覆盖的滑点对所有合约生效（优先于meta中的逐合约滑点）
+  void override_rules(const MatchingOverrides& o);
 
  private:
+  // 撮合全程用整数价格单位比较（见InstrumentMeta），仅在回报时换回浮点价格
   struct Tick {
-    double bid{0.0};
-    double ask{0.0};
+    int64_t bid{0};
+    int64_t ask{0};
     int bid_vol{0};
     int ask_vol{0};
-    double last{0.0};
-    std::string ts;
+    int64_t last{0};
+    const InstrumentMeta* meta{nullptr};
   };
   struct OrderRec {
     std::string id;
     OrderRequest req;
+    int64_t px{0};  // 限价（价格单位）：买单向下、卖单向上取整，成交价不劣于委托价
     int remaining{0};
-    std::string ts;
   };
 
   OrderStatusHandler handler_;
   std::unordered_map<std::string, Tick> last_tick_;
-  std::unordered_map<std::string, std::deque<OrderRec>> pending_; // 每合约的挂单队列（FIFO）
-  std::unordered_map<std::string, InstrumentMeta> meta_;
+  using OrderQueue = std::list<OrderRec>;
+  std::unordered_map<std::string, OrderQueue> pending_; // 每合约的挂单队列（FIFO）
+  // 挂单索引：order_id -> 所在队列与位置，撤单与改单O(1)定位
+  struct OrderLoc {
+    OrderQueue* queue;
+    OrderQueue::iterator it;
+  };
+  std::unordered_map<std::string, OrderLoc> index_;
+  // 队列结构变更计数（出队/移位）：撮合中回报回调若改动了队列，据此重新定位
+  uint64_t queue_epoch_{0};
+  InstrumentTable meta_;
 
   // 规则简版
   bool partial_fill_{true};
   double global_slippage_tick_{0.0};
+  double slippage_override_{-1.0};
+  std::string match_type_{"L1_tick"};  // 目前仅支持L1_tick：按对手方最优价与挂量撮合
+
+  // 运行期指标：成交率 = ts_bt_fill_qty_total / ts_bt_order_qty_total
+  struct Metrics {
+    Counter orders, order_qty, fills, fill_qty, partial_fills, cancels, rejects, modifies;
+  } metrics_;
 
   // 内部辅助
-  double tick_size(const std::string& instr) const;
-  double slippage_tick(const std::string& instr) const;
+  double slippage_tick(const InstrumentMeta& m) const;
+  int64_t limit_units(const InstrumentMeta& m, Direction dir, double price) const;
   void try_match(const std::string& instr, const Tick& tk);
+  void enqueue(const std::string& instr, const OrderRec& rec);
+  OrderQueue::iterator dequeue(OrderQueue& q, OrderQueue::iterator it);
   void emit_status(const std::string& id, const std::string& status, const std::string& msg,
                    const std::string& instrument = "",
                    int filled_qty = 0,
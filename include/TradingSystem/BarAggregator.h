@@ -1,26 +1,33 @@
 #pragma once
 #include <unordered_map>
 #include <functional>
-#include <chrono>
+#include <cstdint>
 #include <string>
 #include "Event.h"
 
 namespace ts {
+class SessionCalendar;
+struct TradingSessions;
+
+// 逐Tick聚合Bar：按行情事件时间切分，有交易时段的合约按时段起点对齐且Bar不跨休市；
+// 行情无可解析时间戳（如stub）时退回墙钟
 class BarAggregator {
  public:
   using BarHandler = std::function<void(const BarEvent&)>;
-  explicit BarAggregator(int interval_seconds);
+  explicit BarAggregator(int interval_seconds, const SessionCalendar* sessions = nullptr);
   void set_bar_handler(BarHandler h);
   void on_tick(const MarketDataEvent& md);
   void flush_all();
  private:
   struct Accum {
     BarEvent bar;
-    std::chrono::steady_clock::time_point start;
+    int64_t start_ms{-1};
+    const TradingSessions* sessions{nullptr};
   };
   int interval_{1};
+  const SessionCalendar* calendar_{nullptr};
   BarHandler handler_;
   std::unordered_map<std::string, Accum> acc_;
   static std::string now_string();
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TradingSystem/Event.h"
+#include "TradingSystem/MappedFile.h"
+
+namespace ts {
+
+class SessionCalendar;
+
+// 列式Tick数组：按文件顺序存放，inst为合约序号（下标对应instruments）
+struct TickColumns {
+  std::vector<std::string> instruments;
+  std::vector<int32_t> inst;
+  std::vector<int64_t> ts_ms;
+  std::vector<double> price;
+  std::vector<int64_t> volume;
+  size_t size() const { return ts_ms.size(); }
+};
+
+// 每合约一组Bar，外层下标与TickColumns::instruments一致
+using BarSeries = std::vector<std::vector<BarRecord>>;
+
+// 从逐Tick CSV（与BacktestMarketData相同的两种格式）读入列式数组；无时间戳的行被跳过
+bool load_tick_columns(const std::string& csv_path, TickColumns* out, std::string* err = nullptr);
+
+// 按合约分组后，用向量化min/max/sum核计算每个周期的OHLCV；分组只做一次。
+// 给出calendar时，配置了时段的合约按时段起点对齐（与BarAggregator一致），休市Tick不入Bar；其余按自然周期对齐
+BarSeries build_bars(const TickColumns& ticks, int interval_sec, const SessionCalendar* calendar = nullptr);
+std::vector<BarSeries> build_bars(const TickColumns& ticks, const std::vector<int>& intervals_sec,
+                                  const SessionCalendar* calendar = nullptr);
+
+// Bar缓存文件路径：以源文件(绝对路径+大小+修改时间)与周期为键；按时段对齐的缓存另含时段摘要
+std::string bar_cache_path(const std::string& cache_dir, const std::string& source_path, int interval_sec,
+                           const SessionCalendar* calendar = nullptr);
+bool write_bar_file(const std::string& path, const std::string& source_path, int interval_sec,
+                    const std::vector<std::string>& instruments, const BarSeries& bars);
+
+// 只读的mmap Bar缓存文件
+class BarFile {
+ public:
+  // 打开并校验格式；source_path非空时同时校验源文件大小与修改时间
+  bool open(const std::string& path, const std::string& source_path = "");
+  int interval_sec() const { return interval_sec_; }
+  size_t instrument_count() const { return count_; }
+  std::string instrument(size_t i) const;
+  const BarRecord* bars(size_t i, size_t* n) const;
+
+ private:
+  MappedFile file_;
+  int interval_sec_{0};
+  size_t count_{0};
+};
+
+// 打开缓存；缺失或过期时从CSV构建并写入缓存目录
+bool ensure_bar_cache(const std::string& cache_dir, const std::string& source_path, int interval_sec,
+                      BarFile* out, std::string* err = nullptr, const SessionCalendar* calendar = nullptr);
+
+} // namespace ts
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TradingSystem/Event.h"
+#include "TradingSystem/MappedFile.h"
+
+namespace ts {
+
+// Bar历史库：每合约每周期一个只追加文件 <dir>/<合约>.<周期>s.hist（定长文件头+BarRecord数组，时间升序）。
+// 启动时mmap读出供策略预热，运行中每根完成的Bar追加写入；文件头笔数在每次追加后回填，进程异常退出不丢已写Bar。
+class BarHistory {
+ public:
+  BarHistory(std::string dir, int interval_sec);
+  ~BarHistory();
+  BarHistory(const BarHistory&) = delete;
+  BarHistory& operator=(const BarHistory&) = delete;
+
+  int interval_sec() const { return interval_sec_; }
+  // 目录中已有本周期历史的合约
+  std::vector<std::string> instruments() const;
+  // 只读映射某合约在end_ms之前已结束的历史（Bar起点+周期不晚于end_ms）；无历史或格式不符时n为0。
+  // 指针在close_readers之前有效
+  const BarRecord* load(const std::string& instrument, size_t* n, int64_t end_ms = INT64_MAX);
+  // 预热结束后释放只读映射
+  void close_readers();
+  // 追加一根已完成的Bar；起始时间不晚于已存最后一根时忽略（重启重叠或重复回放不产生重复）
+  bool append(const std::string& instrument, const BarRecord& bar);
+  // 截断各文件到实际长度并关闭
+  void close();
+
+ private:
+  struct Writer {
+    WritableMappedFile file;
+    uint64_t count{0};
+    int64_t last_ts{INT64_MIN};
+    bool failed{false};
+  };
+  std::string path_of(const std::string& instrument) const;
+  Writer* writer(const std::string& instrument);
+
+  std::string dir_;
+  int interval_sec_;
+  std::unordered_map<std::string, MappedFile> readers_;
+  std::unordered_map<std::string, std::unique_ptr<Writer>> writers_;
+};
+
+} // namespace ts
@@ -0,0 +1,49 @@
+#pragma once
+#include "TradingSystem/IMarketData.h"
+#include "TradingSystem/IBarSource.h"
+#include "TradingSystem/ISessionFilter.h"
+#include "TradingSystem/BarBuilder.h"
+#include "TradingSystem/ReplayClock.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+namespace ts {
+// 仅Bar回放：从Bar缓存（缺失时由逐Tick CSV离线构建）按时间归并回放，
+// 每根Bar先以收盘价合成一笔行情（供撮合与风控），再直接送达Strategy::on_bar
+class BarReplayMarketData : public IMarketData, public IBarSource, public ISessionFilter {
+ public:
+  BarReplayMarketData(int interval_sec, std::string cache_dir);
+  ~BarReplayMarketData() override;
+  bool connect(const std::string& front) override; // front作为逐Tick CSV路径（缓存键），缓存在subscribe时打开
+  bool login(const std::string& broker_id, const std::string& user_id, const std::string& password) override;
+  bool subscribe(const std::vector<std::string>& instruments) override;
+  void set_market_data_handler(MarketDataHandler handler) override;
+  bool finished() const override { return done_.load(std::memory_order_acquire); }
+  int64_t replay_start_ms() override;  // 最早一根Bar的起点（需打开缓存）
+  void stop() override;
+  void set_bar_handler(BarEventHandler handler) override;
+  void set_session_calendar(const SessionCalendar* calendar) override { calendar_ = calendar; }
+  // 按Bar结束时间节拍回放（默认不限速）
+  void set_replay_clock(double speed, int64_t max_gap_ms);
+ private:
+  void run_loop();
+  bool open_cache();
+  int interval_sec_{1};
+  std::string cache_dir_;
+  std::string file_;
+  BarFile bars_;
+  bool cache_open_{false};
+  const SessionCalendar* calendar_{nullptr};
+  std::unique_ptr<ReplayClock> clock_;
+  MarketDataHandler handler_;
+  BarEventHandler bar_handler_;
+  std::unordered_set<std::string> sub_set_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> done_{false};
+  std::thread worker_;
+};
+} // namespace ts
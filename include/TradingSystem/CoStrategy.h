@@ -0,0 +1,168 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TradingSystem/Strategy.h"
+
+namespace ts {
+
+// 协程帧：无栈协程的恢复点、当前等待条件与最近一次唤醒结果。
+// 派生帧类型在此之上加入自己的字段；跨等待保留的状态必须放在帧里（局部变量不跨TS_CO_AWAIT保留）
+struct CoFrame {
+  enum class Wait : uint8_t { None, Order, Bar, Tick, Sleep };
+
+  int resume_point{0};  // TS_CO_*宏维护：0为起点，-1为已结束
+
+  // 当前跟踪的订单（place设置），随回报累计
+  std::string order_id;
+  std::string order_status;  // 最近一次回报状态
+  bool order_done{false};    // 已完结（Filled/Canceled/Rejected）或下单失败
+  int filled_qty{0};
+  double avg_fill_price{0.0};
+
+  // 唤醒结果：timed_out为等待超时（sleep到期同样置位）；bar/tick仅在被其唤醒后的本段内有效
+  bool timed_out{false};
+  const BarEvent* bar{nullptr};
+  const MarketDataEvent* tick{nullptr};
+
+  // 以下由调度器维护
+  Wait wait{Wait::None};
+  std::string instrument;  // Bar/Tick等待的合约，空为任意
+  int bars_left{0};
+  uint64_t timer_id{0};
+  uint32_t slot{0};
+  bool active{false};
+  bool queued{false};
+};
+
+// 无栈协程宏（switch实现）：协程体写成 void run(Frame& f) { TS_CO_BEGIN(f); ... TS_CO_END(f); }。
+// TS_CO_AWAIT(f, 等待) 中等待条件已满足时直接继续，否则挂起，条件满足后从该处恢复
+#define TS_CO_BEGIN(f) switch ((f).resume_point) { case 0:
+#define TS_CO_AWAIT(f, awaiter)        \
+  do {                                 \
+    (f).resume_point = __LINE__;       \
+    if (awaiter) return;               \
+    [[fallthrough]];                   \
+    case __LINE__:;                    \
+  } while (0)
+#define TS_CO_RETURN(f) \
+  do {                  \
+    (f).resume_point = -1; \
+    return;             \
+  } while (0)
+#define TS_CO_END(f) } (f).resume_point = -1
+
+// 协程策略基类：把下单→等成交或超时→对冲之类的顺序逻辑写成协程，不必手写跨回调的状态机。
+// 帧取自固定容量的池，等待不分配内存；协程只在派发线程上、策略回调内恢复，无额外线程与锁。
+// 回测与合成行情下回报在派发线程同步到达；实盘回报线程上的回报先入收件箱，经1ms定时器转到派发线程处理。
+class CoStrategyBase : public Strategy {
+ public:
+  void on_market_data(const MarketDataEvent& md, ITrader* trader) final;
+  void on_bar(const BarEvent& bar, ITrader* trader) final;
+  void on_order_status(const OrderStatusEvent& ev) final;
+  void on_timer(uint64_t timer_id, uint64_t user_data, ITrader* trader) final;
+  void on_start(ITrader* trader) final;
+  void on_stop(ITrader* trader) final;
+
+  // 使用中的帧数
+  size_t active_frames() const { return active_; }
+
+ protected:
+  explicit CoStrategyBase(size_t capacity);
+
+  // 派生策略钩子：在等待者恢复之后调用，可在其中启动新协程
+  virtual void on_co_start() {}
+  virtual void on_co_stop() {}
+  virtual void on_co_tick(const MarketDataEvent& md) {}
+  virtual void on_co_bar(const BarEvent& bar) {}
+  // 不属于任何帧的订单回报
+  virtual void on_co_order(const OrderStatusEvent& ev) {}
+  // 策略自行调度的定时器（user_data最高两位保留给调度器）
+  virtual void on_co_timer(uint64_t timer_id, uint64_t user_data) {}
+
+  ITrader* trader() const { return trader_; }
+  // 启动一个已取得的帧：当前无协程在执行时立即运行到首个挂起点，否则排队
+  void start(CoFrame& f);
+
+  // 帧内操作
+  // 下单并由该帧跟踪回报；下单期间同步到达的回报同样计入。失败时order_done为真并返回false
+  bool place(CoFrame& f, const OrderRequest& req);
+  // 撤销该帧跟踪的订单
+  bool cancel(CoFrame& f);
+  // 以下等待返回true表示须挂起（与TS_CO_AWAIT配合使用）；timeout_ms<=0为不限时
+  // 等待跟踪的订单完结
+  bool await_order(CoFrame& f, int64_t timeout_ms);
+  // 等待该合约（空为任意）再完成n根Bar
+  bool await_bars(CoFrame& f, const std::string& instrument, int n = 1);
+  // 等待该合约（空为任意）的下一笔行情
+  bool await_tick(CoFrame& f, const std::string& instrument, int64_t timeout_ms);
+  // 按定时器时钟等待ms毫秒
+  bool sleep(CoFrame& f, int64_t ms);
+
+  // 供模板派生类：取空闲槽序号（满时返回-1）与绑定帧存储
+  int acquire_slot();
+  void bind_frame(size_t slot, CoFrame* f) { slots_[slot] = f; }
+
+ private:
+  virtual void resume(CoFrame& f) = 0;
+
+  void enter();
+  void drain_inbox();
+  void handle_order(const OrderStatusEvent& ev);
+  void apply(CoFrame& f, const OrderStatusEvent& ev);
+  void arm(CoFrame& f, int64_t timeout_ms);
+  void wake(CoFrame& f);
+  void run_ready();
+  void release(CoFrame& f);
+
+  static constexpr uint64_t kFrameTimer = 1ull << 63;
+  static constexpr uint64_t kInboxTimer = 1ull << 62;
+
+  ITrader* trader_{nullptr};
+  std::vector<CoFrame*> slots_;
+  std::vector<uint32_t> free_;
+  std::vector<uint32_t> ready_;
+  size_t active_{0};
+  int tick_waiters_{0};
+  int bar_waiters_{0};
+  bool running_{false};
+  // 下单调用期间同步到达的未知订单回报，调用返回后按订单ID归属（元素复用，稳定后不再分配）
+  bool placing_{false};
+  std::vector<OrderStatusEvent> early_;
+  size_t early_n_{0};
+  // 派发线程与跨线程回报收件箱
+  std::atomic<std::thread::id> dispatch_tid_{};
+  std::mutex inbox_mu_;
+  std::vector<OrderStatusEvent> inbox_, inbox_work_;
+  std::atomic<bool> inbox_pending_{false};
+};
+
+// 帧类型为Frame（派生自CoFrame）、容量为N的协程策略；派生类实现 void run(Frame& f)
+template <class Frame, size_t N = 16>
+class CoStrategy : public CoStrategyBase {
+ protected:
+  CoStrategy() : CoStrategyBase(N) {
+    for (size_t i = 0; i < N; ++i) bind_frame(i, &frames_[i]);
+  }
+  // 取一个复位后的空闲帧，池满时返回nullptr；设置字段后调用start
+  Frame* spawn() {
+    const int slot = acquire_slot();
+    if (slot < 0) return nullptr;
+    Frame& f = frames_[static_cast<size_t>(slot)];
+    f = Frame();
+    f.slot = static_cast<uint32_t>(slot);
+    f.active = true;
+    return &f;
+  }
+  virtual void run(Frame& f) = 0;
+
+ private:
+  void resume(CoFrame& f) final { run(static_cast<Frame&>(f)); }
+  std::array<Frame, N> frames_;
+};
+
+} // namespace ts
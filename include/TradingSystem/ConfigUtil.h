@@ -1,8 +1,18 @@
 #pragma once
 #include <string>
+#include <vector>
 #include "Engine.h"
 
 namespace ts {
-// 从简易INI配置文件加载AppConfig；ok为可选输出指示是否加载成功
-AppConfig load_app_config(const std::string& path, bool* ok = nullptr);
+// 从简易INI配置文件加载AppConfig；ok为可选输出指示是否加载成功。
+// base非空时以其为底叠加文件中出现的键（热更新重载用），否则从编译期默认值开始
+AppConfig load_app_config(const std::string& path, bool* ok = nullptr, const AppConfig* base = nullptr);
+
+// 朴素JSON取值（用于meta.json/config.json这类扁平文档）：查找首个 "key": 之后的值
+bool read_text_file(const std::string& path, std::string* out);
+bool json_number(const std::string& doc, const std::string& key, double* out);
+bool json_string_array(const std::string& doc, const std::string& key, std::vector<std::string>* out);
+bool json_string(const std::string& doc, const std::string& key, std::string* out);
+// 将对象数组（如meta.json）拆为各对象的文本，逐个再用上述函数取值；对象内不可再嵌套对象
+bool json_objects(const std::string& doc, std::vector<std::string>* out);
 }
\ No newline at end of file
@@ -1,16 +1,27 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include "IBacktestMatching.h"
 #include "IMarketData.h"
 #include "ITrader.h"
 #include "Strategy.h"
+#include "StrategyHost.h"
 
 namespace ts {
+class MarketDataStage;
+class TickRecorder;
+class ScenarioReplica;
+class ConfigWatcher;
+class PerfMetrics;
 
 struct AppConfig {
   bool use_ctp{false};
   bool use_backtest{false};
+  bool use_synthetic{false};    // 合成行情（压测/浸泡测试），撮合同回测
   std::string md_front;
   std::string td_front;
   std::string broker_id;
@@ -24,17 +35,90 @@ struct AppConfig {
   int min_order_interval_ms{500};
   // 回测配置
   std::string backtest_file;
-  int backtest_speed_ms{5};
+  int backtest_speed_ms{5};         // fixed节拍：每行固定间隔（毫秒，0为不限速）
+  std::string replay_pacing{"fixed"}; // fixed（按backtest_speed_ms）/event（按事件时间倍速）
+  double replay_speed{1.0};          // event节拍倍速，如1/10/100
+  int replay_max_gap_ms{5000};       // event节拍单个间隔上限（毫秒），跳过休市空档
   std::string backtest_meta;    // meta.json路径
   std::string backtest_rules;   // config.json路径
+  bool backtest_clean{false};            // 回放前并行清洗校验逐Tick数据，回放清洗结果
+  std::string backtest_clean_dir{"data/clean"}; // 清洗结果与异常报告目录
+  bool backtest_bar_replay{false};       // 仅Bar回放（跳过逐Tick聚合）
+  std::string bar_cache_dir{"data/bar_cache"}; // Bar缓存目录
+  std::string bar_history_dir;           // Bar历史库目录（启动预热并追加新Bar），空为关闭
+  // 合成行情：合约数（instruments为空时生效）、价格模型、到达率（笔/秒，事件时间）与爆发、种子与总笔数
+  int synth_instruments{100};
+  std::string synth_model{"gbm"};
+  double synth_rate{100000.0};
+  double synth_burst_factor{20.0};
+  double synth_burst_prob{0.0005};
+  double synth_burst_len{2000.0};
+  double synth_zipf{1.0};
+  double synth_vol{0.25};
+  double synth_mean_revert{5.0};
+  double synth_price{4000.0};
+  double synth_tick_size{0.2};
+  uint64_t synth_seed{42};
+  uint64_t synth_events{0};
+  std::string synth_store;      // 非空时同时写出二进制Tick库（.ticks）
+  bool session_filter{true};    // 按meta.json的session：回放跳过休市数据、Bar按时段对齐、风控拦截休市下单
   // 运行与日志配置
-  int run_seconds{20};
+  // 热更新：监视配置文件，风控限额与策略参数变更后无需重启即生效
+  bool hot_reload{false};
+  std::string config_path;      // 加载时记录的配置文件路径
+  int run_seconds{20};          // 运行时长上限（秒）；回放类行情送完即提前结束，<=0不限时
   bool enable_csv_logs{true};
   std::string csv_dir{"data"};
+  int metrics_sample_sec{60};   // 绩效统计权益采样周期（秒，事件时间）
+  // 运行期指标导出：回环HTTP端口（0关闭）、快照周期（秒，0关闭）与快照路径（空为csv_dir/metrics.prom）
+  int metrics_http_port{0};
+  int metrics_snapshot_sec{0};
+  std::string metrics_snapshot_path;
+  // 事件时间线追踪：输出路径（空为关闭）、行情采样间隔（每N笔记录一笔）与每线程缓冲事件数
+  std::string trace_file;
+  int trace_sample{64};
+  int trace_buffer_events{262144};
   // 策略参数（可配置）
   int strat_ma_fast{3};
   int strat_ma_slow{8};
   double strat_threshold{0.5};
+  int strat_order_timeout_ms{0};  // 内置策略挂单超时撤单（毫秒，定时器时钟），0为不撤
+  // 协程突破策略：通道回看Bar数、持仓Bar数、开仓限价偏移与开仓等待（毫秒）
+  int co_lookback_bars{8};
+  int co_hold_bars{3};
+  double co_entry_offset{0.5};
+  int co_entry_timeout_ms{500};
+  // 策略选择：cpp_builtin（按builtin_class创建）或 python_embed（嵌入Python）
+  std::string strategy_type{"cpp_builtin"};
+  std::string builtin_class{"DualMAStrategy"};
+  std::string python_module{"ts_strategy"};
+  std::string python_class{"MyStrategy"};
+  std::string python_path;
+  int python_batch_size{1};     // 每批交给Python的行情/Bar条数
+  std::string signals_file;
+  // 多策略托管：非空时取代builtin_class；每项为 类名[@合约|合约]，@后的合约覆盖策略自身的订阅声明
+  std::vector<std::string> strategies;
+  // 多场景回测：同一遍回放同时驱动各场景的撮合/风控/策略副本，每个场景以scenario.<名>.<规则>覆盖撮合规则
+  std::vector<std::string> scenarios;
+  std::unordered_map<std::string, MatchingOverrides> scenario_rules;
+  // 线程拓扑：各角色绑定的CPU（-1不绑定）、队列等待方式（block/yield/spin）与大页
+  int cpu_feed{-1};
+  int cpu_engine{-1};
+  int cpu_logger{-1};
+  std::string wait_logger{"block"};
+  std::string wait_engine{"block"};
+  bool huge_pages{false};
+  // 行情缓冲级：direct（行情线程直接回调，默认）/conflate/queue/drop
+  std::string md_policy{"direct"};
+  int md_max_instruments{1024};
+  int md_queue_capacity{65536};
+  // 行情录制：非空时把进入引擎的行情按交易日写入 <record_dir>/YYYYMMDD.ticks
+  std::string record_dir;
+  int record_max_instruments{1024};
+  int record_queue_capacity{65536};
+  // 日志配置：全局运行期级别与按组件覆盖（log_level.<component>=level）
+  std::string log_level{"info"};
+  std::unordered_map<std::string, std::string> log_component_levels;
 };
 
 class Engine {
@@ -43,12 +127,28 @@ class Engine {
          std::unique_ptr<IMarketData> md,
          std::unique_ptr<ITrader> td,
          std::unique_ptr<Strategy> strat);
+  Engine(AppConfig cfg,
+         std::unique_ptr<IMarketData> md,
+         std::unique_ptr<ITrader> td,
+         std::vector<HostedStrategy> strategies);
+  ~Engine();
+  // 追加一个回测场景（run之前调用）：策略须与主场景按同一配置另行创建
+  void add_scenario(const std::string& name, std::vector<HostedStrategy> strategies);
   int run();
+  // 请求事件循环停止（可在其他线程或信号处理中调用）
+  void stop() { stop_requested_.store(true, std::memory_order_relaxed); }
  private:
+  void write_scenario_report(const PerfMetrics& base, const std::string& csv_dir) const;
+
   AppConfig cfg_;
+  std::unique_ptr<TickRecorder> recorder_;  // 可选；须在md_之后析构（行情线程可能仍在录制）
   std::unique_ptr<IMarketData> md_;
   std::unique_ptr<ITrader> td_;
-  std::unique_ptr<Strategy> strat_;
+  std::unique_ptr<StrategyHost> host_;
+  std::unique_ptr<MarketDataStage> md_stage_;  // 可选；须在md_之后析构（行情线程可能仍在写入）
+  std::vector<std::unique_ptr<ScenarioReplica>> scenarios_;  // 主场景之外的回测场景
+  std::unique_ptr<ConfigWatcher> config_watcher_;
+  std::atomic<bool> stop_requested_{false};
 };
 
 } // namespace ts
\ No newline at end of file
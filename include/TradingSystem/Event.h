@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <functional>
@@ -20,6 +21,8 @@ struct MarketDataEvent {
   int bid_volume{0};
   int ask_volume{0};
   std::string update_time; // e.g., "2024-01-01 09:30:00.000"
+  double turnover{0.0};      // 本笔成交额（实盘由累计值差分得到，回放源不提供时为0）
+  double open_interest{0.0}; // 持仓量（非增量）
 };
 
 struct OrderRequest {
@@ -33,7 +36,7 @@ struct OrderRequest {
 
 struct OrderStatusEvent {
   std::string order_id;
-  std::string status; // Accepted, Filled, PartiallyFilled, Canceled, Rejected
+  std::string status; // Accepted, Modified, Filled, PartiallyFilled, Canceled, Rejected
   std::string message;
   // 结构化补充字段（可选使用）
   std::string instrument;
@@ -52,6 +55,16 @@ struct BarEvent {
   std::string ts; // bar时间戳（简单字符串）
 };
 
+// 定长Bar记录（Bar缓存与Bar历史文件的存储格式），ts_ms为Bar起始时间
+struct BarRecord {
+  int64_t ts_ms;
+  double open;
+  double high;
+  double low;
+  double close;
+  int64_t volume;
+};
+
 using MarketDataHandler = std::function<void(const MarketDataEvent&)>;
 using BarEventHandler = std::function<void(const BarEvent&)>;
 using OrderStatusHandler = std::function<void(const OrderStatusEvent&)>;
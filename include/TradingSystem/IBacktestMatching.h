@@ -4,6 +4,13 @@
 
 namespace ts {
 
+// 撮合规则覆盖（多场景回测）：负值或空串表示沿用config.json
+struct MatchingOverrides {
+  double slippage_tick{-1.0};
+  int partial_fill{-1};  // -1沿用，0/1覆盖
+  std::string match_type;
+};
+
 // 供回测撮合器在引擎内接收行情与加载配置
 struct IBacktestMatching {
   virtual ~IBacktestMatching() = default;
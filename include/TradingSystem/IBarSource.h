@@ -0,0 +1,12 @@
+#pragma once
+#include "TradingSystem/Event.h"
+
+namespace ts {
+
+// 可直接产出Bar的行情源（如Bar缓存回放）；引擎检测到后跳过逐Tick聚合
+struct IBarSource {
+  virtual ~IBarSource() = default;
+  virtual void set_bar_handler(BarEventHandler handler) = 0;
+};
+
+} // namespace ts
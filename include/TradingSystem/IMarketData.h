@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <functional>
@@ -13,5 +14,12 @@ class IMarketData {
   virtual bool login(const std::string& broker_id, const std::string& user_id, const std::string& password) = 0;
   virtual bool subscribe(const std::vector<std::string>& instruments) = 0;
   virtual void set_market_data_handler(MarketDataHandler handler) = 0;
+  // 有限行情源（回放）已送完全部数据时返回true，引擎据此结束运行；实时行情始终为false
+  virtual bool finished() const { return false; }
+  // 回放类行情源：回放数据的起始事件时间（毫秒），须在subscribe之前可用；引擎据此截断预热历史，避免预热看到回放区间内的Bar。
+  // 实时行情返回INT64_MAX（历史全部可用），起点无法确定时返回-1
+  virtual int64_t replay_start_ms() { return INT64_MAX; }
+  // 停止送出行情：返回后不再调用处理器（有行情线程的实现在此汇合），可重复调用。引擎退出事件循环时调用
+  virtual void stop() {}
 };
 }
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+
+namespace ts {
+class SessionCalendar;
+
+// 可按交易时段过滤的行情源（回放）；引擎加载时段日历后注入，休市数据在源头跳过
+struct ISessionFilter {
+  virtual ~ISessionFilter() = default;
+  virtual void set_session_calendar(const SessionCalendar* calendar) = 0;
+};
+
+} // namespace ts
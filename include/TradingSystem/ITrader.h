@@ -12,6 +12,13 @@ class ITrader {
   virtual bool login(const std::string& broker_id, const std::string& user_id, const std::string& password) = 0;
   virtual std::string place_order(const OrderRequest& req) = 0;
   virtual bool cancel_order(const std::string& order_id) = 0;
+  // 改单（撤改）：把在途订单改为new_price/new_qty（new_qty为改后的未成交量）。
+  // 返回此后承载该订单的ID：原生支持时与原ID相同；以撤单+新单实现的渠道返回新ID；失败返回空串。
+  // 成功时推送状态"Modified"（remaining_qty为改后未成交量）。默认不支持
+  virtual std::string modify_order(const std::string& order_id, double new_price, int new_qty) {
+    (void)order_id; (void)new_price; (void)new_qty;
+    return std::string();
+  }
   virtual void set_order_status_handler(OrderStatusHandler handler) = 0;
 };
 }
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace ts {
+
+// 定点金额：1单位 = 1/kMoneyScale 元
+constexpr int64_t kMoneyScale = 10000;
+// 手续费率的定点倍数（percent类费率×1e8）
+constexpr int64_t kFeeRateScale = 100000000;
+
+// 整数除法，四舍五入（远离0）；d须为正
+inline int64_t div_round(int64_t n, int64_t d) { return n >= 0 ? (n + d / 2) / d : -((-n + d / 2) / d); }
+
+// 合约参数（meta.json），价格与金额的定点换算在加载时预先算好。
+// 价格以int64"价格单位"计：已登记合约的单位即最小变动价位；未登记合约沿用1.0的默认跳价，
+// 但以1e-4为单位（per_tick=10000）表示，不把非整数报价截断到整数。
+struct InstrumentMeta {
+  double tick_size{1.0};
+  int contract_multiplier{1};
+  double slippage_tick{0.0};
+  bool fee_per_lot{false};  // fee_type：per_lot为每手固定金额，否则为成交额比例
+  double fee_open{0.0};
+  double fee_close{0.0};
+  double fee_close_today{0.0};
+
+  // 以下由finalize()计算
+  int64_t per_tick{10000};       // 每跳价含多少价格单位
+  int64_t money_per_unit{1};     // 一手价格变动一个单位对应的金额（定点）
+  int64_t fee_open_fp{0};        // 每手金额（定点）或费率×kFeeRateScale
+  int64_t fee_close_fp{0};
+  int64_t fee_close_today_fp{0};
+
+  void finalize(bool known);
+
+  // 价格换算：to_units四舍五入；floor/ceil容忍浮点误差（如3500.4/0.2=17501.999…）
+  int64_t to_units(double px) const;
+  int64_t floor_units(double px) const;
+  int64_t ceil_units(double px) const;
+  double to_price(int64_t units) const { return static_cast<double>(units) * tick_size / static_cast<double>(per_tick); }
+  // 按跳价对齐（四舍五入）
+  int64_t round_to_tick(int64_t units) const { return per_tick == 1 ? units : div_round(units, per_tick) * per_tick; }
+  // 成交qty手、价格px（价格单位）时的手续费（定点金额）
+  int64_t fee(int64_t fee_fp, int64_t px, int qty) const;
+};
+
+// 合约参数表：从meta.json加载，未登记合约取默认值
+class InstrumentTable {
+ public:
+  InstrumentTable();
+  // 返回加载的合约数
+  size_t load_meta(const std::string& meta_path);
+  const InstrumentMeta& get(const std::string& instrument) const;
+  bool empty() const { return meta_.empty(); }
+
+ private:
+  std::unordered_map<std::string, InstrumentMeta> meta_;
+  InstrumentMeta default_;
+};
+
+} // namespace ts
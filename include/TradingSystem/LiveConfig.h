@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TradingSystem/MetricsRegistry.h"
+#include "TradingSystem/RiskManager.h"
+
+namespace ts {
+struct AppConfig;
+
+// 可热更新的运行参数快照，发布后不再修改
+struct LiveParams {
+  RiskConfig risk;
+  int strat_ma_fast{3};
+  int strat_ma_slow{8};
+  double strat_threshold{0.5};
+  int strat_order_timeout_ms{0};
+  uint64_t version{0};  // 每次发布递增，读方据此判断是否需要重新套用
+};
+
+LiveParams live_params_from(const AppConfig& cfg);
+// live_params_from的逆向：把快照中的参数写回cfg
+void apply_live_params(const LiveParams& p, AppConfig* cfg);
+
+// RCU式参数发布：写方构造新快照后以原子指针替换，读方在下单路径上只做一次acquire load，无锁无等待。
+// 旧快照退役后保留至进程结束：热更新由人工改配置触发、次数有限，以少量内存省去宽限期追踪。
+// 未发布时current()为nullptr，读方沿用构造时的参数。
+class LiveConfig {
+ public:
+  static LiveConfig& instance();
+
+  const LiveParams* current() const { return cur_.load(std::memory_order_acquire); }
+  // 参数与当前快照相同时不发布，返回false
+  bool publish(const LiveParams& p);
+
+ private:
+  LiveConfig() = default;
+  std::atomic<const LiveParams*> cur_{nullptr};
+  std::mutex write_mu_;
+  std::vector<std::unique_ptr<const LiveParams>> snapshots_;
+};
+
+// 配置文件监视线程：Linux上以inotify监视所在目录（兼容编辑器先写临时文件再改名），其他平台按100ms轮询修改时间。
+// 变更后在本线程重新解析并发布新快照，只套用风控限额与策略参数，其余键仍需重启生效。
+// 重新解析以启动配置叠加当前快照为底，文件中缺失的键保持现值，不回落到编译期默认值。
+class ConfigWatcher {
+ public:
+  ConfigWatcher(std::string path, const AppConfig& base);
+  ~ConfigWatcher();
+  ConfigWatcher(const ConfigWatcher&) = delete;
+  ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+  bool start();
+  void stop();
+
+ private:
+  void run();
+  void reload();
+
+  std::string path_;
+  std::unique_ptr<const AppConfig> base_;
+  std::atomic<bool> running_{false};
+  std::thread worker_;
+  Counter reloads_;
+};
+
+} // namespace ts
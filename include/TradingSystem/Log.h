@@ -0,0 +1,157 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <ostream>
+
+// 编译期日志级别：低于该级别的日志语句在编译期整体消除（0=Trace 1=Debug 2=Info 3=Warn 4=Error 5=Off）
+#ifndef TS_LOG_COMPILE_LEVEL
+#define TS_LOG_COMPILE_LEVEL 1
+#endif
+
+namespace ts {
+namespace log {
+
+enum class Level : int { Trace = 0, Debug = 1, Info = 2, Warn = 3, Error = 4, Off = 5 };
+
+// 日志组件：每个组件可在config.ini中单独设置运行期级别
+enum class Component : int { Engine = 0, MarketData, Trader, Risk, Strategy, Count };
+
+// 单条日志记录的参数载荷大小（超出部分的字符串会被截断）
+constexpr size_t kPayloadSize = 216;
+
+// 运行期级别表（按组件），调用线程仅做一次relaxed读取
+inline std::atomic<int> g_levels[static_cast<int>(Component::Count)] = {
+    {static_cast<int>(Level::Info)}, {static_cast<int>(Level::Info)}, {static_cast<int>(Level::Info)},
+    {static_cast<int>(Level::Info)}, {static_cast<int>(Level::Info)}};
+
+inline bool enabled(Level lvl, Component comp) {
+  return static_cast<int>(lvl) >= g_levels[static_cast<int>(comp)].load(std::memory_order_relaxed);
+}
+
+// 解析级别字符串（trace/debug/info/warn/error/off），失败返回false
+bool parse_level(const std::string& s, Level* out);
+// 按组件名（engine/md/trader/risk/strategy）设置运行期级别
+void configure(const std::string& default_level,
+               const std::unordered_map<std::string, std::string>& component_levels);
+// 排空队列并停止后台线程（程序退出前调用；析构时也会自动调用）
+void shutdown();
+// 因队列满而丢弃的日志条数
+uint64_t dropped();
+
+namespace detail {
+
+using DecodeFn = void (*)(const char* payload, uint8_t nargs, std::ostream& os);
+
+struct Slot {
+  DecodeFn decode{nullptr};
+  int64_t ts_ns{0};
+  Level level{Level::Info};
+  Component comp{Component::Engine};
+  uint8_t nargs{0};
+  char payload[kPayloadSize];
+};
+// 申请一个槽位（队列满返回nullptr），填充后commit交给后台线程
+Slot* acquire();
+void commit(Slot* s);
+
+// 参数捕获规则：算术/枚举类型按值拷贝，字符串按 [u16长度][字节] 拷贝；空间不足时encode返回nullptr
+template <class T>
+struct Arg {
+  static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                "TS_LOG only captures arithmetic, enum and string arguments");
+  static char* encode(char* p, char* end, const T& v) {
+    if (p + sizeof(T) > end) return nullptr;
+    std::memcpy(p, &v, sizeof(T));
+    return p + sizeof(T);
+  }
+  static const char* decode(const char* p, std::ostream& os) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    if constexpr (std::is_enum<T>::value) os << static_cast<typename std::underlying_type<T>::type>(v);
+    else if constexpr (std::is_same<T, bool>::value) os << (v ? "true" : "false");
+    else os << v;
+    return p + sizeof(T);
+  }
+};
+
+struct StrArg {
+  static char* encode_sv(char* p, char* end, std::string_view sv) {
+    if (p + sizeof(uint16_t) > end) return nullptr;
+    size_t room = static_cast<size_t>(end - p) - sizeof(uint16_t);
+    uint16_t n = static_cast<uint16_t>(sv.size() < room ? sv.size() : room);
+    std::memcpy(p, &n, sizeof(n));
+    std::memcpy(p + sizeof(n), sv.data(), n);
+    return p + sizeof(n) + n;
+  }
+  static const char* decode(const char* p, std::ostream& os) {
+    uint16_t n;
+    std::memcpy(&n, p, sizeof(n));
+    os.write(p + sizeof(n), n);
+    return p + sizeof(n) + n;
+  }
+};
+
+template <> struct Arg<std::string> : StrArg {
+  static char* encode(char* p, char* end, const std::string& v) { return encode_sv(p, end, v); }
+};
+template <> struct Arg<std::string_view> : StrArg {
+  static char* encode(char* p, char* end, std::string_view v) { return encode_sv(p, end, v); }
+};
+template <> struct Arg<const char*> : StrArg {
+  static char* encode(char* p, char* end, const char* v) { return encode_sv(p, end, v ? v : ""); }
+};
+template <> struct Arg<char*> : Arg<const char*> {};
+
+template <class T>
+using ArgOf = Arg<typename std::decay<T>::type>;
+
+// 仅解码成功捕获的前nargs个参数，其余以"..."标记截断
+template <class... A>
+void decode_all(const char* p, uint8_t nargs, std::ostream& os) {
+  uint8_t i = 0;
+  ((i < nargs ? (p = ArgOf<A>::decode(p, os), ++i) : i), ...);
+  if (nargs < sizeof...(A)) os << "...";
+}
+
+int64_t now_ns();
+
+}  // namespace detail
+
+// 调用线程只做参数拷贝与入队，格式化与输出在后台线程完成
+template <class... A>
+void write(Level lvl, Component comp, const A&... args) {
+  detail::Slot* s = detail::acquire();
+  if (!s) return;
+  s->decode = &detail::decode_all<A...>;
+  s->ts_ns = detail::now_ns();
+  s->level = lvl;
+  s->comp = comp;
+  char* p = s->payload;
+  char* end = s->payload + kPayloadSize;
+  uint8_t n = 0;
+  (void)(((p = detail::ArgOf<A>::encode(p, end, args)) != nullptr && (++n, true)) && ...);
+  s->nargs = n;
+  detail::commit(s);
+}
+
+}  // namespace log
+}  // namespace ts
+
+#define TS_LOG(lvl, comp, ...)                                                                  \
+  do {                                                                                          \
+    if constexpr (static_cast<int>(::ts::log::Level::lvl) >= TS_LOG_COMPILE_LEVEL) {            \
+      if (::ts::log::enabled(::ts::log::Level::lvl, ::ts::log::Component::comp))                \
+        ::ts::log::write(::ts::log::Level::lvl, ::ts::log::Component::comp, __VA_ARGS__);       \
+    }                                                                                           \
+  } while (0)
+
+#define TS_LOG_TRACE(comp, ...) TS_LOG(Trace, comp, __VA_ARGS__)
+#define TS_LOG_DEBUG(comp, ...) TS_LOG(Debug, comp, __VA_ARGS__)
+#define TS_LOG_INFO(comp, ...) TS_LOG(Info, comp, __VA_ARGS__)
+#define TS_LOG_WARN(comp, ...) TS_LOG(Warn, comp, __VA_ARGS__)
+#define TS_LOG_ERROR(comp, ...) TS_LOG(Error, comp, __VA_ARGS__)
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace ts {
+
+// 只读内存映射文件（POSIX mmap / Windows MapViewOfFile），不可拷贝，可移动
+class MappedFile {
+ public:
+  MappedFile() = default;
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& o) noexcept;
+  MappedFile& operator=(MappedFile&& o) noexcept;
+
+  bool open(const std::string& path);
+  void close();
+  bool is_open() const { return opened_; }
+  const char* data() const { return static_cast<const char*>(data_); }
+  size_t size() const { return size_; }
+
+ private:
+  void* data_{nullptr};
+  size_t size_{0};
+  bool opened_{false};
+#ifdef _WIN32
+  void* file_{nullptr};
+  void* mapping_{nullptr};
+#endif
+};
+
+// 可写内存映射文件：新建（覆盖）或保留原内容打开后按需扩展文件长度并整体映射，供追加写；close时截断到实际长度。
+// 扩展会重新映射，data()地址随之改变
+class WritableMappedFile {
+ public:
+  WritableMappedFile() = default;
+  ~WritableMappedFile();
+  WritableMappedFile(const WritableMappedFile&) = delete;
+  WritableMappedFile& operator=(const WritableMappedFile&) = delete;
+
+  // keep为true时保留已有内容，映射长度取initial_size与原文件长度中的较大者
+  bool open(const std::string& path, size_t initial_size, bool keep = false);
+  // 映射长度不足size时扩展（至少翻倍）
+  bool reserve(size_t size);
+  bool close(size_t final_size);
+  bool is_open() const { return data_ != nullptr; }
+  char* data() const { return static_cast<char*>(data_); }
+  size_t capacity() const { return size_; }
+
+ private:
+  bool map(size_t size);
+  void unmap();
+  void* data_{nullptr};
+  size_t size_{0};
+#ifdef _WIN32
+  void* file_{nullptr};
+  void* mapping_{nullptr};
+#else
+  int fd_{-1};
+#endif
+};
+
+} // namespace ts
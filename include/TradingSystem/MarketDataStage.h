@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TradingSystem/Event.h"
+#include "TradingSystem/ThreadManager.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ts {
+
+// 行情与策略之间的可选缓冲级：行情线程只写入，引擎线程批量取出再回调策略。
+//  conflate：每合约仅保留最新一笔（槽位+脏位图），未消费的旧行情被覆盖
+//  drop    ：每合约一个槽位，上一笔未消费时丢弃新行情
+//  queue   ：有界SPSC队列逐笔保序，满时行情线程等待（反压）
+enum class MdPolicy { Direct, Conflate, Queue, Drop };
+
+bool parse_md_policy(const std::string& s, MdPolicy* out);
+const char* md_policy_name(MdPolicy p);
+
+class MarketDataStage {
+ public:
+  // max_instruments为槽位数；queue_capacity向上取2的幂
+  MarketDataStage(MdPolicy policy, size_t max_instruments, size_t queue_capacity);
+  ~MarketDataStage();
+  MarketDataStage(const MarketDataStage&) = delete;
+  MarketDataStage& operator=(const MarketDataStage&) = delete;
+
+  MdPolicy policy() const { return policy_; }
+  // 行情线程调用（单生产者）
+  void publish(const MarketDataEvent& ev);
+  // 引擎线程调用（单消费者）：取出当前全部待处理行情并逐笔回调，返回条数
+  template <class F>
+  size_t drain(F&& handler);
+  // 停止接收：之后publish直接丢弃，反压中的生产者立即返回
+  void close() { closed_.store(true, std::memory_order_release); }
+
+  uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+  uint64_t delivered() const { return delivered_; }
+  uint64_t conflated() const { return conflated_.load(std::memory_order_relaxed); }
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+    bool pending{false};
+    MarketDataEvent ev;
+  };
+  struct Cell {
+    MarketDataEvent ev;
+  };
+
+  static void lock(Slot& s) {
+    unsigned spins = 0;
+    while (s.lock.test_and_set(std::memory_order_acquire)) idle_wait(WaitStrategy::Spin, spins);
+  }
+  static void unlock(Slot& s) { s.lock.clear(std::memory_order_release); }
+  static size_t lowest_bit(uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward64(&idx, v);
+    return idx;
+#else
+    return static_cast<size_t>(__builtin_ctzll(v));
+#endif
+  }
+  int slot_of(const std::string& instrument);
+  bool take(size_t id, MarketDataEvent* out);
+
+  MdPolicy policy_;
+  // 槽位模式（conflate/drop）
+  std::unique_ptr<Slot[]> slots_;
+  std::unique_ptr<std::atomic<uint64_t>[]> dirty_;
+  size_t nslots_{0};
+  size_t nwords_{0};
+  std::unordered_map<std::string, int> ids_;  // 仅行情线程访问
+  // 队列模式
+  HugePageBuffer ring_;
+  Cell* cells_{nullptr};
+  size_t mask_{0};
+  alignas(64) std::atomic<uint64_t> head_{0};  // 消费位置
+  alignas(64) std::atomic<uint64_t> tail_{0};  // 生产位置
+
+  std::atomic<bool> closed_{false};
+  std::atomic<uint64_t> published_{0};
+  std::atomic<uint64_t> conflated_{0};
+  std::atomic<uint64_t> dropped_{0};
+  uint64_t delivered_{0};
+  MarketDataEvent scratch_;  // 消费侧复用，避免逐笔分配
+  bool warned_full_{false};
+};
+
+template <class F>
+size_t MarketDataStage::drain(F&& handler) {
+  size_t n = 0;
+  if (policy_ == MdPolicy::Queue) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    const uint64_t tail = tail_.load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+      handler(cells_[head & mask_].ev);
+      // 每笔回调后即释放槽位，缩短生产者反压等待
+      head_.store(head + 1, std::memory_order_release);
+      ++n;
+    }
+  } else {
+    for (size_t w = 0; w < nwords_; ++w) {
+      uint64_t bits = dirty_[w].exchange(0, std::memory_order_acquire);
+      while (bits) {
+        size_t b = lowest_bit(bits);
+        bits &= bits - 1;
+        if (take(w * 64 + b, &scratch_)) {
+          handler(static_cast<const MarketDataEvent&>(scratch_));
+          ++n;
+        }
+      }
+    }
+  }
+  delivered_ += n;
+  return n;
+}
+
+} // namespace ts
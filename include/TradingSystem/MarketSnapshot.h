@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TradingSystem/Event.h"
+
+namespace ts {
+
+// 全市场行情快照：引擎在派发线程上逐笔原处更新，按合约序号索引的列式数组（SoA），
+// 跨合约策略可直接对整列做向量化扫描（如 for i<size(): mid[i]=(bid[i]+ask[i])*0.5），无需自建报价表。
+// 合约序号在首次出现（或预登记）时分配，之后不变；新合约登记可能使数组重新分配，列指针须在每次扫描时重新获取。
+// 脏列表为当前派发步骤中更新过的合约；跨多笔追踪变化时比较update_seq与上次扫描时的seq()。
+class MarketSnapshot {
+ public:
+  explicit MarketSnapshot(size_t reserve = 1024);
+
+  // 预登记合约，已存在时返回原序号
+  int add(const std::string& instrument);
+  // 未登记返回-1
+  int find(const std::string& instrument) const;
+  // 更新一笔行情，返回合约序号。ev_ms为引擎已解析的事件时间
+  int update(const MarketDataEvent& ev, int64_t ev_ms);
+  // 引擎在每笔行情派发完毕后清空脏列表
+  void clear_dirty();
+
+  size_t size() const { return names_.size(); }
+  const std::string& instrument(int id) const { return names_[static_cast<size_t>(id)]; }
+  // 全局更新序号：每次update加一
+  uint64_t seq() const { return seq_; }
+
+  // 列数组，长度为size()；尚无行情的合约各列为0
+  const double* bid() const { return bid_.data(); }
+  const double* ask() const { return ask_.data(); }
+  const double* last() const { return last_.data(); }
+  const int32_t* bid_volume() const { return bid_vol_.data(); }
+  const int32_t* ask_volume() const { return ask_vol_.data(); }
+  const int32_t* volume() const { return volume_.data(); }         // 最近一笔的成交量
+  const double* volume_sum() const { return volume_sum_.data(); }  // 启动以来累计成交量
+  const int64_t* ts_ms() const { return ts_ms_.data(); }
+  const uint64_t* update_seq() const { return update_seq_.data(); }  // 该合约最近一次更新时的seq()
+
+  const std::vector<int32_t>& dirty() const { return dirty_; }
+
+ private:
+  std::unordered_map<std::string, int> ids_;
+  std::vector<std::string> names_;
+  std::vector<double> bid_, ask_, last_, volume_sum_;
+  std::vector<int32_t> bid_vol_, ask_vol_, volume_;
+  std::vector<int64_t> ts_ms_;
+  std::vector<uint64_t> update_seq_;
+  std::vector<int32_t> dirty_;
+  std::vector<unsigned char> dirty_flag_;
+  uint64_t seq_{0};
+  // 同一合约连续到达时免去哈希查找
+  int last_id_{-1};
+};
+
+} // namespace ts
@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace ts {
+
+// 指标导出线程：在127.0.0.1:port上以Prometheus文本格式响应任意GET，
+// 并按周期把同样内容写入快照文件（临时文件改名，读者不会读到半成品）。
+// port为0不开端口；snapshot_sec为0或路径为空不写快照。
+class MetricsExporter {
+ public:
+  MetricsExporter(int port, int snapshot_sec, std::string snapshot_path);
+  ~MetricsExporter();
+  MetricsExporter(const MetricsExporter&) = delete;
+  MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+  bool start();
+  // 停止前写出最后一份快照
+  void stop();
+  int port() const { return port_; }
+
+ private:
+  void run();
+  void write_snapshot();
+  bool open_listener();
+  void serve_one();
+
+  int port_;
+  int snapshot_sec_;
+  std::string snapshot_path_;
+  long long listen_fd_{-1};  // POSIX fd / Windows SOCKET
+  std::atomic<bool> running_{false};
+  std::thread worker_;
+};
+
+} // namespace ts
@@ -0,0 +1,138 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ts {
+
+// 运行期指标：计数器与直方图写入当前线程独占的分片（按缓存行对齐的单元数组），
+// 热路径仅为一次TLS读取加一次无锁加法；只有抓取（render）时才跨线程汇总。
+// 仪表（gauge）为全局单元（各占一个缓存行），或在抓取时求值的回调。
+namespace metrics_detail {
+constexpr size_t kCellsPerShard = 2048;
+using Cell = std::atomic<uint64_t>;
+std::atomic<uint64_t>* acquire_shard();
+inline thread_local Cell* tls_cells = nullptr;
+inline Cell* local_cells() {
+  Cell* c = tls_cells;
+  if (c) return c;
+  return acquire_shard();
+}
+// 仪表单元：各占一个缓存行，避免不同写者线程间伪共享
+constexpr size_t kMaxGauges = 256;
+struct alignas(64) GaugeCell {
+  std::atomic<double> v{0.0};
+};
+inline GaugeCell g_gauges[kMaxGauges];
+// 单写者：relaxed读改写编译为普通加法，不带lock前缀
+inline void bump(uint32_t id, uint64_t n) {
+  Cell& c = local_cells()[id];
+  c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+} // namespace metrics_detail
+
+class Counter {
+ public:
+  Counter() = default;
+  void inc(uint64_t n = 1) const { metrics_detail::bump(id_, n); }
+ private:
+  friend class MetricsRegistry;
+  explicit Counter(uint32_t id) : id_(id) {}
+  uint32_t id_{0};  // 0为丢弃单元（未注册或容量耗尽）
+};
+
+class Gauge {
+ public:
+  Gauge() = default;
+  void set(double v) const { metrics_detail::g_gauges[id_].v.store(v, std::memory_order_relaxed); }
+ private:
+  friend class MetricsRegistry;
+  explicit Gauge(uint32_t id) : id_(id) {}
+  uint32_t id_{0};  // 0为丢弃单元
+};
+
+// 直方图：以2为底的对数桶，上界为 1,2,4,...,2^(kHistBuckets-2)，最后一桶为+Inf；观测值为非负整数
+class Histogram {
+ public:
+  static constexpr uint32_t kHistBuckets = 32;
+  Histogram() = default;
+  void observe(uint64_t v) const {
+    if (!base_) return;
+    uint32_t b = v <= 1 ? 0 : 64 - clz64(v - 1);
+    if (b > kHistBuckets - 1) b = kHistBuckets - 1;
+    metrics_detail::bump(base_ + b, 1);
+    metrics_detail::bump(base_ + kHistBuckets, v);
+  }
+ private:
+  friend class MetricsRegistry;
+  explicit Histogram(uint32_t base) : base_(base) {}
+  static uint32_t clz64(uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanReverse64(&idx, v);
+    return 63 - idx;
+#else
+    return static_cast<uint32_t>(__builtin_clzll(v));
+#endif
+  }
+  uint32_t base_{0};  // 桶计数占kHistBuckets个单元，其后一个单元为累加和
+};
+
+class MetricsRegistry {
+ public:
+  static MetricsRegistry& instance();
+
+  // 名称按Prometheus规范（如 ts_ticks_total）；labels为 key="value" 列表，如 reason="Order interval too short"。
+  // 同名同标签重复注册返回同一句柄；注册走锁，不应放在热路径
+  Counter counter(const std::string& name, const std::string& help, const std::string& labels = "");
+  Gauge gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+  // 抓取时在抓取线程持注册锁求值；fn须线程安全且不得再调用注册接口
+  void gauge_fn(const std::string& name, const std::string& help, std::function<double()> fn,
+                const std::string& labels = "");
+  // 回调捕获的对象析构前须移除
+  void remove_gauge_fn(const std::string& name, const std::string& labels = "");
+  // scale：导出时观测值除以该系数（如纳秒记录、以秒导出时为1e9）
+  Histogram histogram(const std::string& name, const std::string& help, double scale = 1.0,
+                      const std::string& labels = "");
+
+  // 生成单个标签 key="value"（转义反斜杠、引号与换行）
+  static std::string label(const std::string& key, const std::string& value);
+
+  // Prometheus文本格式（0.0.4）
+  std::string render_prometheus();
+
+  // 实现细节：线程分片
+  struct Shard;
+  std::atomic<uint64_t>* acquire_shard_cells();
+  void release_shard(Shard* s);
+
+ private:
+  MetricsRegistry();
+  enum class Kind { Counter, Gauge, GaugeFn, Histogram };
+  struct Entry {
+    std::string name;
+    std::string help;
+    std::string labels;
+    Kind kind;
+    uint32_t id;  // 计数器单元 / 仪表序号 / 直方图首单元
+    double scale{1.0};
+    std::function<double()> fn;
+  };
+  const Entry* find(const std::string& name, const std::string& labels, Kind kind) const;
+  uint64_t sum_cell(uint32_t id) const;
+
+  std::mutex mu_;
+  std::vector<Entry> entries_;
+  uint32_t next_cell_{1};
+  uint32_t next_gauge_{1};
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace ts
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ts {
+
+struct PerfMetricsConfig {
+  double initial_capital{1000000.0};
+  int sample_sec{60};                // 权益采样周期（事件时间），用于Sharpe
+  std::vector<std::string> metrics;  // 输出指标（config.json: report_metrics），空表示全部
+  std::vector<std::string> formats;  // 输出格式（config.json: report_fmt）：CSV / HTML
+};
+
+// 单遍流式绩效统计：随成交与估值增量更新，不保存权益曲线。
+// 回撤按运行峰值计算，Sharpe基于采样收益的Welford均值/方差。
+class PerfMetrics {
+ public:
+  explicit PerfMetrics(PerfMetricsConfig cfg);
+  // 成交后调用：open_qty为该合约成交后的多空总持仓，realized为该合约累计已实现盈亏
+  void on_fill(const std::string& instrument, int64_t ts_ms, int open_qty, double realized);
+  // 估值：inst_pnl为该合约已实现+未实现盈亏
+  void on_mark(const std::string& instrument, int64_t ts_ms, double inst_pnl);
+  // 指标值（total_ret/ann_ret/win_rate/pls_ratio/max_dd/dd_duration/sharpe/calmar/trade_count/avg_hold_secs）
+  double value(const std::string& metric) const;
+  const std::vector<std::string>& metric_names() const { return names_; }
+  // 按report_fmt输出 metrics.csv / report.html
+  void write_report(const std::string& dir) const;
+
+ private:
+  struct InstState {
+    double pnl{0.0};
+    double realized{0.0};  // 上次平仓时的累计已实现盈亏
+    int open_qty{0};
+    double entry_ts_qty{0.0};  // Σ(持仓数量×开仓时间)，用于持仓时长
+  };
+  void observe(int64_t ts_ms);
+  double rel_sec(int64_t ts_ms) const { return static_cast<double>(ts_ms - first_ts_) / 1000.0; }
+
+  PerfMetricsConfig cfg_;
+  std::vector<std::string> names_;
+  std::unordered_map<std::string, InstState> inst_;
+  // 时间
+  int64_t first_ts_{-1};
+  int64_t last_ts_{-1};
+  // 权益与回撤
+  double total_pnl_{0.0};
+  double peak_{0.0};
+  int64_t peak_ts_{-1};
+  double max_dd_{0.0};
+  double max_dd_secs_{0.0};
+  // 采样收益（Welford）
+  int64_t next_sample_ts_{-1};
+  double last_sample_equity_{0.0};
+  int64_t n_samples_{0};
+  double mean_{0.0};
+  double m2_{0.0};
+  // 成交统计
+  int64_t fills_{0};
+  int64_t wins_{0};
+  int64_t losses_{0};
+  double win_sum_{0.0};
+  double loss_sum_{0.0};
+  double hold_qty_secs_{0.0};
+  int64_t closed_qty_{0};
+};
+
+} // namespace ts
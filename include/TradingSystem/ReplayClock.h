@@ -0,0 +1,28 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+namespace ts {
+
+// 按事件时间回放的节拍器：墙钟间隔 = 事件间隔 / speed，单个间隔不超过max_gap_ms（跳过休市、隔夜等空档）。
+// 等待先休眠到目标前spin_us微秒，再忙等到目标时刻，以获得亚毫秒精度
+class ReplayClock {
+ public:
+  explicit ReplayClock(double speed = 1.0, int64_t max_gap_ms = 5000, int spin_us = 200);
+  // 等到事件时间event_ms对应的墙钟时刻；首个事件立即返回并作为锚点，乱序或无效时间不等待
+  void wait_until_event(int64_t event_ms);
+  void reset() { anchored_ = false; }
+  double speed() const { return speed_; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  double speed_;
+  int64_t max_gap_ms_;
+  std::chrono::microseconds spin_;
+  bool anchored_{false};
+  Clock::time_point anchor_wall_;
+  int64_t last_event_ms_{0};
+  double elapsed_us_{0.0};  // 自锚点以来（已夹紧、已缩放）的累计回放时长
+};
+
+} // namespace ts
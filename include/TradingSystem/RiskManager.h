@@ -3,8 +3,13 @@
 #include <unordered_map>
 #include <chrono>
 #include "Event.h"
+#include "InstrumentMeta.h"
+#include "MetricsRegistry.h"
 
 namespace ts {
+class SessionCalendar;
+class LiveConfig;
+
 struct RiskConfig {
   int max_pos_per_instrument{1};
   int max_orders_per_bar{1};
@@ -18,6 +23,12 @@ class RiskManager {
   void on_order_placed(const std::string& instrument);
   void on_new_bar(const std::string& instrument);
   void register_order(const std::string& order_id, const OrderRequest& req);
+  // 改单的增量检查：只校验在途订单、改后数量与交易时段，不计入每Bar限单与下单间隔
+  bool can_modify(const std::string& order_id, double new_price, int new_qty, std::string* reject_reason);
+  // 在途订单的原始请求；未知或已完结返回nullptr
+  const OrderRequest* pending_request(const std::string& order_id) const;
+  // 改单成功后更新在途订单（调用内已完结的不再登记）；渠道以撤单+新单实现时new_id与order_id不同，新单另行登记
+  void on_order_modified(const std::string& order_id, const std::string& new_id, const OrderRequest& req);
   void on_order_status(const OrderStatusEvent& ev);
   // 新增：接收行情以追踪最新价
   void on_market_data(const MarketDataEvent& ev);
@@ -26,13 +37,36 @@ class RiskManager {
   // 新增：持仓明细接口（返回每合约的多空持仓）
   struct PositionDetail { int long_qty{0}; int short_qty{0}; };
   const std::unordered_map<std::string, PositionDetail>& positions_detail() const;
-  // 新增：基础盈亏追踪结构与接口（扩展未实现盈亏）
-  struct PnLInfo { int long_open_qty{0}; double long_open_cost_sum{0.0}; int short_open_qty{0}; double short_open_cost_sum{0.0}; double realized_pnl{0.0}; double unrealized_pnl{0.0}; };
+  // 盈亏追踪：持仓成本以整数价格单位累计，盈亏与手续费以定点金额累计（含合约乘数），
+  // 浮点字段由整数状态换算，供报表与绩效统计使用
+  struct PnLInfo {
+    int long_open_qty{0};
+    int64_t long_open_cost{0};   // Σ数量×开仓价（价格单位）
+    int short_open_qty{0};
+    int64_t short_open_cost{0};
+    int long_today_qty{0};       // 当前交易日开的仓（平今手续费）
+    int short_today_qty{0};
+    int64_t trading_day{-1};
+    int64_t realized{0};         // 已实现盈亏（定点金额，未扣手续费）
+    int64_t fees{0};             // 累计手续费（定点金额）
+    int64_t unrealized{0};
+    double realized_pnl{0.0};    // 元，已扣手续费
+    double unrealized_pnl{0.0};  // 元
+    double long_avg_cost{0.0};
+    double short_avg_cost{0.0};
+  };
   const std::unordered_map<std::string, PnLInfo>& pnl_info() const;
   // 新增：获取最新价字典
   const std::unordered_map<std::string, double>& last_prices() const;
+  // 交易时段：设置后，合约最新行情时间不在时段内时拒绝下单
+  void set_session_calendar(const SessionCalendar* calendar) { calendar_ = calendar; }
+  // 合约参数（跳价、乘数、手续费）；未设置时按乘数1、无手续费、1e-4价格单位计
+  void set_instruments(const InstrumentTable* instruments) { instruments_ = instruments; }
+  // 热更新：设置后限额取自已发布的最新快照（无锁读取），未发布时沿用构造参数
+  void set_live_config(const LiveConfig* live) { live_ = live; }
  private:
   RiskConfig cfg_;
+  const LiveConfig* live_{nullptr};
   std::unordered_map<std::string, int> pos_;
   std::unordered_map<std::string, int> orders_this_bar_;
   std::unordered_map<std::string, std::chrono::steady_clock::time_point> last_order_time_;
@@ -43,5 +77,18 @@ class RiskManager {
   std::unordered_map<std::string, PnLInfo> pnl_;
   // 新增：最新价缓存
   std::unordered_map<std::string, double> last_price_;
+  // 交易时段日历与各合约最新行情的日内秒（-1为未知）
+  const SessionCalendar* calendar_{nullptr};
+  std::unordered_map<std::string, int> last_sec_;
+  const InstrumentTable* instruments_{nullptr};
+  InstrumentMeta default_meta_;
+  int64_t trading_day_{-1};  // 最近行情所属交易日，划分今仓与昨仓
+  const InstrumentMeta& meta_of(const std::string& instrument) const {
+    return instruments_ ? instruments_->get(instrument) : default_meta_;
+  }
+  // 运行期指标：拒单按原因分序列，句柄按原因缓存
+  Counter& reject_counter(const char* reason);
+  std::unordered_map<const char*, Counter> reject_counters_;
+  Gauge pending_gauge_;
 };
 }
\ No newline at end of file
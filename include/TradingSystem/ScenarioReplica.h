@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "TradingSystem/Event.h"
+#include "TradingSystem/IBacktestMatching.h"
+#include "TradingSystem/PerfMetrics.h"
+#include "TradingSystem/RiskManager.h"
+#include "TradingSystem/StrategyHost.h"
+
+namespace ts {
+class BacktestTrader;
+class BarHistory;
+class InstrumentTable;
+class LiveConfig;
+class MarketSnapshot;
+class SessionCalendar;
+class TraderProxy;
+
+// 多场景回测中的一个场景副本：独立的撮合器、风控、策略与绩效统计，按自己的撮合规则成交。
+// 行情解析、时段过滤与Bar聚合由引擎只做一次，逐笔依次送入各副本；副本与主场景在同一派发线程上运行，
+// 单笔内的处理顺序（定时器→风控→策略→撮合→估值，Bar在本笔之后）与主场景一致，规则相同时结果逐笔相同。
+class ScenarioReplica {
+ public:
+  ScenarioReplica(std::string name, std::vector<HostedStrategy> strategies);
+  ~ScenarioReplica();
+  ScenarioReplica(const ScenarioReplica&) = delete;
+  ScenarioReplica& operator=(const ScenarioReplica&) = delete;
+
+  // 加载撮合配置并施加场景覆盖，启动策略
+  bool start(const std::string& meta_path, const std::string& rules_path, const MatchingOverrides& rules,
+             const RiskConfig& risk_cfg, const PerfMetricsConfig& pm_cfg, const SessionCalendar* calendar,
+             const InstrumentTable* instruments);
+  // ev_ms为引擎已解析的事件时间
+  void on_tick(const MarketDataEvent& ev, int64_t ev_ms);
+  void on_bar(const BarEvent& bar);
+  void stop();
+  // 启动预热（须在start之前调用）
+  size_t warm_up(BarHistory& history, const std::vector<std::string>& universe, int64_t end_ms) {
+    return host_.warm_up(history, universe, end_ms);
+  }
+  // 全市场快照由引擎维护、各场景共享（须在start之前调用）
+  void bind_snapshot(const MarketSnapshot* snapshot) { host_.bind_snapshot(snapshot); }
+  // 热更新：风控限额与策略参数改读已发布的快照（须在start之后调用）
+  void bind_live_config(const LiveConfig* live) {
+    risk_->set_live_config(live);
+    host_.bind_live_config(live);
+  }
+  // 绩效报表、成交汇总与盈亏CSV
+  void write_reports(const std::string& dir) const;
+
+  const std::string& name() const { return name_; }
+  const MatchingOverrides& rules() const { return rules_; }
+  const PerfMetrics& metrics() const { return *metrics_; }
+
+ private:
+  void on_order_status(const OrderStatusEvent& ev);
+
+  std::string name_;
+  MatchingOverrides rules_;
+  std::unique_ptr<RiskManager> risk_;
+  std::unique_ptr<PerfMetrics> metrics_;
+  std::unique_ptr<TraderProxy> trader_;
+  BacktestTrader* matcher_{nullptr};  // 归trader_所有；逐笔直接送达，免去代理的类型转换
+  StrategyHost host_;
+  int64_t last_event_ms_{-1};
+  std::unordered_map<std::string, std::pair<long, double>> stats_;
+};
+
+} // namespace ts
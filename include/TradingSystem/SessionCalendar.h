@@ -0,0 +1,45 @@
+#pragma once
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ts {
+
+constexpr int kSecPerDay = 86400;
+
+// 单个合约的交易时段：加载时编译为按日内秒的位图（O(1)判定）与时段表（Bar对齐）
+struct TradingSessions {
+  // 时段[start, end]，单位为日内秒；跨午夜的夜盘end大于kSecPerDay。
+  // 收盘秒（如15:00:00）仍计入时段，以保留收盘时刻的行情
+  struct Segment {
+    int start;
+    int end;
+  };
+  std::bitset<kSecPerDay> open;
+  std::vector<Segment> segments;
+
+  bool contains_sec(int sec_of_day) const { return open.test(static_cast<size_t>(sec_of_day)); }
+  bool contains_ms(int64_t ms) const;
+  // 返回事件时间ms所在Bar的起点：按所在时段起点对齐，Bar不跨越休市；不在时段内返回-1
+  int64_t bar_start_ms(int64_t ms, int interval_sec) const;
+};
+
+class SessionCalendar {
+ public:
+  // 编译时段串，如 "21:00-23:00,09:00-10:15,10:30-11:30,13:30-15:00"；格式错误返回false
+  bool add(const std::string& instrument, const std::string& spec);
+  // 从meta.json读取各合约的session字段，返回加载的合约数
+  size_t load_meta(const std::string& meta_path);
+  // 未配置时段的合约返回nullptr（视为全天可交易）；调用方可缓存返回的指针
+  const TradingSessions* find(const std::string& instrument) const;
+  bool empty() const { return sessions_.empty(); }
+  // 全部合约时段的摘要（与登记顺序无关），用作按时段对齐的Bar缓存键
+  uint64_t fingerprint() const;
+
+ private:
+  std::unordered_map<std::string, TradingSessions> sessions_;
+};
+
+} // namespace ts
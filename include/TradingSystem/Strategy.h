@@ -1,15 +1,79 @@
 #pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
 #include "Event.h"
 
 namespace ts {
 class ITrader;
+class LiveConfig;
+class MarketSnapshot;
+
+// 策略关心的事件类型（位掩码）
+enum StrategyEvents : uint32_t {
+  kTickEvents = 1u << 0,
+  kBarEvents = 1u << 1,
+  kOrderEvents = 1u << 2,
+  kAllEvents = kTickEvents | kBarEvents | kOrderEvents,
+};
+
+// 定时器接口：由托管层在on_start前注入，调度与取消均为O(1)。
+// 回测/合成行情下按行情事件时间触发，实盘按单调时钟触发；on_timer与行情在同一派发线程
+class ITimerService {
+ public:
+  virtual ~ITimerService() = default;
+  // delay_ms后触发一次（最小1ms）；interval_ms>0时此后按该周期重复直至取消。返回定时器ID（非0）
+  virtual uint64_t schedule_timer(int64_t delay_ms, int64_t interval_ms = 0, uint64_t user_data = 0) = 0;
+  // 已触发的单次定时器或未知ID返回false
+  virtual bool cancel_timer(uint64_t timer_id) = 0;
+  // 定时器时钟的当前毫秒（回测为最近行情的事件时间）
+  virtual int64_t timer_now_ms() const = 0;
+};
+
+// 订阅声明：instruments为空表示全部合约
+struct Subscription {
+  std::vector<std::string> instruments;
+  uint32_t events{kAllEvents};
+};
+
 class Strategy {
  public:
   virtual ~Strategy() = default;
   virtual void on_market_data(const MarketDataEvent& md, ITrader* trader) = 0;
-  // 可选：订单状态回调，默认空实现
+  // 可选：订单状态回调，默认空实现；多策略托管时只收到本策略下的订单
   virtual void on_order_status(const OrderStatusEvent& ev) {}
   // 可选：bar回调，默认空实现
   virtual void on_bar(const BarEvent& bar, ITrader* trader) {}
+  // 可选：引擎开始订阅行情前/结束运行时各调用一次
+  virtual void on_start(ITrader* trader) {}
+  virtual void on_stop(ITrader* trader) {}
+  // 可选：声明关心的合约与事件，引擎据此预建路由表；默认全部合约、全部事件
+  virtual Subscription subscription() const { return {}; }
+  // 可选：定时器到期回调，user_data为调度时传入的值
+  virtual void on_timer(uint64_t timer_id, uint64_t user_data, ITrader* trader) {}
+  // 可选：启动预热所需的历史Bar根数（bar_interval_sec周期），0为不预热
+  virtual size_t warmup_bars() const { return 0; }
+  // 可选：on_start之前按合约一次性送入最近的历史Bar（时间升序，至多warmup_bars()根），
+  // bars指向只读映射，仅在本次调用内有效；只用于初始化指标状态，不应下单
+  virtual void on_warmup(const std::string& instrument, const BarRecord* bars, size_t n) {}
+
+  // 由托管层注入定时器接口
+  void set_timer_service(ITimerService* timers) { timers_ = timers; }
+  // 由托管层注入引擎维护的全市场快照（派发线程上读取，行情回调时已含本笔）
+  void set_market_snapshot(const MarketSnapshot* snapshot) { snapshot_ = snapshot; }
+  // 由托管层在开启热更新（hot_reload=true）时注入已发布的参数快照
+  void set_live_config(const LiveConfig* live) { live_ = live; }
+
+ protected:
+  ITimerService* timers() const { return timers_; }
+  // 未注入时为nullptr
+  const MarketSnapshot* snapshot() const { return snapshot_; }
+  // 未开启热更新时为nullptr，策略沿用构造时的参数
+  const LiveConfig* live_config() const { return live_; }
+
+ private:
+  ITimerService* timers_{nullptr};
+  const MarketSnapshot* snapshot_{nullptr};
+  const LiveConfig* live_{nullptr};
 };
-}
\ No newline at end of file
+}
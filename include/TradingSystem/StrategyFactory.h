@@ -0,0 +1,24 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TradingSystem/Engine.h"
+#include "TradingSystem/Strategy.h"
+#include "TradingSystem/StrategyHost.h"
+
+namespace ts {
+// 策略工厂：各策略在实现文件中静态注册，按名称或配置创建
+class StrategyFactory {
+ public:
+  using Creator = std::function<std::unique_ptr<Strategy>(const AppConfig&)>;
+  static bool register_strategy(const std::string& name, Creator creator);
+  // 未注册返回nullptr
+  static std::unique_ptr<Strategy> create(const std::string& name, const AppConfig& cfg);
+  // 按strategy_type选择：python_embed -> PythonStrategy，其余按builtin_class创建
+  static std::unique_ptr<Strategy> create_from_config(const AppConfig& cfg);
+  // 多策略：按strategies列表逐项创建（类名[@合约|合约]）；为空时退回create_from_config。任一项失败返回false
+  static bool create_hosted(const AppConfig& cfg, std::vector<HostedStrategy>* out);
+  static std::vector<std::string> registered();
+};
+} // namespace ts
@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TradingSystem/ITrader.h"
+#include "TradingSystem/Strategy.h"
+#include "TradingSystem/TimerWheel.h"
+
+namespace ts {
+class BarHistory;
+
+// 托管的单个策略：订阅取自策略声明，可被配置覆盖合约列表
+struct HostedStrategy {
+  std::string name;
+  std::unique_ptr<Strategy> strategy;
+  Subscription sub;
+};
+
+// 多策略托管：启动时按订阅预建 合约->策略列表 路由表，行情/Bar只送达关心的策略；
+// 每个策略持有独立的ITrader门面，下单返回的order_id记录归属，订单事件据此回送原策略。
+// 定时器：各策略经各自的ITimerService门面调度到同一时间轮，引擎在派发线程按时钟推进并回调on_timer。
+class StrategyHost {
+ public:
+  explicit StrategyHost(std::vector<HostedStrategy> strategies);
+  ~StrategyHost();
+  StrategyHost(const StrategyHost&) = delete;
+  StrategyHost& operator=(const StrategyHost&) = delete;
+
+  // 绑定底层交易接口（风控代理），须在on_start之前调用
+  void bind_trader(ITrader* trader) { trader_ = trader; }
+  // 向所有策略注入全市场快照，须在on_start之前调用
+  void bind_snapshot(const MarketSnapshot* snapshot);
+  // 热更新：向所有策略注入已发布的参数快照
+  void bind_live_config(const LiveConfig* live);
+  // 需向行情源订阅的合约：base为空（全部）或有策略订阅全部合约时返回空
+  std::vector<std::string> subscribe_list(const std::vector<std::string>& base) const;
+
+  // 启动预热：按各策略的warmup_bars()从历史库取最近的Bar一次性送入，须在on_start之前调用。
+  // 订阅全部合约的策略以universe为准，universe为空时取历史库中已有的合约；只取end_ms之前已结束的Bar。返回送出的Bar总数
+  size_t warm_up(BarHistory& history, const std::vector<std::string>& universe, int64_t end_ms = INT64_MAX);
+  void on_start();
+  void on_stop();
+  // 行情与Bar须在同一派发线程调用
+  void on_market_data(const MarketDataEvent& ev);
+  void on_bar(const BarEvent& bar);
+  // 可在交易回调线程调用
+  void on_order_status(const OrderStatusEvent& ev);
+  // 推进定时器时钟并回调到期的on_timer，须在行情派发线程调用；首次调用以now_ms为时钟起点，
+  // 此前（如on_start中）调度的定时器随之平移
+  void advance_timers(int64_t now_ms);
+  size_t pending_timers();
+
+  size_t size() const { return slots_.size(); }
+
+ private:
+  class StrategyTrader;
+  class StrategyTimers;
+  struct Slot;
+  struct Route {
+    std::vector<uint32_t> ticks;
+    std::vector<uint32_t> bars;
+  };
+
+  const Route& route(const std::string& instrument);
+  std::string place_for(uint32_t idx, const OrderRequest& req);
+  std::string modify_for(uint32_t idx, const std::string& order_id, double new_price, int new_qty);
+  bool wants_orders(uint32_t idx, const std::string& instrument) const;
+
+  std::vector<std::unique_ptr<Slot>> slots_;
+  ITrader* trader_{nullptr};
+  // 路由表：仅派发线程读写；未声明的合约首次出现时按“订阅全部”的策略补建
+  std::unordered_map<std::string, Route> routes_;
+  Route wildcard_;
+  const std::string* last_inst_{nullptr};
+  const Route* last_route_{nullptr};
+  // 订单归属：order_id -> 策略序号。下单期间持锁，同步回调按正在下单的策略归属
+  std::recursive_mutex order_mu_;
+  std::unordered_map<std::string, uint32_t> owner_;
+  int placing_{-1};
+  std::string placing_done_id_;  // 下单期间已终结的订单，返回后不再登记
+  // 定时器：调度可来自交易回调线程，时间轮操作持锁；回调on_timer时不持锁，回调内可再调度或取消
+  std::mutex timer_mu_;
+  TimerWheel wheel_;
+  bool clock_set_{false};
+  std::atomic<int64_t> timer_now_{0};  // 时钟镜像，同一毫秒内的后续行情免锁跳过
+};
+
+} // namespace ts
@@ -0,0 +1,97 @@
+#pragma once
+#include "TradingSystem/IMarketData.h"
+#include "TradingSystem/ReplayClock.h"
+#include "TradingSystem/TickStore.h"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ts {
+
+// 合成行情参数；默认值面向压测（高到达率、固定种子）
+struct SyntheticConfig {
+  int instruments{100};          // 合约数；订阅列表非空时以订阅列表为准
+  std::string model{"gbm"};      // gbm（几何布朗运动）/ ou（对数价格均值回归）
+  double rate{100000.0};         // 事件时间下全市场平均到达率（笔/秒）
+  double burst_factor{20.0};     // 爆发态到达率倍数
+  double burst_prob{0.0005};     // 平静态每笔转入爆发态的概率
+  double burst_len{2000.0};      // 爆发态平均持续笔数
+  double zipf{1.0};              // 合约活跃度的Zipf指数（0为均匀）
+  double vol{0.25};              // 年化波动率（按每年252个交易日、每日4小时折算）
+  double mean_revert{5.0};       // ou模型回归速度（每日）
+  double price{4000.0};          // 初始价格中枢，各合约在其附近随机分布
+  double tick_size{0.2};
+  uint64_t seed{42};
+  uint64_t events{0};            // 总笔数（0为不限，直至停止）
+  int64_t start_ms{0};           // 事件时间起点；0取2024-01-02 09:00:00
+};
+
+// 合成Tick生成器：马尔可夫切换的泊松到达（平静/爆发两态），按合约推进GBM/OU价格路径，
+// 以最小变动价位挂出买卖价，价差与盘口量随爆发态变宽变薄。同种子同参数输出逐笔一致。
+class SyntheticTickGenerator {
+ public:
+  SyntheticTickGenerator(const SyntheticConfig& cfg, std::vector<std::string> instruments);
+  void next(TickRecord* out);
+  const std::vector<std::string>& instruments() const { return names_; }
+  static std::vector<std::string> default_names(int n);
+
+ private:
+  struct Inst {
+    double x;       // 对数价格
+    double x0;      // ou回归中枢
+    double last_ms; // 上一笔事件时间
+  };
+  uint64_t next_u64();
+  double uniform();   // (0,1)
+  double normal();
+  double expo() { return -std::log(uniform()); }
+  uint32_t pick_instrument();
+
+  SyntheticConfig cfg_;
+  std::vector<std::string> names_;
+  std::vector<Inst> inst_;
+  std::vector<double> cum_;  // Zipf累计权重，均匀时为空
+  uint64_t s_[4];
+  bool has_spare_{false};
+  double spare_{0.0};
+  double t_ms_{0.0};
+  bool burst_{false};
+  uint32_t hot_{0};
+  bool ou_{false};
+  double ou_kappa_{0.0};     // 每毫秒
+  double var_per_ms_{0.0};   // 方差/毫秒
+};
+
+// 合成行情源：生成器运行在行情线程，可选按事件时间节拍，并可同时写出二进制Tick库
+class SyntheticMarketData : public IMarketData {
+ public:
+  explicit SyntheticMarketData(SyntheticConfig cfg);
+  ~SyntheticMarketData() override;
+  bool connect(const std::string& front) override;
+  bool login(const std::string& broker_id, const std::string& user_id, const std::string& password) override;
+  bool subscribe(const std::vector<std::string>& instruments) override;
+  void set_market_data_handler(MarketDataHandler handler) override;
+  bool finished() const override { return done_.load(std::memory_order_acquire); }
+  int64_t replay_start_ms() override;  // 生成器的事件时间起点
+  void stop() override;
+  // 默认不限速
+  void set_replay_clock(double speed, int64_t max_gap_ms);
+  // 生成的每笔行情同时写入Tick库
+  void set_store_path(std::string path) { store_path_ = std::move(path); }
+ private:
+  void run_loop();
+  SyntheticConfig cfg_;
+  std::unique_ptr<SyntheticTickGenerator> gen_;
+  std::unique_ptr<ReplayClock> clock_;
+  std::string store_path_;
+  MarketDataHandler handler_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> done_{false};
+  std::thread worker_;
+};
+
+} // namespace ts
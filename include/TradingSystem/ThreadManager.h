@@ -0,0 +1,88 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <thread>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace ts {
+
+// 引擎内的线程角色：feed为行情源线程（回放/stub/CTP回调），engine为引擎主线程，logger为异步日志线程
+enum class ThreadRole { Feed, Engine, Logger, Count };
+
+// 队列空闲时的等待方式：block为短暂休眠（默认，省CPU），yield让出时间片，spin忙等（需独占核心）
+enum class WaitStrategy { Block, Yield, Spin };
+
+bool parse_wait_strategy(const std::string& s, WaitStrategy* out);
+
+struct ThreadConfig {
+  int cpu[static_cast<int>(ThreadRole::Count)] = {-1, -1, -1}; // 绑定的CPU编号，-1不绑定
+  WaitStrategy wait[static_cast<int>(ThreadRole::Count)] = {WaitStrategy::Block, WaitStrategy::Block, WaitStrategy::Block};
+  bool huge_pages{false};  // 热点环形缓冲与对象池优先使用大页
+};
+
+// 线程拓扑：各线程启动时按角色自行绑核与命名；需在首条异步日志之前configure
+class ThreadManager {
+ public:
+  static ThreadManager& instance();
+  void configure(const ThreadConfig& cfg);
+  const ThreadConfig& config() const { return cfg_; }
+  WaitStrategy wait_strategy(ThreadRole role) const { return cfg_.wait[static_cast<int>(role)]; }
+  bool huge_pages() const { return cfg_.huge_pages; }
+  // 将调用线程绑定到角色对应的CPU并设置线程名；未配置CPU时只命名
+  void enter(ThreadRole role);
+  // 调用线程最近一次enter的角色名（如ts-engine），未进入任何角色时为nullptr
+  static const char* thread_name();
+
+ private:
+  ThreadConfig cfg_;
+};
+
+// 空闲等待：连续空转次数由调用方维护，取到数据后清零
+inline void idle_wait(WaitStrategy ws, unsigned& idle_rounds) {
+  ++idle_rounds;
+  switch (ws) {
+    case WaitStrategy::Spin:
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+      _mm_pause();
+#endif
+      break;
+    case WaitStrategy::Yield:
+      std::this_thread::yield();
+      break;
+    case WaitStrategy::Block:
+      // 先短暂让出，持续空闲后再休眠，兼顾突发到达的时延
+      if (idle_rounds < 64) std::this_thread::yield();
+      else std::this_thread::sleep_for(std::chrono::microseconds(500));
+      break;
+  }
+}
+
+// 大页内存：优先MAP_HUGETLB（Windows为MEM_LARGE_PAGES），失败时退回普通页并建议透明大页。
+// 内容清零；移动语义，析构时释放
+class HugePageBuffer {
+ public:
+  HugePageBuffer() = default;
+  HugePageBuffer(size_t bytes, bool want_huge) { allocate(bytes, want_huge); }
+  ~HugePageBuffer() { release(); }
+  HugePageBuffer(const HugePageBuffer&) = delete;
+  HugePageBuffer& operator=(const HugePageBuffer&) = delete;
+  HugePageBuffer(HugePageBuffer&& o) noexcept;
+  HugePageBuffer& operator=(HugePageBuffer&& o) noexcept;
+
+  bool allocate(size_t bytes, bool want_huge);
+  void release();
+  void* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool huge() const { return huge_; }
+
+ private:
+  void* data_{nullptr};
+  size_t size_{0};
+  size_t mapped_{0};
+  bool huge_{false};
+};
+
+} // namespace ts
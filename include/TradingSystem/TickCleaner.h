@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace ts {
+
+// 逐Tick数据清洗：mmap源文件按行边界切块并行解析校验，分块内按时间稳定排序后有序归并，
+// 再顺序去重，输出规范化CSV（格式2）与异常报告
+enum class TickAnomaly : uint8_t {
+  Malformed,     // 列数不足、数值非法或成交量为负：丢弃
+  NoTimestamp,   // 无可解析的时间戳：丢弃
+  BadPrice,      // 最新价为0、负数或非有限值：丢弃
+  Crossed,       // 买价高于卖价：丢弃
+  MissingQuote,  // 缺买价或卖价：以最新价补齐（零价差），保留
+  Duplicate,     // 与该合约上一笔完全相同：丢弃
+  OutOfOrder,    // 时间早于同合约文件中更靠前的行：按时间重排后保留（sort_by_time=false时丢弃）
+  Count
+};
+
+const char* tick_anomaly_name(TickAnomaly a);
+
+struct TickCleanOptions {
+  unsigned threads{0};        // 0为硬件线程数
+  bool drop_duplicates{true};
+  bool sort_by_time{true};
+};
+
+struct TickCleanReport {
+  uint64_t lines{0};  // 数据行数（不含表头与空行）
+  uint64_t kept{0};
+  uint64_t counts[static_cast<int>(TickAnomaly::Count)] = {};
+  unsigned threads{0};
+  double elapsed_ms{0.0};
+  uint64_t count(TickAnomaly a) const { return counts[static_cast<int>(a)]; }
+};
+
+// anomaly_csv为空时不写异常明细
+bool clean_tick_file(const std::string& src, const std::string& out_csv, const std::string& anomaly_csv,
+                     const TickCleanOptions& opts, TickCleanReport* report = nullptr, std::string* err = nullptr);
+
+// 回测前置清洗：结果写入<clean_dir>/<源文件名>.<键>.clean.csv，键取源文件绝对路径+大小+修改时间的哈希，命中即复用
+bool ensure_clean_ticks(const std::string& clean_dir, const std::string& src, std::string* out_path,
+                        std::string* err = nullptr);
+
+} // namespace ts
@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "TradingSystem/Event.h"
+#include "TradingSystem/MetricsRegistry.h"
+#include "TradingSystem/ThreadManager.h"
+#include "TradingSystem/TickStore.h"
+
+namespace ts {
+
+// 行情录制：把进入引擎的每笔行情规范化为TickRecord，经SPSC环形缓冲交给后台线程写入Tick段文件
+// （<dir>/<交易日>.ticks，与二进制Tick库同格式，可直接作为backtest_file回放）。
+// 行情线程只做一次合约查表与入队，缓冲满时丢弃并计数，从不等待；段文件按交易日轮换。
+class TickRecorder {
+ public:
+  // max_instruments为段文件合约表容量；queue_capacity向上取2的幂
+  TickRecorder(std::string dir, size_t max_instruments, size_t queue_capacity);
+  ~TickRecorder();
+  TickRecorder(const TickRecorder&) = delete;
+  TickRecorder& operator=(const TickRecorder&) = delete;
+
+  bool start();
+  // 行情线程调用（单生产者）
+  void record(const MarketDataEvent& ev);
+  // 停止接收，写完缓冲中剩余行情并关闭当前段
+  void stop();
+
+  uint64_t recorded() const { return written_total_.load(std::memory_order_relaxed); }
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  void run_loop();
+  void rotate(int64_t day);
+
+  std::string dir_;
+  size_t max_instruments_;
+  // 合约表：行情线程登记，名字先于引用它的记录发布（入队的release保证可见）
+  std::unordered_map<std::string, int32_t> ids_;  // 仅行情线程访问
+  std::vector<std::array<char, 32>> names_;
+  std::atomic<bool> warned_full_{false};
+
+  HugePageBuffer ring_;
+  TickRecord* cells_{nullptr};
+  size_t mask_{0};
+  alignas(64) std::atomic<uint64_t> head_{0};  // 写盘位置
+  alignas(64) std::atomic<uint64_t> tail_{0};  // 入队位置
+  std::atomic<uint64_t> dropped_{0};
+
+  std::atomic<bool> closed_{false};
+  std::atomic<bool> running_{false};
+  std::thread worker_;
+  // 以下仅后台线程访问
+  TickSegmentWriter seg_;
+  int64_t seg_day_{-1};
+  std::vector<bool> seg_named_;
+  std::atomic<uint64_t> written_total_{0};
+  Counter written_;
+  Counter dropped_counter_;
+};
+
+} // namespace ts
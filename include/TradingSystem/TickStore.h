@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "TradingSystem/MappedFile.h"
+
+namespace ts {
+
+// 定长Tick记录（即二进制Tick库中的存储格式），inst为合约序号
+struct TickRecord {
+  int64_t ts_ms;
+  double last;
+  double bid;
+  double ask;
+  int32_t inst;
+  int32_t volume;
+  int32_t bid_volume;
+  int32_t ask_volume;
+};
+static_assert(sizeof(TickRecord) == 48, "TickRecord layout is part of the file format");
+
+// 二进制Tick库路径约定：扩展名 .ticks
+bool is_tick_store_path(const std::string& path);
+
+// 顺序写出：文件头 + 合约表 + TickRecord数组；close时回填笔数并由临时文件改名
+class TickStoreWriter {
+ public:
+  TickStoreWriter() = default;
+  ~TickStoreWriter();
+  TickStoreWriter(const TickStoreWriter&) = delete;
+  TickStoreWriter& operator=(const TickStoreWriter&) = delete;
+
+  bool open(const std::string& path, const std::vector<std::string>& instruments);
+  void append(const TickRecord& r) {
+    buf_.push_back(r);
+    if (buf_.size() >= kBatch) flush();
+  }
+  bool close();
+  bool is_open() const { return f_ != nullptr; }
+  uint64_t count() const { return count_ + buf_.size(); }
+
+ private:
+  static constexpr size_t kBatch = 1 << 14;
+  void flush();
+  std::FILE* f_{nullptr};
+  std::string path_;
+  std::vector<TickRecord> buf_;
+  uint64_t count_{0};
+  bool failed_{false};
+};
+
+// 追加写的Tick段（与TickStoreWriter同一格式，可直接回放）：合约表按max_instruments定长预留，
+// 记录经可写mmap追加。commit回填笔数后已提交部分即可被TickStoreFile读取（进程中途退出也不丢），
+// close截断到实际长度。文件直接以目标名写出，不经临时文件
+class TickSegmentWriter {
+ public:
+  TickSegmentWriter() = default;
+  ~TickSegmentWriter();
+  TickSegmentWriter(const TickSegmentWriter&) = delete;
+  TickSegmentWriter& operator=(const TickSegmentWriter&) = delete;
+
+  bool open(const std::string& path, size_t max_instruments);
+  // 登记合约名（id须小于max_instruments）
+  void set_instrument(size_t id, const char* name);
+  bool append(const TickRecord& r);
+  void commit();
+  bool close();
+  bool is_open() const { return file_.is_open(); }
+  uint64_t count() const { return count_; }
+
+ private:
+  WritableMappedFile file_;
+  size_t max_instruments_{0};
+  size_t data_offset_{0};
+  uint64_t count_{0};
+  bool failed_{false};
+};
+
+// 只读的mmap Tick库
+class TickStoreFile {
+ public:
+  bool open(const std::string& path);
+  size_t instrument_count() const { return count_; }
+  std::string instrument(size_t i) const;
+  const TickRecord* ticks(size_t* n) const;
+
+ private:
+  MappedFile file_;
+  size_t count_{0};
+  size_t ticks_{0};
+};
+
+} // namespace ts
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ts {
+
+// 行情时间戳统一用"朴素"毫秒时间（不做时区换算，按日历直接折算为自1970-01-01的毫秒数）
+constexpr int64_t kMsPerSecond = 1000;
+constexpr int64_t kMsPerDay = 86400LL * 1000;
+
+// 解析 "YYYY-MM-DD HH:MM:SS[.fff]"（也接受'T'分隔与 "YYYYMMDD HH:MM:SS"），失败返回-1
+int64_t parse_datetime_ms(std::string_view s);
+// 解析 "HH:MM:SS[.fff]"，返回当日毫秒数；失败返回-1
+int64_t parse_time_of_day_ms(std::string_view s);
+// 格式化为 "YYYY-MM-DD HH:MM:SS.fff"
+std::string format_datetime_ms(int64_t ms);
+// 交易日（自1970-01-01的天数）：17点后的夜盘归下一日，周五夜盘与周末归下周一；不含节假日
+int64_t trading_day(int64_t ms);
+
+// 同上，供逐笔热路径：同一秒内只改写毫秒位，out复用已有容量
+class DatetimeFormatter {
+ public:
+  void format(int64_t ms, std::string* out);
+ private:
+  int64_t sec_{INT64_MIN};
+  std::string cached_;
+};
+
+inline int seconds_of_day(int64_t ms) {
+  int64_t d = ms % kMsPerDay;
+  if (d < 0) d += kMsPerDay;
+  return static_cast<int>(d / kMsPerSecond);
+}
+
+} // namespace ts
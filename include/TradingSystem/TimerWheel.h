@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ts {
+
+// 分层时间轮：4层×256槽，1毫秒分辨率，覆盖约49天（更远的到期先挂最高层，逐层下移）。
+// 节点按序号存放于池中，槽内为侵入式双向链表：调度与取消O(1)；推进时无定时器的层整段跳过，
+// 回测跨夜的长间隔不会逐毫秒空转。非线程安全，由调用方串行化。
+class TimerWheel {
+ public:
+  using TimerId = uint64_t;  // 高32位为代数，低32位为节点序号；0为无效ID
+  struct Fired {
+    TimerId id;
+    uint32_t owner;
+    uint64_t user_data;
+    int64_t due_ms;
+  };
+
+  explicit TimerWheel(int64_t now_ms = 0) : now_(now_ms) {
+    heads_.assign(kLists, kNil);
+    tails_.assign(kLists, kNil);
+  }
+
+  // 到期时间不晚于当前时刻的按下一毫秒处理；interval_ms>0为周期定时器，出队后按周期自动重排
+  TimerId schedule(int64_t due_ms, int64_t interval_ms, uint32_t owner, uint64_t user_data);
+  // 已触发的单次定时器或未知ID返回false
+  bool cancel(TimerId id);
+  // 推进时钟到now_ms（不回退），到期定时器按到期先后移入就绪队列
+  void advance(int64_t now_ms);
+  // 取出一个就绪定时器；周期定时器同时重排下一次到期
+  bool pop_ready(Fired* out);
+  // 整体平移时钟与全部未到期定时器（回测首笔行情前以事件时间为起点）
+  void rebase(int64_t now_ms);
+
+  int64_t now() const { return now_; }
+  size_t size() const { return live_; }
+
+ private:
+  static constexpr int kLevels = 4;
+  static constexpr int kBits = 8;
+  static constexpr int kSlots = 1 << kBits;
+  static constexpr uint32_t kNil = 0xFFFFFFFFu;
+  static constexpr int32_t kReady = kLevels * kSlots;  // 就绪队列，排在各槽之后
+  static constexpr int32_t kLists = kReady + 1;
+  static constexpr int32_t kFree = -1;
+
+  struct Node {
+    int64_t due{0};
+    int64_t interval{0};
+    uint64_t user_data{0};
+    uint32_t owner{0};
+    uint32_t gen{1};
+    uint32_t prev{kNil};
+    uint32_t next{kNil};
+    int32_t list{kFree};  // 所在链表：槽序号（层*256+槽）/ kReady / kFree
+  };
+
+  void place(uint32_t idx);
+  void link(uint32_t idx, int32_t list);
+  void unlink(uint32_t idx);
+  void release(uint32_t idx);
+  void cascade(int level);
+
+  int64_t now_;
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> free_;
+  std::vector<uint32_t> heads_;  // 各链表首尾；尾插保证同一毫秒内按调度先后触发
+  std::vector<uint32_t> tails_;
+  size_t level_count_[kLevels] = {0, 0, 0, 0};
+  size_t live_{0};
+};
+
+} // namespace ts
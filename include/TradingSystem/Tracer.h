@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace ts {
+
+// 事件时间线追踪：各线程把begin/end分段与瞬时事件写入自己的环形缓冲（满后覆盖最旧），
+// 运行结束时导出为Chrome trace-event JSON，可在Perfetto或chrome://tracing中查看。
+// 行情分段按笔采样（每sample_every笔记录一笔的完整调用链）；下单、撤单与订单回报不采样，始终记录。
+// 未启用时每个记录点仅一次relaxed原子读。
+namespace trace_detail {
+struct Event {
+  const char* name;  // 须为静态存储期字符串（字面量或Tracer::intern返回值）
+  const char* cat;
+  uint64_t ts_ns;
+  char ph;           // B/E/i
+};
+struct ThreadBuffer;
+inline std::atomic<bool> g_enabled{false};
+inline thread_local ThreadBuffer* tls_buf = nullptr;
+inline thread_local bool tls_sampled = false;   // 当前线程正处于被采样的行情内
+inline thread_local uint32_t tls_tick_seq = 0;
+} // namespace trace_detail
+
+class Tracer {
+ public:
+  static Tracer& instance();
+
+  // buffer_events：每线程缓冲容量（向上取2的幂）；sample_every：每N笔行情采样一笔（1为全部）
+  void start(size_t buffer_events, uint32_t sample_every);
+  // 停止记录并写出JSON；返回是否成功
+  bool stop_and_write(const std::string& path);
+  static bool enabled() { return trace_detail::g_enabled.load(std::memory_order_relaxed); }
+  uint32_t sample_every() const { return sample_every_; }
+
+  // 动态名称（如订单状态、策略名）驻留为静态存储期字符串；走锁，不应放在逐笔路径
+  const char* intern(const std::string& s);
+
+  static void record(char ph, const char* cat, const char* name);
+
+ private:
+  Tracer() = default;
+  trace_detail::ThreadBuffer* register_thread();
+
+  std::mutex mu_;
+  std::vector<std::unique_ptr<trace_detail::ThreadBuffer>> buffers_;
+  std::unordered_set<std::string> names_;
+  size_t capacity_{0};
+  uint32_t sample_every_{1};
+  uint64_t epoch_ns_{0};
+};
+
+// 行情入口：决定本笔是否采样，采样时记录整笔分段，析构时结束
+class TraceTick {
+ public:
+  TraceTick() {
+    if (!Tracer::enabled()) return;
+    if (trace_detail::tls_tick_seq++ % Tracer::instance().sample_every() != 0) return;
+    trace_detail::tls_sampled = true;
+    Tracer::record('B', "engine", "tick");
+  }
+  ~TraceTick() {
+    if (!trace_detail::tls_sampled) return;
+    Tracer::record('E', "engine", "tick");
+    trace_detail::tls_sampled = false;
+  }
+  TraceTick(const TraceTick&) = delete;
+  TraceTick& operator=(const TraceTick&) = delete;
+};
+
+// 分段：默认仅在被采样的行情内记录；force为true时只要启用即记录（订单路径）
+class TraceSpan {
+ public:
+  TraceSpan(const char* cat, const char* name, bool force = false)
+      : cat_(cat), name_(name),
+        on_((force || trace_detail::tls_sampled) && Tracer::enabled()) {
+    if (on_) Tracer::record('B', cat_, name_);
+  }
+  ~TraceSpan() {
+    if (on_) Tracer::record('E', cat_, name_);
+  }
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+ private:
+  const char* cat_;
+  const char* name_;
+  bool on_;
+};
+
+inline void trace_instant(const char* cat, const char* name) {
+  if (Tracer::enabled()) Tracer::record('i', cat, name);
+}
+
+} // namespace ts
+
+#define TS_TRACE_CONCAT_(a, b) a##b
+#define TS_TRACE_CONCAT(a, b) TS_TRACE_CONCAT_(a, b)
+// 作用域分段：TS_TRACE_SCOPE("risk", "risk.on_market_data");
+#define TS_TRACE_SCOPE(cat, name) ::ts::TraceSpan TS_TRACE_CONCAT(ts_trace_span_, __LINE__)(cat, name)
+// 不受采样限制的作用域分段（低频的订单路径）
+#define TS_TRACE_SCOPE_ALWAYS(cat, name) \
+  ::ts::TraceSpan TS_TRACE_CONCAT(ts_trace_span_, __LINE__)(cat, name, true)
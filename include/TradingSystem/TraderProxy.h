@@ -17,6 +17,7 @@ class TraderProxy : public ITrader {
 
   std::string place_order(const OrderRequest& req) override;
   bool cancel_order(const std::string& order_id) override;
+  std::string modify_order(const std::string& order_id, double new_price, int new_qty) override;
 
   void set_order_status_handler(OrderStatusHandler handler) override;
 
@@ -30,5 +31,10 @@ class TraderProxy : public ITrader {
   // 解决同步回调先于注册的问题：暂存下单请求，收到Accepted后注册
   std::deque<OrderRequest> pending_register_reqs_;
   void emit_order_status(const OrderStatusEvent& ev);
+  // 运行期指标
+  Counter submitted_;
+  Counter cancels_;
+  Counter modifies_;
+  Counter risk_rejected_;
 };
 } // namespace ts
\ No newline at end of file
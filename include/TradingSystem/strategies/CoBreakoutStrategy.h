@@ -0,0 +1,38 @@
+#pragma once
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include "TradingSystem/CoStrategy.h"
+
+namespace ts {
+// 协程示例：通道突破。收盘价突破前lookback根Bar的最高/最低价时挂限价单开仓，
+// 等待成交至多entry_timeout_ms，未完结则撤单；有成交则持有hold_bars根Bar后市价平仓，未平完的逐Bar重下。
+// 每合约同时只有一笔在途交易，整段流程写在一个协程里
+struct BreakoutTrade : CoFrame {
+  std::string inst;
+  Direction dir{Direction::Buy};
+  double limit{0.0};
+  int qty{0};
+  int left{0};  // 平仓未成交手数
+};
+
+class CoBreakoutStrategy : public CoStrategy<BreakoutTrade, 64> {
+ public:
+  CoBreakoutStrategy(int lookback, int hold_bars, double offset, int entry_timeout_ms);
+  Subscription subscription() const override { return {{}, kBarEvents | kOrderEvents}; }
+
+ protected:
+  void on_co_bar(const BarEvent& bar) override;
+  void on_co_stop() override;
+  void run(BreakoutTrade& t) override;
+
+ private:
+  int lookback_;
+  int hold_bars_;
+  double offset_;
+  int entry_timeout_ms_;
+  std::unordered_map<std::string, std::deque<double>> closes_;
+  std::unordered_map<std::string, bool> busy_;
+  int entries_{0}, unfilled_{0}, round_trips_{0}, exit_retries_{0};
+};
+} // namespace ts
@@ -0,0 +1,40 @@
+#pragma once
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "TradingSystem/Strategy.h"
+
+namespace ts {
+// 双均线策略：快线上穿慢线开多、下穿开空（基于Bar触发）
+class DualMAStrategy : public Strategy {
+ public:
+  // order_timeout_ms>0时，挂单超过该时长未完结即撤单（定时器时钟）
+  DualMAStrategy(int fast, int slow, double slippage, int order_timeout_ms = 0);
+  void on_market_data(const MarketDataEvent& md, ITrader* trader) override;
+  void on_bar(const BarEvent& bar, ITrader* trader) override;
+  void on_order_status(const OrderStatusEvent& ev) override;
+  void on_timer(uint64_t timer_id, uint64_t user_data, ITrader* trader) override;
+  // 预热慢线窗口，重启后首根Bar即可交易
+  size_t warmup_bars() const override { return static_cast<size_t>(slow_); }
+  void on_warmup(const std::string& instrument, const BarRecord* bars, size_t n) override;
+  // 仅由Bar触发，不接收逐Tick行情
+  Subscription subscription() const override { return {{}, kBarEvents | kOrderEvents}; }
+ private:
+  static double ma(const std::deque<BarEvent>& dq, int n);
+  void place(ITrader* trader, const OrderRequest& req, int sign);
+  void set_params(int fast, int slow, double slippage, int order_timeout_ms);
+  int fast_, slow_;
+  double slip_;
+  int order_timeout_ms_;
+  uint64_t params_version_{0};  // 已套用的热更新快照版本
+  // 带超时的挂单：order_id -> 定时器与方向；撤单后按未成交量回退仓位
+  struct Pending { uint64_t timer_id; std::string instrument; int sign; };
+  std::unordered_map<std::string, Pending> pending_;
+  std::unordered_map<uint64_t, std::string> timer_orders_;
+  bool placing_{false};
+  std::unordered_set<std::string> completed_;  // 本次下单调用返回前已同步完结的订单
+  std::unordered_map<std::string, std::deque<BarEvent>> bars_;
+  std::unordered_map<std::string, int> position_;
+};
+} // namespace ts
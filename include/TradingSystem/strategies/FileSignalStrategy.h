@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "TradingSystem/MappedFile.h"
+#include "TradingSystem/Strategy.h"
+
+namespace ts {
+// 预计算信号回放：mmap按时间排序的信号CSV，与行情流按时间戳归并，
+// 每条到期信号经ITrader下单。信号不进入堆上容器，仅维护一个文件游标。
+// 信号格式：id,datetime,instrument,side,offset,type,price,qty（表头可选；price<=0视为市价）
+class FileSignalStrategy : public Strategy {
+ public:
+  explicit FileSignalStrategy(std::string path);
+  bool ok() const { return file_.is_open(); }
+  void on_market_data(const MarketDataEvent& md, ITrader* trader) override;
+  void on_stop(ITrader* trader) override;
+  // 任一合约的行情都推进归并时钟
+  Subscription subscription() const override { return {{}, kTickEvents}; }
+
+ private:
+  struct Signal {
+    std::string_view id;
+    int64_t ts_ms{-1};
+    OrderRequest req;
+  };
+  // 解析游标处的一行；跳过空行/表头/非法行，文件结束返回false
+  bool peek(Signal* out);
+  void advance() { pos_ = next_pos_; }
+
+  std::string path_;
+  MappedFile file_;
+  size_t pos_{0};
+  size_t next_pos_{0};
+  int64_t last_signal_ts_{-1};
+  uint64_t emitted_{0};
+  uint64_t skipped_{0};
+  bool warned_no_ts_{false};
+};
+} // namespace ts
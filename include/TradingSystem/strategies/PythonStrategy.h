@@ -0,0 +1,78 @@
+#pragma once
+#ifdef USE_PY_EMBED
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TradingSystem/Event.h"
+#include "TradingSystem/Strategy.h"
+
+// 前置声明，避免在头文件中引入Python.h
+typedef struct _object PyObject;
+
+namespace ts {
+// 嵌入CPython的策略桥：行情与Bar按列缓冲，经缓冲区协议以连续数组批量交给Python（每个字段不创建Python对象），
+// 仅在回调期间持有GIL；下单与撤单在释放GIL后执行。
+class PythonStrategy : public Strategy {
+ public:
+  PythonStrategy(const std::string& module, const std::string& cls, const std::string& path, int batch_size);
+  ~PythonStrategy() override;
+  bool ok() const { return obj_ != nullptr; }
+
+  void on_market_data(const MarketDataEvent& md, ITrader* trader) override;
+  void on_bar(const BarEvent& bar, ITrader* trader) override;
+  void on_order_status(const OrderStatusEvent& ev) override;
+  void on_start(ITrader* trader) override;
+  void on_stop(ITrader* trader) override;
+
+ private:
+  // 列缓冲：容量固定为batch_size，memoryview在初始化时一次性创建并复用
+  struct TickCols {
+    std::vector<int32_t> inst;
+    std::vector<int64_t> ts;
+    std::vector<double> last, bid, ask;
+    std::vector<int64_t> bid_vol, ask_vol, volume;
+  };
+  struct BarCols {
+    std::vector<int32_t> inst;
+    std::vector<int64_t> ts;
+    std::vector<double> open, high, low, close;
+    std::vector<int64_t> volume;
+  };
+  struct Action {
+    bool cancel{false};
+    std::string order_id;
+    OrderRequest req;
+    PyObject* client_id{nullptr};
+  };
+
+  int32_t intern(const std::string& inst);
+  void flush_ticks(ITrader* trader);
+  void flush_bars(ITrader* trader);
+  // 以下函数要求调用方已持有GIL
+  void sync_instruments();
+  void collect_actions(PyObject* res, std::vector<Action>* out);
+  bool call_optional(const char* name, PyObject* arg);
+  // 释放GIL执行下单/撤单，再回调on_order_placed
+  void execute(std::vector<Action>& actions, ITrader* trader);
+
+  int batch_{1};
+  std::recursive_mutex mu_;
+  ITrader* trader_{nullptr};
+  TickCols ticks_;
+  BarCols bars_;
+  size_t n_ticks_{0};
+  size_t n_bars_{0};
+  std::vector<std::string> names_;
+  std::unordered_map<std::string, int32_t> ids_;
+  size_t names_synced_{0};
+
+  PyObject* obj_{nullptr};
+  PyObject* py_names_{nullptr};
+  std::vector<PyObject*> views_;
+  bool has_on_ticks_{false};
+  bool has_on_bars_{false};
+};
+} // namespace ts
+#endif
@@ -0,0 +1,54 @@
+"""最小示例：通过列式批量接口实现双均线。
+
+桥接在加载后为策略对象注入：
+  self.instruments  合约名列表，下标即 inst 列中的合约序号
+  self.ticks        列视图：inst, ts, last, bid, ask, bid_vol, ask_vol, volume
+  self.bars         列视图：inst, ts, open, high, low, close, volume
+每个列都是只读 memoryview（缓冲区协议，可用 numpy.frombuffer 零拷贝），
+on_ticks(n)/on_bars(n) 回调时仅前 n 项有效；回调返回订单字典列表或 None。
+"""
+from collections import defaultdict, deque
+
+
+class MyStrategy:
+    def on_init(self):
+        self.fast = 3
+        self.slow = 8
+        self.closes = defaultdict(lambda: deque(maxlen=self.slow))
+        self.pos = defaultdict(int)
+
+    def on_start(self):
+        pass
+
+    def on_ticks(self, n):
+        return None
+
+    def on_bars(self, n):
+        orders = []
+        b = self.bars
+        for i in range(n):
+            inst = self.instruments[b.inst[i]]
+            q = self.closes[inst]
+            q.append(b.close[i])
+            if len(q) < self.slow:
+                continue
+            fast = sum(list(q)[-self.fast:]) / self.fast
+            slow = sum(q) / self.slow
+            if fast > slow and self.pos[inst] <= 0:
+                orders.append({"instrument": inst, "side": "Buy", "offset": "Open",
+                               "type": "Limit", "price": b.close[i], "qty": 1})
+                self.pos[inst] += 1
+            elif fast < slow and self.pos[inst] >= 0:
+                orders.append({"instrument": inst, "side": "Sell", "offset": "Open",
+                               "type": "Limit", "price": b.close[i], "qty": 1})
+                self.pos[inst] -= 1
+        return orders
+
+    def on_order_placed(self, order):
+        pass
+
+    def on_order_status(self, ev):
+        pass
+
+    def on_stop(self):
+        print("[ts_strategy] positions:", dict(self.pos))
@@ -1,13 +1,24 @@
 #include "TradingSystem/BacktestMarketData.h"
+#include "TradingSystem/ThreadManager.h"
 #include "TradingSystem/Event.h"
+#include "TradingSystem/SessionCalendar.h"
+#include "TradingSystem/TickStore.h"
+#include "TradingSystem/TimeUtil.h"
 #include <fstream>
 #include <sstream>
+#include <string_view>
 #include <iostream>
 #include <chrono>
 
 namespace ts {
 BacktestMarketData::BacktestMarketData(int speed_ms) : speed_ms_(speed_ms) {}
-BacktestMarketData::~BacktestMarketData() {
+void BacktestMarketData::set_replay_clock(double speed, int64_t max_gap_ms) {
+  clock_.reset(new ReplayClock(speed, max_gap_ms));
+}
+
+BacktestMarketData::~BacktestMarketData() { stop(); }
+
+void BacktestMarketData::stop() {
   running_.store(false);
   if (worker_.joinable()) worker_.join();
 }
@@ -27,7 +38,10 @@ bool BacktestMarketData::subscribe(const std::vector<std::string>& instruments)
   sub_set_.clear();
   for (const auto& s : instruments) sub_set_.insert(s);
   running_.store(true);
-  worker_ = std::thread(&BacktestMarketData::run_loop, this);
+  worker_ = std::thread([this] {
+    run_loop();
+    done_.store(true, std::memory_order_release);
+  });
   return true;
 }
 
@@ -35,12 +49,76 @@ void BacktestMarketData::set_market_data_handler(MarketDataHandler handler) {
   handler_ = std::move(handler);
 }
 
-static bool looks_like_datetime(const std::string& s) {
+static bool looks_like_datetime(std::string_view s) {
   // 粗略判断是否为日期时间字符串
   return (s.find('-') != std::string::npos) || (s.find(':') != std::string::npos) || (s.find('T') != std::string::npos);
 }
 
+// 第k列（0起），不存在时返回空
+static std::string_view csv_field(const std::string& line, int k) {
+  size_t b = 0;
+  for (int i = 0; i < k; ++i) {
+    b = line.find(',', b);
+    if (b == std::string::npos) return std::string_view();
+    ++b;
+  }
+  size_t e = line.find(',', b);
+  return std::string_view(line.data() + b, (e == std::string::npos ? line.size() : e) - b);
+}
+
+// 表头中的时间列序号，未找到返回-1
+static int header_time_col(const std::string& line) {
+  std::stringstream ss(line);
+  std::string tok;
+  for (int i = 0; std::getline(ss, tok, ','); ++i) {
+    if (!tok.empty() && tok.back() == '\r') tok.pop_back();
+    if (tok == "datetime" || tok == "update_time" || tok == "time") return i;
+  }
+  return -1;
+}
+
+// 行的时间列：表头声明优先；无表头时第2列像日期时间即为格式2，否则取格式1的第6列
+static std::string_view row_time(const std::string& line, int time_col) {
+  if (time_col >= 0) return csv_field(line, time_col);
+  std::string_view t_sv = csv_field(line, 1);
+  return looks_like_datetime(t_sv) ? t_sv : csv_field(line, 5);
+}
+
+static bool is_header(const std::string& line) {
+  return line.find("instrument") != std::string::npos && line.find(",") != std::string::npos;
+}
+
+int64_t BacktestMarketData::replay_start_ms() {
+  if (is_tick_store_path(file_)) {
+    TickStoreFile store;
+    size_t n = 0;
+    const TickRecord* recs = store.open(file_) ? store.ticks(&n) : nullptr;
+    return n > 0 ? recs[0].ts_ms : -1;
+  }
+  // 取首个带时间戳的数据行（清洗后的文件按时间排序）；只看文件开头，整列无时间戳时视为未知
+  std::ifstream ifs(file_);
+  std::string line;
+  int time_col = -1;
+  for (int rows = 0; rows < 1000 && std::getline(ifs, line);) {
+    if (line.empty()) continue;
+    if (is_header(line)) {
+      time_col = header_time_col(line);
+      continue;
+    }
+    ++rows;
+    const int64_t t_ms = parse_datetime_ms(row_time(line, time_col));
+    if (t_ms >= 0) return t_ms;
+  }
+  return -1;
+}
+
 void BacktestMarketData::run_loop() {
+  ThreadManager::instance().enter(ThreadRole::Feed);
+  if (is_tick_store_path(file_)) {
+    run_store();
+    running_.store(false);
+    return;
+  }
   std::ifstream ifs(file_);
   if (!ifs.good()) {
     std::cerr << "[BTMD] Cannot open file: " << file_ << std::endl;
@@ -51,21 +129,38 @@ void BacktestMarketData::run_loop() {
   // 支持两种CSV：
   // 1) instrument,last_price,volume[,bid_price,ask_price,update_time]
   // 2) instrument,datetime,last_price,bid_price,ask_price,bid_volume,ask_volume,volume,[...]
+  // 格式1的时间列默认在第6列（update_time），表头另有声明时以表头为准
+  uint64_t skipped_session = 0;
+  uint64_t malformed = 0;
+  int time_col = -1;
   while (running_.load() && std::getline(ifs, line)) {
     if (line.empty()) continue;
     // 跳过可能的表头
-    if (line.find("instrument") != std::string::npos && line.find(",") != std::string::npos) continue;
+    if (is_header(line)) {
+      time_col = header_time_col(line);
+      continue;
+    }
+    // 先只取合约与时间两列：未订阅或休市时段的行不做完整解析
+    size_t c0 = line.find(',');
+    if (c0 == std::string::npos) continue;
+    std::string_view inst_sv(line.data(), c0);
+    if (!sub_set_.empty() && sub_set_.find(std::string(inst_sv)) == sub_set_.end()) continue;
+    int64_t t_ms = -1;
+    if (calendar_ || clock_) {
+      t_ms = parse_datetime_ms(row_time(line, time_col));
+      if (calendar_ && t_ms >= 0) {
+        const TradingSessions* ss = calendar_->find(std::string(inst_sv));
+        if (ss && !ss->contains_ms(t_ms)) { ++skipped_session; continue; }
+      }
+    }
     std::stringstream ss(line);
     std::string tok;
     std::vector<std::string> cols;
     while (std::getline(ss, tok, ',')) cols.push_back(tok);
-    if (cols.size() < 3) continue;
+    if (cols.size() < 3) { ++malformed; continue; }
 
     MarketDataEvent ev;
     ev.instrument = cols[0];
-    if (!sub_set_.empty() && sub_set_.find(ev.instrument) == sub_set_.end()) {
-      continue; // 未订阅的合约跳过
-    }
 
     // 判断格式
     bool fmt2 = (cols.size() >= 8 && looks_like_datetime(cols[1]));
@@ -79,24 +174,80 @@ void BacktestMarketData::run_loop() {
         ev.ask_volume = std::stoi(cols[6]);
         ev.volume = std::stoi(cols[7]);
       } else {
+        const size_t tc = time_col > 2 ? static_cast<size_t>(time_col) : 5;
         ev.last_price = std::stod(cols[1]);
         ev.volume = std::stoi(cols[2]);
-        if (cols.size() > 3) {
-          try { ev.bid_price = std::stod(cols[3]); } catch (...) { ev.bid_price = ev.last_price - 0.5; }
-        } else { ev.bid_price = ev.last_price - 0.5; }
-        if (cols.size() > 4) {
-          try { ev.ask_price = std::stod(cols[4]); } catch (...) { ev.ask_price = ev.last_price + 0.5; }
-        } else { ev.ask_price = ev.last_price + 0.5; }
-        if (cols.size() > 5) ev.update_time = cols[5]; else ev.update_time = "bt";
+        // 缺失的买卖价以最新价补齐（零价差），不再虚构价差
+        if (cols.size() > 3 && tc != 3) {
+          try { ev.bid_price = std::stod(cols[3]); } catch (...) { ev.bid_price = ev.last_price; }
+        } else { ev.bid_price = ev.last_price; }
+        if (cols.size() > 4 && tc != 4) {
+          try { ev.ask_price = std::stod(cols[4]); } catch (...) { ev.ask_price = ev.last_price; }
+        } else { ev.ask_price = ev.last_price; }
+        if (cols.size() > tc) ev.update_time = cols[tc]; else ev.update_time = "bt";
       }
     } catch (...) {
-      continue; // 非法行
+      ++malformed; // 非法行
+      continue;
     }
 
+    if (clock_) {
+      // 按事件时间节拍：无时间戳的行退回固定间隔
+      if (t_ms < 0) t_ms = parse_datetime_ms(ev.update_time);
+      if (t_ms >= 0) clock_->wait_until_event(t_ms);
+      else if (speed_ms_ > 0) std::this_thread::sleep_for(std::chrono::milliseconds(speed_ms_));
+    }
     if (handler_) handler_(ev);
-    std::this_thread::sleep_for(std::chrono::milliseconds(speed_ms_));
+    if (!clock_ && speed_ms_ > 0) std::this_thread::sleep_for(std::chrono::milliseconds(speed_ms_));
   }
+  if (skipped_session > 0) std::cout << "[BTMD] skipped " << skipped_session << " out-of-session ticks" << std::endl;
+  if (malformed > 0) std::cerr << "[BTMD] skipped " << malformed << " malformed lines (see backtest_clean)" << std::endl;
   running_.store(false);
 }
 
+// 二进制Tick库：mmap后逐记录回放，无需解析文本
+void BacktestMarketData::run_store() {
+  TickStoreFile store;
+  if (!store.open(file_)) {
+    std::cerr << "[BTMD] Cannot open tick store: " << file_ << std::endl;
+    return;
+  }
+  // 合约序号 -> 是否订阅与交易时段
+  struct InstInfo {
+    std::string name;
+    bool wanted;
+    const TradingSessions* sessions;
+  };
+  std::vector<InstInfo> insts(store.instrument_count());
+  for (size_t i = 0; i < insts.size(); ++i) {
+    insts[i].name = store.instrument(i);
+    insts[i].wanted = sub_set_.empty() || sub_set_.count(insts[i].name) > 0;
+    insts[i].sessions = calendar_ ? calendar_->find(insts[i].name) : nullptr;
+  }
+  size_t n = 0;
+  const TickRecord* recs = store.ticks(&n);
+  DatetimeFormatter fmt;
+  MarketDataEvent ev;
+  uint64_t skipped_session = 0;
+  for (size_t k = 0; k < n && running_.load(std::memory_order_relaxed); ++k) {
+    const TickRecord& r = recs[k];
+    if (r.inst < 0 || static_cast<size_t>(r.inst) >= insts.size()) continue;
+    const InstInfo& info = insts[static_cast<size_t>(r.inst)];
+    if (!info.wanted) continue;
+    if (info.sessions && !info.sessions->contains_ms(r.ts_ms)) { ++skipped_session; continue; }
+    ev.instrument.assign(info.name);
+    fmt.format(r.ts_ms, &ev.update_time);
+    ev.last_price = r.last;
+    ev.bid_price = r.bid;
+    ev.ask_price = r.ask;
+    ev.volume = r.volume;
+    ev.bid_volume = r.bid_volume;
+    ev.ask_volume = r.ask_volume;
+    if (clock_) clock_->wait_until_event(r.ts_ms);
+    if (handler_) handler_(ev);
+    if (!clock_ && speed_ms_ > 0) std::this_thread::sleep_for(std::chrono::milliseconds(speed_ms_));
+  }
+  if (skipped_session > 0) std::cout << "[BTMD] skipped " << skipped_session << " out-of-session ticks" << std::endl;
+}
+
 } // namespace ts
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "TradingSystem/BacktestTrader.h"
+#include "TradingSystem/ConfigUtil.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -8,6 +9,18 @@
 
 namespace ts {
 
+BacktestTrader::BacktestTrader() {
+  auto& r = MetricsRegistry::instance();
+  metrics_.orders = r.counter("ts_bt_orders_total", "Orders accepted by the backtest matcher");
+  metrics_.order_qty = r.counter("ts_bt_order_qty_total", "Volume of orders accepted by the backtest matcher");
+  metrics_.fills = r.counter("ts_bt_fills_total", "Fill events (full and partial) from the backtest matcher");
+  metrics_.fill_qty = r.counter("ts_bt_fill_qty_total", "Volume filled by the backtest matcher");
+  metrics_.partial_fills = r.counter("ts_bt_partial_fills_total", "Partial fill events from the backtest matcher");
+  metrics_.cancels = r.counter("ts_bt_cancels_total", "Orders canceled in the backtest matcher (user or IOC remainder)");
+  metrics_.rejects = r.counter("ts_bt_rejects_total", "Orders rejected by the backtest matcher");
+  metrics_.modifies = r.counter("ts_bt_modifies_total", "Orders modified in place by the backtest matcher");
+}
+
 bool BacktestTrader::connect(const std::string& front) {
   std::cout << "[BTTR] Connect to " << front << std::endl;
   return true;
@@ -31,7 +44,10 @@ std::string BacktestTrader::place_order(const OrderRequest& order) {
   OrderRec rec;
   rec.id = gen_id();
   rec.req = order;
+  rec.px = limit_units(meta_.get(order.instrument), order.direction, order.price);
   rec.remaining = order.volume;
+  metrics_.orders.inc();
+  metrics_.order_qty.inc(static_cast<uint64_t>(std::max(order.volume, 0)));
   emit_status(rec.id, "Accepted", "accepted", order.instrument, 0, 0.0, rec.remaining);
   // 立即处理FOK/IOC
   auto it = last_tick_.find(order.instrument);
@@ -40,10 +56,10 @@ std::string BacktestTrader::place_order(const OrderRequest& order) {
     // FOK：仅当能完全成交时执行，否则拒绝
     if (order.type == OrderType::FOK) {
       int avail = (order.direction == Direction::Buy) ? tk.ask_vol : tk.bid_vol;
-      bool cross = (order.direction == Direction::Buy) ? (tk.ask <= order.price) : (tk.bid >= order.price);
+      bool cross = (order.direction == Direction::Buy) ? (tk.ask <= rec.px) : (tk.bid >= rec.px);
       if (order.type == OrderType::Market) cross = true; // 市价必交叉
       if (avail >= order.volume && (order.type == OrderType::Market || cross)) {
-        pending_[order.instrument].push_back(rec);
+        enqueue(order.instrument, rec);
         try_match(order.instrument, tk);
       } else {
         emit_status(rec.id, "Rejected", "FOK not fully matchable", order.instrument, 0, 0.0, rec.remaining);
@@ -51,80 +67,121 @@ std::string BacktestTrader::place_order(const OrderRequest& order) {
       return rec.id;
     }
     if (order.type == OrderType::IOC) {
-      pending_[order.instrument].push_back(rec);
+      enqueue(order.instrument, rec);
       try_match(order.instrument, tk);
-      // 剩余部分立即取消
-      auto& q = pending_[order.instrument];
-      if (!q.empty() && q.front().id == rec.id && q.front().remaining > 0) {
-        emit_status(rec.id, "Canceled", "IOC remainder canceled", order.instrument, 0, 0.0, q.front().remaining);
-        q.pop_front();
+      // 剩余部分立即取消（按索引定位，前面另有挂单时同样生效）
+      auto f = index_.find(rec.id);
+      if (f != index_.end()) {
+        const int remaining = f->second.it->remaining;
+        dequeue(*f->second.queue, f->second.it);
+        emit_status(rec.id, "Canceled", "IOC remainder canceled", order.instrument, 0, 0.0, remaining);
       }
       return rec.id;
     }
     // Limit/Market：入队，等待tick撮合或立即尝试
-    pending_[order.instrument].push_back(rec);
+    enqueue(order.instrument, rec);
     try_match(order.instrument, tk);
   } else {
     // 无行情，直接入队
-    pending_[order.instrument].push_back(rec);
+    enqueue(order.instrument, rec);
   }
   return rec.id;
 }
 
 bool BacktestTrader::cancel_order(const std::string& order_id) {
-  for (auto& kv : pending_) {
-    auto& q = kv.second;
-    for (auto it = q.begin(); it != q.end(); ++it) {
-      if (it->id == order_id) {
-        emit_status(order_id, "Canceled", "user canceled", kv.first, 0, 0.0, it->remaining);
-        q.erase(it);
-        return true;
-      }
+  auto f = index_.find(order_id);
+  if (f == index_.end()) return false;
+  OrderLoc loc = f->second;
+  const std::string instr = loc.it->req.instrument;
+  const int remaining = loc.it->remaining;
+  dequeue(*loc.queue, loc.it);
+  emit_status(order_id, "Canceled", "user canceled", instr, 0, 0.0, remaining);
+  return true;
+}
+
+std::string BacktestTrader::modify_order(const std::string& order_id, double new_price, int new_qty) {
+  auto f = index_.find(order_id);
+  if (f == index_.end() || new_qty <= 0) return std::string();
+  OrderQueue& q = *f->second.queue;
+  auto it = f->second.it;
+  OrderRec& ord = *it;
+  const int64_t new_px = limit_units(meta_.get(ord.req.instrument), ord.req.direction, new_price);
+  const bool reprice = ord.req.type != OrderType::Market && new_px != ord.px;
+  const bool size_up = new_qty > ord.remaining;
+  ord.req.volume += new_qty - ord.remaining;
+  ord.req.price = new_price;
+  ord.px = new_px;
+  ord.remaining = new_qty;
+  // 改价或加量失去时间优先，移到队尾（splice不使迭代器失效）
+  if (reprice || size_up) {
+    q.splice(q.end(), q, it);
+    ++queue_epoch_;
+  }
+  metrics_.modifies.inc();
+  const std::string instr = ord.req.instrument;
+  const bool is_buy = ord.req.direction == Direction::Buy;
+  emit_status(order_id, "Modified", "px=" + std::to_string(new_price) + ",qty=" + std::to_string(new_qty), instr, 0, 0.0,
+              new_qty);
+  // 其余挂单已对当前tick撮合过，只有改价后与对手价交叉时才需要重新撮合
+  if (reprice) {
+    auto tk = last_tick_.find(instr);
+    if (tk != last_tick_.end()) {
+      const bool cross = is_buy ? (tk->second.ask <= new_px) : (tk->second.bid >= new_px);
+      if (cross) try_match(instr, tk->second);
     }
   }
-  return false;
+  return order_id;
+}
+
+void BacktestTrader::enqueue(const std::string& instr, const OrderRec& rec) {
+  OrderQueue& q = pending_[instr];
+  q.push_back(rec);
+  index_[rec.id] = OrderLoc{&q, std::prev(q.end())};
+}
+
+BacktestTrader::OrderQueue::iterator BacktestTrader::dequeue(OrderQueue& q, OrderQueue::iterator it) {
+  index_.erase(it->id);
+  ++queue_epoch_;
+  return q.erase(it);
 }
 
 void BacktestTrader::on_market_data(const MarketDataEvent& ev) {
-  Tick tk{ev.bid_price, ev.ask_price, ev.bid_volume, ev.ask_volume, ev.last_price, ev.update_time};
-  last_tick_[ev.instrument] = tk;
+  Tick& tk = last_tick_[ev.instrument];
+  if (!tk.meta) tk.meta = &meta_.get(ev.instrument);
+  const InstrumentMeta& m = *tk.meta;
+  tk.bid = m.to_units(ev.bid_price);
+  tk.ask = m.to_units(ev.ask_price);
+  tk.last = m.to_units(ev.last_price);
+  tk.bid_vol = ev.bid_volume;
+  tk.ask_vol = ev.ask_volume;
   try_match(ev.instrument, tk);
 }
 
 void BacktestTrader::configure(const std::string& meta_path, const std::string& rules_path) {
-  // 朴素解析：从meta读取tick_size、multiplier、slippage_tick；从rules读取global slippage与partial_fill
-  // meta示例：[{"instrument":"IF2401","tick_size":0.2,"contract_multiplier":300,"slippage_tick":0.5}, ...]
-  std::ifstream mf(meta_path);
-  if (mf.good()) {
-    std::stringstream buf; buf << mf.rdbuf();
-    std::string s = buf.str();
-    // 简单逐项扫描（不严谨，但可用）
-    size_t pos = 0;
-    while ((pos = s.find("instrument\":\"", pos)) != std::string::npos) {
-      pos += 13; size_t end = s.find('"', pos); if (end == std::string::npos) break; std::string instr = s.substr(pos, end-pos);
-      InstrumentMeta m;
-      // tick_size
-      size_t tpos = s.find("tick_size\":", end);
-      if (tpos != std::string::npos) { tpos += 11; m.tick_size = std::stod(s.substr(tpos)); }
-      // contract_multiplier
-      size_t mpos = s.find("contract_multiplier\":", end);
-      if (mpos != std::string::npos) { mpos += 21; m.contract_multiplier = std::stoi(s.substr(mpos)); }
-      // slippage_tick
-      size_t spos = s.find("slippage_tick\":", end);
-      if (spos != std::string::npos) { spos += 16; m.slippage_tick = std::stod(s.substr(spos)); }
-      meta_[instr] = m;
-      pos = end + 1;
-    }
-  }
+  // meta.json：合约跳价、乘数、滑点与手续费；rules中读取global slippage与partial_fill
+  if (meta_.load_meta(meta_path) == 0 && !meta_path.empty()) std::cerr << "[BTTR] no instrument meta in " << meta_path << ", using default tick 1.0" << std::endl;
   std::ifstream rf(rules_path);
   if (rf.good()) {
     std::stringstream buf; buf << rf.rdbuf();
     std::string s = buf.str();
     size_t spos = s.find("slippage_tick\":"); if (spos != std::string::npos) { spos += 16; global_slippage_tick_ = std::stod(s.substr(spos)); }
     size_t ppos = s.find("partial_fill\":"); if (ppos != std::string::npos) { ppos += 14; std::string v = s.substr(ppos, 5); partial_fill_ = (v.find("true") != std::string::npos || v.find("True") != std::string::npos); }
+    std::string mt;
+    if (json_string(s, "match_type", &mt)) {
+      if (mt == "L1_tick") match_type_ = mt;
+      else std::cerr << "[BTTR] unsupported match_type " << mt << ", using L1_tick" << std::endl;
+    }
   }
   std::cout << "[BTTR] Loaded meta from " << meta_path << ", rules from " << rules_path << std::endl;
 }
+
+void BacktestTrader::override_rules(const MatchingOverrides& o) {
+  if (o.slippage_tick >= 0.0) slippage_override_ = o.slippage_tick;
+  if (o.partial_fill >= 0) partial_fill_ = (o.partial_fill != 0);
+  if (!o.match_type.empty() && o.match_type != match_type_) {
+    std::cerr << "[BTTR] unsupported match_type " << o.match_type << ", using " << match_type_ << std::endl;
+  }
+}
 void BacktestTrader::emit_status(const std::string& id,
                                  const std::string& status,
                                  const std::string& msg,
@@ -132,6 +189,15 @@ void BacktestTrader::emit_status(const std::string& id,
                                  int filled_qty,
                                  double fill_price,
                                  int remaining_qty) {
+  if (status == "Filled" || status == "PartiallyFilled") {
+    metrics_.fills.inc();
+    metrics_.fill_qty.inc(static_cast<uint64_t>(std::max(filled_qty, 0)));
+    if (status[0] == 'P') metrics_.partial_fills.inc();
+  } else if (status == "Canceled") {
+    metrics_.cancels.inc();
+  } else if (status == "Rejected") {
+    metrics_.rejects.inc();
+  }
   if (handler_) {
     OrderStatusEvent ev{id, status, msg};
     ev.instrument = instrument;
@@ -142,15 +208,14 @@ void BacktestTrader::emit_status(const std::string& id,
   }
 }
 
-double BacktestTrader::tick_size(const std::string& instr) const {
-  auto it = meta_.find(instr);
-  return (it != meta_.end()) ? it->second.tick_size : 1.0;
+double BacktestTrader::slippage_tick(const InstrumentMeta& m) const {
+  if (slippage_override_ >= 0.0) return slippage_override_;
+  if (m.slippage_tick > 0.0) return m.slippage_tick;
+  return global_slippage_tick_;
 }
 
-double BacktestTrader::slippage_tick(const std::string& instr) const {
-  auto it = meta_.find(instr);
-  if (it != meta_.end() && it->second.slippage_tick > 0.0) return it->second.slippage_tick;
-  return global_slippage_tick_;
+int64_t BacktestTrader::limit_units(const InstrumentMeta& m, Direction dir, double price) const {
+  return dir == Direction::Buy ? m.floor_units(price) : m.ceil_units(price);
 }
 
 void BacktestTrader::try_match(const std::string& instr, const Tick& tk) {
@@ -163,25 +228,27 @@ void BacktestTrader::try_match(const std::string& instr, const Tick& tk) {
   int avail_buy = tk.ask_vol; // 买单用ask侧挂量
   int avail_sell = tk.bid_vol; // 卖单用bid侧挂量
 
+  const InstrumentMeta& m = *tk.meta;
+  // 小数跳的滑点按价格单位四舍五入
+  const int64_t slip = std::llround(slippage_tick(m) * static_cast<double>(m.per_tick));
+
   // 遍历队列（FIFO），按价格与交叉条件撮合
   for (auto it = q.begin(); it != q.end();) {
     auto& ord = *it;
-    double tsz = tick_size(instr);
-    double slip = slippage_tick(instr) * tsz;
 
     bool is_buy = (ord.req.direction == Direction::Buy);
     bool cross = false;
-    double trade_px = 0.0;
+    int64_t trade_px = 0;
     if (ord.req.type == OrderType::Market) {
       cross = true;
       trade_px = is_buy ? (tk.ask + slip) : (tk.bid - slip);
     } else {
       if (is_buy) {
-        cross = (tk.ask <= ord.req.price);
-        trade_px = std::min(ord.req.price, tk.ask + slip);
+        cross = (tk.ask <= ord.px);
+        trade_px = std::min(ord.px, tk.ask + slip);
       } else {
-        cross = (tk.bid >= ord.req.price);
-        trade_px = std::max(ord.req.price, tk.bid - slip);
+        cross = (tk.bid >= ord.px);
+        trade_px = std::max(ord.px, tk.bid - slip);
       }
     }
 
@@ -204,24 +271,33 @@ void BacktestTrader::try_match(const std::string& instr, const Tick& tk) {
     ord.remaining -= fill_qty;
     avail -= fill_qty;
 
-    // 四舍五入到tick
-    if (tsz > 0) {
-      trade_px = std::round(trade_px / tsz) * tsz;
-    }
+    // 四舍五入到tick（已登记合约的价格单位即tick，无需对齐）
+    const double fill_px = m.to_price(m.round_to_tick(trade_px));
 
+    // 回报可能同步触发撤单/改单/下单：完结的订单先出队再回报，未完结的先取得后继
+    const std::string msg = "px=" + std::to_string(fill_px) + ",qty=" + std::to_string(fill_qty);
+    uint64_t epoch = 0;
     if (ord.remaining <= 0) {
-      emit_status(ord.id, "Filled", "px=" + std::to_string(trade_px) + ",qty=" + std::to_string(fill_qty), instr, fill_qty, trade_px, ord.remaining);
-      it = q.erase(it);
-    } else {
-      emit_status(ord.id, "PartiallyFilled", "px=" + std::to_string(trade_px) + ",qty=" + std::to_string(fill_qty), instr, fill_qty, trade_px, ord.remaining);
+      const std::string id = ord.id;
+      it = dequeue(q, it);
+      epoch = queue_epoch_;
+      emit_status(id, "Filled", msg, instr, fill_qty, fill_px, 0);
+    } else if (ord.req.type == OrderType::IOC) {
       // IOC在本tick后取消剩余
-      if (ord.req.type == OrderType::IOC) {
-        emit_status(ord.id, "Canceled", "IOC remainder canceled", instr, 0, 0.0, ord.remaining);
-        it = q.erase(it);
-      } else {
-        ++it;
-      }
+      const std::string id = ord.id;
+      const int remaining = ord.remaining;
+      it = dequeue(q, it);
+      epoch = queue_epoch_;
+      emit_status(id, "PartiallyFilled", msg, instr, fill_qty, fill_px, remaining);
+      emit_status(id, "Canceled", "IOC remainder canceled", instr, 0, 0.0, remaining);
+    } else {
+      auto next = std::next(it);
+      epoch = queue_epoch_;
+      emit_status(ord.id, "PartiallyFilled", msg, instr, fill_qty, fill_px, ord.remaining);
+      it = next;
     }
+    // 回调中队列被改动（后继可能已出队）：从队首重扫，已成交的已出队、未交叉的仍不成交
+    if (queue_epoch_ != epoch) it = q.begin();
 
     if (avail <= 0) break; // 当前tick侧量已用尽
   }
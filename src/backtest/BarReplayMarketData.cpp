@@ -0,0 +1,130 @@
+#include "TradingSystem/BarReplayMarketData.h"
+#include "TradingSystem/ThreadManager.h"
+#include "TradingSystem/SessionCalendar.h"
+#include "TradingSystem/TimeUtil.h"
+#include <iostream>
+#include <limits>
+
+namespace ts {
+BarReplayMarketData::BarReplayMarketData(int interval_sec, std::string cache_dir)
+    : interval_sec_(interval_sec > 0 ? interval_sec : 1), cache_dir_(std::move(cache_dir)) {}
+
+void BarReplayMarketData::set_replay_clock(double speed, int64_t max_gap_ms) {
+  clock_.reset(new ReplayClock(speed, max_gap_ms));
+}
+
+BarReplayMarketData::~BarReplayMarketData() { stop(); }
+
+void BarReplayMarketData::stop() {
+  running_.store(false);
+  if (worker_.joinable()) worker_.join();
+}
+
+bool BarReplayMarketData::connect(const std::string& front) {
+  file_ = front;
+  std::cout << "[BarReplay] Using file " << file_ << std::endl;
+  return true;
+}
+
+bool BarReplayMarketData::login(const std::string& broker_id, const std::string& user_id, const std::string& password) {
+  std::cout << "[BarReplay] Login (noop)" << std::endl;
+  return true;
+}
+
+bool BarReplayMarketData::open_cache() {
+  if (cache_open_) return true;
+  std::string err;
+  if (!ensure_bar_cache(cache_dir_, file_, interval_sec_, &bars_, &err, calendar_)) {
+    std::cerr << "[BarReplay] " << err << std::endl;
+    return false;
+  }
+  std::cout << "[BarReplay] Using bar cache " << bar_cache_path(cache_dir_, file_, interval_sec_, calendar_)
+            << " instruments=" << bars_.instrument_count() << std::endl;
+  cache_open_ = true;
+  return true;
+}
+
+int64_t BarReplayMarketData::replay_start_ms() {
+  if (!open_cache()) return -1;
+  int64_t first = std::numeric_limits<int64_t>::max();
+  for (size_t i = 0; i < bars_.instrument_count(); ++i) {
+    size_t n = 0;
+    const BarRecord* p = bars_.bars(i, &n);
+    if (n > 0 && p[0].ts_ms < first) first = p[0].ts_ms;
+  }
+  return first == std::numeric_limits<int64_t>::max() ? -1 : first;
+}
+
+bool BarReplayMarketData::subscribe(const std::vector<std::string>& instruments) {
+  // 缓存最迟在订阅时打开：此时已设置交易日历，Bar按时段对齐（与实时聚合一致）
+  if (!open_cache()) return false;
+  sub_set_.clear();
+  for (const auto& s : instruments) sub_set_.insert(s);
+  running_.store(true);
+  worker_ = std::thread([this] {
+    run_loop();
+    done_.store(true, std::memory_order_release);
+  });
+  return true;
+}
+
+void BarReplayMarketData::set_market_data_handler(MarketDataHandler handler) {
+  handler_ = std::move(handler);
+}
+
+void BarReplayMarketData::set_bar_handler(BarEventHandler handler) {
+  bar_handler_ = std::move(handler);
+}
+
+void BarReplayMarketData::run_loop() {
+  ThreadManager::instance().enter(ThreadRole::Feed);
+  // 每个订阅合约一个游标，按Bar时间做多路归并
+  struct Cursor {
+    std::string instrument;
+    const BarRecord* cur;
+    const BarRecord* end;
+    const TradingSessions* sessions;
+  };
+  std::vector<Cursor> cursors;
+  for (size_t i = 0; i < bars_.instrument_count(); ++i) {
+    std::string inst = bars_.instrument(i);
+    if (!sub_set_.empty() && sub_set_.find(inst) == sub_set_.end()) continue;
+    size_t n = 0;
+    const BarRecord* p = bars_.bars(i, &n);
+    if (n > 0) cursors.push_back({inst, p, p + n, calendar_ ? calendar_->find(inst) : nullptr});
+  }
+  const int64_t interval_ms = interval_sec_ * kMsPerSecond;
+  MarketDataEvent md;
+  BarEvent bar;
+  while (running_.load()) {
+    Cursor* next = nullptr;
+    int64_t best = std::numeric_limits<int64_t>::max();
+    for (auto& c : cursors) {
+      if (c.cur != c.end && c.cur->ts_ms < best) { best = c.cur->ts_ms; next = &c; }
+    }
+    if (!next) break;
+    const BarRecord& r = *next->cur++;
+    // 起点落在休市时段或收盘秒的Bar直接跳过（按时段对齐的缓存不会出现，防缓存与日历不一致）
+    if (next->sessions && !(next->sessions->contains_ms(r.ts_ms) && next->sessions->contains_ms(r.ts_ms + kMsPerSecond))) continue;
+    int vol = r.volume > std::numeric_limits<int>::max() ? std::numeric_limits<int>::max() : static_cast<int>(r.volume);
+    // 合成收盘行情：买卖价取收盘价，挂量取Bar成交量，供撮合与风控估值
+    md.instrument = next->instrument;
+    md.last_price = md.bid_price = md.ask_price = r.close;
+    md.volume = vol;
+    md.bid_volume = md.ask_volume = vol;
+    md.update_time = format_datetime_ms(r.ts_ms + interval_ms);
+    if (clock_) clock_->wait_until_event(r.ts_ms + interval_ms);
+    if (handler_) handler_(md);
+    bar.instrument = next->instrument;
+    bar.open = r.open;
+    bar.high = r.high;
+    bar.low = r.low;
+    bar.close = r.close;
+    bar.volume = vol;
+    bar.ts = format_datetime_ms(r.ts_ms);
+    if (bar_handler_) bar_handler_(bar);
+  }
+  running_.store(false);
+}
+
+} // namespace ts
@@ -0,0 +1,233 @@
+#include "TradingSystem/SyntheticMarketData.h"
+#include "TradingSystem/ThreadManager.h"
+#include "TradingSystem/TimeUtil.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+namespace ts {
+namespace {
+// 每年252个交易日、每日4小时
+constexpr double kMsPerTradingYear = 252.0 * 4 * 3600 * 1000;
+constexpr double kMsPerTradingDay = 4.0 * 3600 * 1000;
+// 未配置起点时的事件时间起点
+constexpr const char* kDefaultStart = "2024-01-02 09:00:00";
+
+uint64_t splitmix64(uint64_t* x) {
+  uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+inline uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+} // namespace
+
+SyntheticTickGenerator::SyntheticTickGenerator(const SyntheticConfig& cfg, std::vector<std::string> instruments)
+    : cfg_(cfg), names_(std::move(instruments)) {
+  if (names_.empty()) names_ = default_names(std::max(1, cfg_.instruments));
+  if (cfg_.tick_size <= 0.0) cfg_.tick_size = 1.0;
+  if (cfg_.rate <= 0.0) cfg_.rate = 1.0;
+  if (cfg_.burst_factor < 1.0) cfg_.burst_factor = 1.0;
+  if (cfg_.burst_len < 1.0) cfg_.burst_len = 1.0;
+  if (cfg_.start_ms <= 0) cfg_.start_ms = parse_datetime_ms(kDefaultStart);
+  uint64_t sm = cfg_.seed;
+  for (auto& w : s_) w = splitmix64(&sm);
+
+  var_per_ms_ = cfg_.vol * cfg_.vol / kMsPerTradingYear;
+  ou_kappa_ = cfg_.mean_revert / kMsPerTradingDay;
+  ou_ = (cfg_.model == "ou");
+  // 各合约的初始价：在中枢附近对数正态分布
+  inst_.resize(names_.size());
+  for (auto& in : inst_) {
+    in.x = std::log(std::max(cfg_.tick_size * 10, cfg_.price)) + 0.3 * normal();
+    in.x0 = in.x;
+    in.last_ms = 0.0;
+  }
+  if (cfg_.zipf > 0.0 && names_.size() > 1) {
+    cum_.resize(names_.size());
+    double acc = 0.0;
+    for (size_t i = 0; i < names_.size(); ++i) {
+      acc += 1.0 / std::pow(static_cast<double>(i + 1), cfg_.zipf);
+      cum_[i] = acc;
+    }
+  }
+}
+
+std::vector<std::string> SyntheticTickGenerator::default_names(int n) {
+  std::vector<std::string> v;
+  v.reserve(static_cast<size_t>(n));
+  char buf[16];
+  for (int i = 0; i < n; ++i) {
+    std::snprintf(buf, sizeof(buf), "SYN%04d", i);
+    v.emplace_back(buf);
+  }
+  return v;
+}
+
+// xoshiro256**
+uint64_t SyntheticTickGenerator::next_u64() {
+  const uint64_t r = rotl(s_[1] * 5, 7) * 9;
+  const uint64_t t = s_[1] << 17;
+  s_[2] ^= s_[0];
+  s_[3] ^= s_[1];
+  s_[1] ^= s_[2];
+  s_[0] ^= s_[3];
+  s_[2] ^= t;
+  s_[3] = rotl(s_[3], 45);
+  return r;
+}
+
+double SyntheticTickGenerator::uniform() {
+  return (static_cast<double>(next_u64() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// 极坐标法，成对产生
+double SyntheticTickGenerator::normal() {
+  if (has_spare_) { has_spare_ = false; return spare_; }
+  double u, v, s;
+  do {
+    u = 2.0 * uniform() - 1.0;
+    v = 2.0 * uniform() - 1.0;
+    s = u * u + v * v;
+  } while (s >= 1.0 || s == 0.0);
+  double m = std::sqrt(-2.0 * std::log(s) / s);
+  spare_ = v * m;
+  has_spare_ = true;
+  return u * m;
+}
+
+uint32_t SyntheticTickGenerator::pick_instrument() {
+  // 爆发态中一半的成交集中在触发爆发的合约上
+  if (burst_ && uniform() < 0.5) return hot_;
+  if (cum_.empty()) return static_cast<uint32_t>(next_u64() % names_.size());
+  double u = uniform() * cum_.back();
+  auto it = std::lower_bound(cum_.begin(), cum_.end(), u);
+  return static_cast<uint32_t>(std::min<size_t>(it - cum_.begin(), names_.size() - 1));
+}
+
+void SyntheticTickGenerator::next(TickRecord* out) {
+  // 到达过程：两态马尔可夫切换，态内指数间隔
+  if (burst_) {
+    if (uniform() * cfg_.burst_len < 1.0) burst_ = false;
+  } else if (uniform() < cfg_.burst_prob) {
+    burst_ = true;
+    hot_ = pick_instrument();
+  }
+  const double rate_per_ms = cfg_.rate * (burst_ ? cfg_.burst_factor : 1.0) / 1000.0;
+  t_ms_ += expo() / rate_per_ms;
+
+  const uint32_t k = pick_instrument();
+  Inst& in = inst_[k];
+  const double dt = std::max(0.0, t_ms_ - in.last_ms);
+  in.last_ms = t_ms_;
+  const double z = normal();
+  if (ou_) {
+    in.x += ou_kappa_ * (in.x0 - in.x) * dt + std::sqrt(var_per_ms_ * dt) * z;
+  } else {
+    in.x += -0.5 * var_per_ms_ * dt + std::sqrt(var_per_ms_ * dt) * z;
+  }
+
+  const double tick = cfg_.tick_size;
+  const double mid = std::exp(in.x);
+  const double bid_ticks = std::max(1.0, std::floor(mid / tick));
+  // 价差（跳数）几何分布：平静态多为1跳，爆发态更宽
+  int spread = 1;
+  const double widen = burst_ ? 0.5 : 0.15;
+  while (spread < 20 && uniform() < widen) ++spread;
+  out->ts_ms = cfg_.start_ms + static_cast<int64_t>(t_ms_);
+  out->inst = static_cast<int32_t>(k);
+  out->bid = bid_ticks * tick;
+  out->ask = (bid_ticks + spread) * tick;
+  out->last = uniform() < 0.5 ? out->bid : out->ask;
+  // 盘口量与成交量：指数分布，爆发态盘口更薄、成交更大
+  const double depth = burst_ ? 8.0 : 30.0;
+  const double size = burst_ ? 6.0 : 2.0;
+  out->bid_volume = 1 + static_cast<int32_t>(expo() * depth);
+  out->ask_volume = 1 + static_cast<int32_t>(expo() * depth);
+  out->volume = 1 + static_cast<int32_t>(expo() * size);
+}
+
+SyntheticMarketData::SyntheticMarketData(SyntheticConfig cfg) : cfg_(std::move(cfg)) {}
+
+void SyntheticMarketData::set_replay_clock(double speed, int64_t max_gap_ms) {
+  clock_.reset(new ReplayClock(speed, max_gap_ms));
+}
+
+SyntheticMarketData::~SyntheticMarketData() { stop(); }
+
+void SyntheticMarketData::stop() {
+  running_.store(false);
+  if (worker_.joinable()) worker_.join();
+}
+
+bool SyntheticMarketData::connect(const std::string& front) {
+  std::cout << "[SynthMD] model=" << cfg_.model << " rate=" << cfg_.rate << "/s seed=" << cfg_.seed << std::endl;
+  return true;
+}
+
+bool SyntheticMarketData::login(const std::string& broker_id, const std::string& user_id, const std::string& password) {
+  std::cout << "[SynthMD] Login (noop)" << std::endl;
+  return true;
+}
+
+int64_t SyntheticMarketData::replay_start_ms() {
+  return cfg_.start_ms > 0 ? cfg_.start_ms : parse_datetime_ms(kDefaultStart);
+}
+
+bool SyntheticMarketData::subscribe(const std::vector<std::string>& instruments) {
+  gen_.reset(new SyntheticTickGenerator(cfg_, instruments));
+  std::cout << "[SynthMD] instruments=" << gen_->instruments().size() << std::endl;
+  running_.store(true);
+  worker_ = std::thread([this] {
+    run_loop();
+    done_.store(true, std::memory_order_release);
+  });
+  return true;
+}
+
+void SyntheticMarketData::set_market_data_handler(MarketDataHandler handler) {
+  handler_ = std::move(handler);
+}
+
+void SyntheticMarketData::run_loop() {
+  ThreadManager::instance().enter(ThreadRole::Feed);
+  TickStoreWriter store;
+  if (!store_path_.empty() && !store.open(store_path_, gen_->instruments())) {
+    std::cerr << "[SynthMD] cannot write tick store " << store_path_ << std::endl;
+  }
+  const auto& names = gen_->instruments();
+  DatetimeFormatter fmt;
+  // 复用同一事件对象：字符串沿用已有容量，稳态下不分配
+  MarketDataEvent ev;
+  TickRecord r;
+  uint64_t n = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  while (running_.load(std::memory_order_relaxed) && (cfg_.events == 0 || n < cfg_.events)) {
+    gen_->next(&r);
+    if (clock_) clock_->wait_until_event(r.ts_ms);
+    ev.instrument.assign(names[static_cast<size_t>(r.inst)]);
+    fmt.format(r.ts_ms, &ev.update_time);
+    ev.last_price = r.last;
+    ev.bid_price = r.bid;
+    ev.ask_price = r.ask;
+    ev.volume = r.volume;
+    ev.bid_volume = r.bid_volume;
+    ev.ask_volume = r.ask_volume;
+    if (handler_) handler_(ev);
+    if (store.is_open()) store.append(r);
+    ++n;
+  }
+  if (store.is_open()) {
+    uint64_t stored = store.count();
+    if (store.close()) std::cout << "[SynthMD] wrote " << stored << " ticks to " << store_path_ << std::endl;
+    else std::cerr << "[SynthMD] tick store write failed: " << store_path_ << std::endl;
+  }
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  std::cout << "[SynthMD] generated " << n << " ticks in " << sec << "s ("
+            << static_cast<uint64_t>(sec > 0 ? n / sec : 0) << "/s)" << std::endl;
+  running_.store(false);
+}
+
+} // namespace ts
@@ -1,36 +1,51 @@
 #include "TradingSystem/BarAggregator.h"
+#include "TradingSystem/SessionCalendar.h"
+#include "TradingSystem/TimeUtil.h"
+#include <chrono>
 #include <iomanip>
 #include <sstream>
 
 namespace ts {
 
-BarAggregator::BarAggregator(int interval_seconds) : interval_(interval_seconds > 0 ? interval_seconds : 1) {}
+BarAggregator::BarAggregator(int interval_seconds, const SessionCalendar* sessions)
+    : interval_(interval_seconds > 0 ? interval_seconds : 1), calendar_(sessions) {}
 
 void BarAggregator::set_bar_handler(BarHandler h) { handler_ = std::move(h); }
 
 void BarAggregator::on_tick(const MarketDataEvent& md) {
-  auto now = std::chrono::steady_clock::now();
   auto it = acc_.find(md.instrument);
   if (it == acc_.end()) {
     Accum a;
-    a.start = now;
     a.bar.instrument = md.instrument;
-    a.bar.open = a.bar.high = a.bar.low = a.bar.close = md.last_price;
-    a.bar.volume = md.volume;
-    a.bar.ts = now_string();
-    acc_.emplace(md.instrument, a);
-    return;
+    if (calendar_) a.sessions = calendar_->find(md.instrument);
+    it = acc_.emplace(md.instrument, std::move(a)).first;
   }
   auto& a = it->second;
-  auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - a.start).count();
-  if (elapsed >= interval_) {
-    if (handler_) handler_(a.bar);
-    a.start = now;
-    a.bar.instrument = md.instrument;
+  const int64_t interval_ms = static_cast<int64_t>(interval_) * kMsPerSecond;
+  int64_t ms = parse_datetime_ms(md.update_time);
+  const bool event_time = (ms >= 0);
+  int64_t start = -1;
+  if (event_time) {
+    if (a.sessions) {
+      start = a.sessions->bar_start_ms(ms, interval_);
+      if (start < 0) return; // 休市时段的行情不计入Bar
+    } else {
+      start = ms - ms % interval_ms;
+    }
+  } else {
+    ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch()).count();
+    start = ms - ms % interval_ms;
+  }
+
+  if (a.start_ms < 0 || start > a.start_ms) {
+    if (a.start_ms >= 0 && handler_) handler_(a.bar);
+    a.start_ms = start;
     a.bar.open = a.bar.high = a.bar.low = a.bar.close = md.last_price;
     a.bar.volume = md.volume;
-    a.bar.ts = now_string();
+    a.bar.ts = event_time ? format_datetime_ms(start) : now_string();
   } else {
+    // 同一周期（或乱序的更早行情）并入当前Bar
     a.bar.close = md.last_price;
     if (md.last_price > a.bar.high) a.bar.high = md.last_price;
     if (md.last_price < a.bar.low) a.bar.low = md.last_price;
@@ -40,7 +55,9 @@ void BarAggregator::on_tick(const MarketDataEvent& md) {
 
 void BarAggregator::flush_all() {
   if (!handler_) return;
-  for (auto& kv : acc_) handler_(kv.second.bar);
+  for (auto& kv : acc_) {
+    if (kv.second.start_ms >= 0) handler_(kv.second.bar);
+  }
 }
 
 std::string BarAggregator::now_string() {
@@ -0,0 +1,388 @@
+#include "TradingSystem/BarBuilder.h"
+#include "TradingSystem/SessionCalendar.h"
+#include "TradingSystem/TimeUtil.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace ts {
+namespace {
+
+constexpr char kMagic[8] = {'T', 'S', 'B', 'A', 'R', 'S', '1', '\0'};
+constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  int32_t interval_sec;
+  uint64_t source_size;
+  int64_t source_mtime;
+  uint32_t instrument_count;
+  uint32_t reserved;
+};
+
+struct FileIndex {
+  char name[32];
+  uint64_t offset;  // 以BarRecord为单位
+  uint64_t count;
+};
+
+// ---- 向量化核：价格min/max、成交量求和 ----
+void minmax_f64(const double* p, size_t n, double* mn, double* mx) {
+  double lo = p[0], hi = p[0];
+  size_t i = 0;
+#if defined(__AVX2__)
+  if (n >= 4) {
+    __m256d vlo = _mm256_loadu_pd(p), vhi = vlo;
+    for (i = 4; i + 4 <= n; i += 4) {
+      __m256d v = _mm256_loadu_pd(p + i);
+      vlo = _mm256_min_pd(vlo, v);
+      vhi = _mm256_max_pd(vhi, v);
+    }
+    alignas(32) double a[4], b[4];
+    _mm256_store_pd(a, vlo);
+    _mm256_store_pd(b, vhi);
+    for (int k = 0; k < 4; ++k) { lo = std::min(lo, a[k]); hi = std::max(hi, b[k]); }
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  if (n >= 2) {
+    __m128d vlo = _mm_loadu_pd(p), vhi = vlo;
+    for (i = 2; i + 2 <= n; i += 2) {
+      __m128d v = _mm_loadu_pd(p + i);
+      vlo = _mm_min_pd(vlo, v);
+      vhi = _mm_max_pd(vhi, v);
+    }
+    alignas(16) double a[2], b[2];
+    _mm_store_pd(a, vlo);
+    _mm_store_pd(b, vhi);
+    lo = std::min(lo, std::min(a[0], a[1]));
+    hi = std::max(hi, std::max(b[0], b[1]));
+  }
+#endif
+  for (; i < n; ++i) { lo = std::min(lo, p[i]); hi = std::max(hi, p[i]); }
+  *mn = lo;
+  *mx = hi;
+}
+
+int64_t sum_i64(const int64_t* p, size_t n) {
+  size_t i = 0;
+  int64_t s = 0;
+#if defined(__AVX2__)
+  __m256i acc = _mm256_setzero_si256();
+  for (; i + 4 <= n; i += 4) acc = _mm256_add_epi64(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+  alignas(32) int64_t a[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(a), acc);
+  s = a[0] + a[1] + a[2] + a[3];
+#elif defined(__SSE2__) || defined(_M_X64)
+  __m128i acc = _mm_setzero_si128();
+  for (; i + 2 <= n; i += 2) acc = _mm_add_epi64(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+  alignas(16) int64_t a[2];
+  _mm_store_si128(reinterpret_cast<__m128i*>(a), acc);
+  s = a[0] + a[1];
+#endif
+  for (; i < n; ++i) s += p[i];
+  return s;
+}
+
+// 单合约连续列（按时间有序）
+struct InstColumns {
+  std::vector<int64_t> ts;
+  std::vector<double> px;
+  std::vector<int64_t> vol;
+};
+
+std::vector<InstColumns> group_by_instrument(const TickColumns& t) {
+  std::vector<InstColumns> g(t.instruments.size());
+  std::vector<size_t> counts(t.instruments.size(), 0);
+  for (int32_t id : t.inst) ++counts[id];
+  for (size_t k = 0; k < g.size(); ++k) {
+    g[k].ts.reserve(counts[k]);
+    g[k].px.reserve(counts[k]);
+    g[k].vol.reserve(counts[k]);
+  }
+  for (size_t i = 0; i < t.size(); ++i) {
+    auto& c = g[t.inst[i]];
+    c.ts.push_back(t.ts_ms[i]);
+    c.px.push_back(t.price[i]);
+    c.vol.push_back(t.volume[i]);
+  }
+  // 源数据若有乱序则按时间稳定排序
+  for (auto& c : g) {
+    if (std::is_sorted(c.ts.begin(), c.ts.end())) continue;
+    std::vector<size_t> idx(c.ts.size());
+    std::iota(idx.begin(), idx.end(), 0);
+    std::stable_sort(idx.begin(), idx.end(), [&](size_t a, size_t b) { return c.ts[a] < c.ts[b]; });
+    InstColumns s;
+    s.ts.reserve(idx.size()); s.px.reserve(idx.size()); s.vol.reserve(idx.size());
+    for (size_t j : idx) { s.ts.push_back(c.ts[j]); s.px.push_back(c.px[j]); s.vol.push_back(c.vol[j]); }
+    c = std::move(s);
+  }
+  return g;
+}
+
+// [i, j)区间的Tick汇成一根Bar
+BarRecord make_bar(const InstColumns& c, size_t i, size_t j, int64_t start) {
+  BarRecord b;
+  b.ts_ms = start;
+  b.open = c.px[i];
+  b.close = c.px[j - 1];
+  minmax_f64(c.px.data() + i, j - i, &b.low, &b.high);
+  b.volume = sum_i64(c.vol.data() + i, j - i);
+  return b;
+}
+
+std::vector<BarRecord> bars_for(const InstColumns& c, int interval_sec) {
+  const int64_t interval_ms = std::max(1, interval_sec) * kMsPerSecond;
+  std::vector<BarRecord> out;
+  size_t n = c.ts.size();
+  size_t i = 0;
+  while (i < n) {
+    int64_t start = c.ts[i] - ((c.ts[i] % interval_ms) + interval_ms) % interval_ms;
+    size_t j = static_cast<size_t>(std::lower_bound(c.ts.begin() + i, c.ts.end(), start + interval_ms) - c.ts.begin());
+    out.push_back(make_bar(c, i, j, start));
+    i = j;
+  }
+  return out;
+}
+
+// 按时段对齐：先滤掉休市Tick并求各Tick的Bar起点（时间有序时起点单调），再按相同起点分段
+std::vector<BarRecord> bars_for(const InstColumns& c, int interval_sec, const TradingSessions& ss) {
+  InstColumns f;
+  std::vector<int64_t> starts;
+  f.ts.reserve(c.ts.size()); f.px.reserve(c.ts.size()); f.vol.reserve(c.ts.size()); starts.reserve(c.ts.size());
+  for (size_t i = 0; i < c.ts.size(); ++i) {
+    const int64_t s = ss.bar_start_ms(c.ts[i], interval_sec);
+    if (s < 0) continue;
+    f.ts.push_back(c.ts[i]); f.px.push_back(c.px[i]); f.vol.push_back(c.vol[i]);
+    starts.push_back(s);
+  }
+  std::vector<BarRecord> out;
+  size_t n = starts.size();
+  size_t i = 0;
+  while (i < n) {
+    size_t j = i + 1;
+    while (j < n && starts[j] == starts[i]) ++j;
+    out.push_back(make_bar(f, i, j, starts[i]));
+    i = j;
+  }
+  return out;
+}
+
+template <class T>
+bool parse_num(std::string_view s, T* out) {
+  while (!s.empty() && s.front() == ' ') s.remove_prefix(1);
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\r')) s.remove_suffix(1);
+  auto r = std::from_chars(s.data(), s.data() + s.size(), *out);
+  return r.ec == std::errc() && r.ptr == s.data() + s.size();
+}
+
+bool source_stamp(const std::string& path, uint64_t* size, int64_t* mtime) {
+  std::error_code ec;
+  auto sz = std::filesystem::file_size(path, ec);
+  if (ec) return false;
+  auto mt = std::filesystem::last_write_time(path, ec);
+  if (ec) return false;
+  *size = static_cast<uint64_t>(sz);
+  *mtime = static_cast<int64_t>(mt.time_since_epoch().count());
+  return true;
+}
+
+} // namespace
+
+bool load_tick_columns(const std::string& csv_path, TickColumns* out, std::string* err) {
+  MappedFile mf;
+  if (!mf.open(csv_path)) {
+    if (err) *err = "cannot open " + csv_path;
+    return false;
+  }
+  *out = TickColumns{};
+  std::unordered_map<std::string_view, int32_t> ids;
+  std::string_view all(mf.data(), mf.size());
+  // 粗估行数以减少扩容
+  size_t est = all.size() / 48 + 1;
+  out->inst.reserve(est); out->ts_ms.reserve(est); out->price.reserve(est); out->volume.reserve(est);
+  std::string_view cols[16];
+  size_t pos = 0;
+  while (pos < all.size()) {
+    size_t eol = all.find('\n', pos);
+    if (eol == std::string_view::npos) eol = all.size();
+    std::string_view line = all.substr(pos, eol - pos);
+    pos = eol + 1;
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    if (line.empty()) continue;
+    size_t nc = 0, b = 0;
+    while (nc < 16) {
+      size_t c = line.find(',', b);
+      cols[nc++] = line.substr(b, c == std::string_view::npos ? std::string_view::npos : c - b);
+      if (c == std::string_view::npos) break;
+      b = c + 1;
+    }
+    if (nc < 3) continue;
+    int64_t ts = -1;
+    double px = 0.0, vol_d = 0.0;
+    int64_t vol = 0;
+    if (nc >= 8 && (ts = parse_datetime_ms(cols[1])) >= 0) {
+      if (!parse_num(cols[2], &px)) continue;
+      if (!parse_num(cols[7], &vol)) { if (!parse_num(cols[7], &vol_d)) continue; vol = static_cast<int64_t>(vol_d); }
+    } else {
+      // 格式1的时间戳位于第6列；另兼容 instrument,last_price,volume,datetime
+      if (nc >= 6) ts = parse_datetime_ms(cols[5]);
+      if (ts < 0 && nc == 4) ts = parse_datetime_ms(cols[3]);
+      if (ts < 0) continue;  // 无时间戳无法分Bar
+      if (!parse_num(cols[1], &px)) continue;
+      if (!parse_num(cols[2], &vol)) { if (!parse_num(cols[2], &vol_d)) continue; vol = static_cast<int64_t>(vol_d); }
+    }
+    auto it = ids.find(cols[0]);
+    int32_t id;
+    if (it == ids.end()) {
+      id = static_cast<int32_t>(out->instruments.size());
+      out->instruments.emplace_back(cols[0]);
+      ids.emplace(cols[0], id);
+    } else {
+      id = it->second;
+    }
+    out->inst.push_back(id);
+    out->ts_ms.push_back(ts);
+    out->price.push_back(px);
+    out->volume.push_back(vol);
+  }
+  return true;
+}
+
+BarSeries build_bars(const TickColumns& ticks, int interval_sec, const SessionCalendar* calendar) {
+  return std::move(build_bars(ticks, std::vector<int>{interval_sec}, calendar).front());
+}
+
+std::vector<BarSeries> build_bars(const TickColumns& ticks, const std::vector<int>& intervals_sec,
+                                  const SessionCalendar* calendar) {
+  auto groups = group_by_instrument(ticks);
+  std::vector<const TradingSessions*> sessions(groups.size(), nullptr);
+  if (calendar) {
+    for (size_t k = 0; k < groups.size(); ++k) sessions[k] = calendar->find(ticks.instruments[k]);
+  }
+  std::vector<BarSeries> out;
+  out.reserve(intervals_sec.size());
+  for (int sec : intervals_sec) {
+    BarSeries s(groups.size());
+    for (size_t k = 0; k < groups.size(); ++k) {
+      s[k] = sessions[k] ? bars_for(groups[k], std::max(1, sec), *sessions[k]) : bars_for(groups[k], sec);
+    }
+    out.push_back(std::move(s));
+  }
+  return out;
+}
+
+std::string bar_cache_path(const std::string& cache_dir, const std::string& source_path, int interval_sec,
+                           const SessionCalendar* calendar) {
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  std::string abs = fs::absolute(source_path, ec).lexically_normal().string();
+  // FNV-1a 64位
+  uint64_t h = 1469598103934665603ULL;
+  for (unsigned char c : abs) { h ^= c; h *= 1099511628211ULL; }
+  char hex[17];
+  std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(h));
+  std::string stem = fs::path(source_path).stem().string();
+  std::string name = stem + "." + hex + "." + std::to_string(interval_sec) + "s";
+  if (calendar && !calendar->empty()) {
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(calendar->fingerprint()));
+    name += std::string(".s") + hex;
+  }
+  return (fs::path(cache_dir) / (name + ".bars")).string();
+}
+
+bool write_bar_file(const std::string& path, const std::string& source_path, int interval_sec,
+                    const std::vector<std::string>& instruments, const BarSeries& bars) {
+  FileHeader hdr{};
+  std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
+  hdr.version = kVersion;
+  hdr.interval_sec = interval_sec;
+  if (!source_stamp(source_path, &hdr.source_size, &hdr.source_mtime)) return false;
+  hdr.instrument_count = static_cast<uint32_t>(instruments.size());
+  std::vector<FileIndex> index(instruments.size());
+  uint64_t offset = 0;
+  for (size_t i = 0; i < instruments.size(); ++i) {
+    std::strncpy(index[i].name, instruments[i].c_str(), sizeof(index[i].name) - 1);
+    index[i].offset = offset;
+    index[i].count = bars[i].size();
+    offset += bars[i].size();
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+  // 先写临时文件再改名，避免并发读到半成品
+  std::string tmp = path + ".tmp";
+  {
+    std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+    if (!ofs) return false;
+    ofs.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    ofs.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(FileIndex)));
+    for (const auto& v : bars) {
+      ofs.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(BarRecord)));
+    }
+    if (!ofs) return false;
+  }
+  std::filesystem::rename(tmp, path, ec);
+  return !ec;
+}
+
+bool BarFile::open(const std::string& path, const std::string& source_path) {
+  if (!file_.open(path) || file_.size() < sizeof(FileHeader)) return false;
+  FileHeader hdr;
+  std::memcpy(&hdr, file_.data(), sizeof(hdr));
+  if (std::memcmp(hdr.magic, kMagic, sizeof(kMagic)) != 0 || hdr.version != kVersion) return false;
+  if (!source_path.empty()) {
+    uint64_t sz; int64_t mt;
+    if (!source_stamp(source_path, &sz, &mt) || sz != hdr.source_size || mt != hdr.source_mtime) return false;
+  }
+  size_t need = sizeof(FileHeader) + hdr.instrument_count * sizeof(FileIndex);
+  if (file_.size() < need) return false;
+  interval_sec_ = hdr.interval_sec;
+  count_ = hdr.instrument_count;
+  const auto* idx = reinterpret_cast<const FileIndex*>(file_.data() + sizeof(FileHeader));
+  const auto& last = idx[count_ ? count_ - 1 : 0];
+  if (count_ && file_.size() < need + (last.offset + last.count) * sizeof(BarRecord)) return false;
+  return true;
+}
+
+std::string BarFile::instrument(size_t i) const {
+  const auto* idx = reinterpret_cast<const FileIndex*>(file_.data() + sizeof(FileHeader));
+  return std::string(idx[i].name, strnlen(idx[i].name, sizeof(idx[i].name)));
+}
+
+const BarRecord* BarFile::bars(size_t i, size_t* n) const {
+  const auto* idx = reinterpret_cast<const FileIndex*>(file_.data() + sizeof(FileHeader));
+  const auto* base = reinterpret_cast<const BarRecord*>(file_.data() + sizeof(FileHeader) + count_ * sizeof(FileIndex));
+  if (n) *n = static_cast<size_t>(idx[i].count);
+  return base + idx[i].offset;
+}
+
+bool ensure_bar_cache(const std::string& cache_dir, const std::string& source_path, int interval_sec,
+                      BarFile* out, std::string* err, const SessionCalendar* calendar) {
+  std::string path = bar_cache_path(cache_dir, source_path, interval_sec, calendar);
+  if (out->open(path, source_path)) return true;
+  TickColumns cols;
+  if (!load_tick_columns(source_path, &cols, err)) return false;
+  BarSeries bars = build_bars(cols, interval_sec, calendar);
+  if (!write_bar_file(path, source_path, interval_sec, cols.instruments, bars)) {
+    if (err) *err = "cannot write bar cache " + path;
+    return false;
+  }
+  if (!out->open(path, source_path)) {
+    if (err) *err = "cannot reopen bar cache " + path;
+    return false;
+  }
+  return true;
+}
+
+} // namespace ts
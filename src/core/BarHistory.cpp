@@ -0,0 +1,136 @@
+#include "TradingSystem/BarHistory.h"
+#include "TradingSystem/TimeUtil.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace ts {
+
+namespace {
+constexpr char kMagic[8] = {'T', 'S', 'B', 'H', 'I', 'S', '1', '\0'};
+constexpr size_t kInitialBars = 1024;
+
+struct HistHeader {
+  char magic[8];
+  int32_t interval_sec;
+  uint32_t reserved;
+  uint64_t count;  // 已提交的Bar数，追加后回填
+};
+
+std::string suffix_of(int interval_sec) { return "." + std::to_string(interval_sec) + "s.hist"; }
+} // namespace
+
+BarHistory::BarHistory(std::string dir, int interval_sec) : dir_(std::move(dir)), interval_sec_(interval_sec) {
+  std::error_code ec;
+  std::filesystem::create_directories(dir_, ec);
+  if (ec) std::cerr << "[BarHistory] cannot create " << dir_ << ": " << ec.message() << std::endl;
+}
+
+BarHistory::~BarHistory() { close(); }
+
+std::string BarHistory::path_of(const std::string& instrument) const {
+  return (std::filesystem::path(dir_) / (instrument + suffix_of(interval_sec_))).string();
+}
+
+std::vector<std::string> BarHistory::instruments() const {
+  std::vector<std::string> out;
+  const std::string suffix = suffix_of(interval_sec_);
+  std::error_code ec;
+  for (const auto& e : std::filesystem::directory_iterator(dir_, ec)) {
+    const std::string name = e.path().filename().string();
+    if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+      out.push_back(name.substr(0, name.size() - suffix.size()));
+    }
+  }
+  return out;
+}
+
+const BarRecord* BarHistory::load(const std::string& instrument, size_t* n, int64_t end_ms) {
+  *n = 0;
+  auto it = readers_.find(instrument);
+  if (it == readers_.end()) {
+    MappedFile f;
+    if (!f.open(path_of(instrument))) return nullptr;
+    it = readers_.emplace(instrument, std::move(f)).first;
+  }
+  const MappedFile& f = it->second;
+  if (f.size() < sizeof(HistHeader)) return nullptr;
+  HistHeader hdr;
+  std::memcpy(&hdr, f.data(), sizeof(hdr));
+  if (std::memcmp(hdr.magic, kMagic, sizeof(kMagic)) != 0 || hdr.interval_sec != interval_sec_) return nullptr;
+  // 以提交笔数为准，预留未写的尾部不计入
+  const uint64_t fit = (f.size() - sizeof(HistHeader)) / sizeof(BarRecord);
+  const size_t count = static_cast<size_t>(hdr.count < fit ? hdr.count : fit);
+  const auto* bars = reinterpret_cast<const BarRecord*>(f.data() + sizeof(HistHeader));
+  // 时间升序，二分找出截止前的部分
+  const int64_t last_start = end_ms == INT64_MAX ? INT64_MAX : end_ms - interval_sec_ * kMsPerSecond;
+  *n = static_cast<size_t>(
+      std::partition_point(bars, bars + count, [last_start](const BarRecord& b) { return b.ts_ms <= last_start; }) - bars);
+  return bars;
+}
+
+void BarHistory::close_readers() { readers_.clear(); }
+
+BarHistory::Writer* BarHistory::writer(const std::string& instrument) {
+  auto it = writers_.find(instrument);
+  if (it != writers_.end()) return it->second.get();
+  auto w = std::make_unique<Writer>();
+  const std::string path = path_of(instrument);
+  std::error_code ec;
+  const auto before = std::filesystem::file_size(path, ec);
+  if (!w->file.open(path, sizeof(HistHeader) + kInitialBars * sizeof(BarRecord), true)) {
+    std::cerr << "[BarHistory] cannot open " << path << std::endl;
+    w->failed = true;
+  } else {
+    auto* hdr = reinterpret_cast<HistHeader*>(w->file.data());
+    if (hdr->magic[0] == '\0') {
+      // 新文件（扩展部分为0）
+      std::memcpy(hdr->magic, kMagic, sizeof(kMagic));
+      hdr->interval_sec = interval_sec_;
+      hdr->count = 0;
+    } else if (std::memcmp(hdr->magic, kMagic, sizeof(kMagic)) != 0 || hdr->interval_sec != interval_sec_) {
+      // 不是本格式或周期不符：恢复原长度后不再写入
+      std::cerr << "[BarHistory] unrecognized file " << path << ", not appending" << std::endl;
+      w->file.close(ec ? 0 : static_cast<size_t>(before));
+      w->failed = true;
+    }
+    if (!w->failed) {
+      const uint64_t fit = (w->file.capacity() - sizeof(HistHeader)) / sizeof(BarRecord);
+      w->count = hdr->count < fit ? hdr->count : fit;
+      if (w->count > 0) {
+        const auto* recs = reinterpret_cast<const BarRecord*>(w->file.data() + sizeof(HistHeader));
+        w->last_ts = recs[w->count - 1].ts_ms;
+      }
+    }
+  }
+  return writers_.emplace(instrument, std::move(w)).first->second.get();
+}
+
+bool BarHistory::append(const std::string& instrument, const BarRecord& bar) {
+  Writer* w = writer(instrument);
+  if (w->failed || bar.ts_ms <= w->last_ts) return false;
+  const size_t need = sizeof(HistHeader) + (w->count + 1) * sizeof(BarRecord);
+  if (!w->file.reserve(need)) {
+    std::cerr << "[BarHistory] cannot grow " << path_of(instrument) << std::endl;
+    w->failed = true;
+    return false;
+  }
+  char* base = w->file.data();
+  std::memcpy(base + sizeof(HistHeader) + w->count * sizeof(BarRecord), &bar, sizeof(BarRecord));
+  reinterpret_cast<HistHeader*>(base)->count = ++w->count;
+  w->last_ts = bar.ts_ms;
+  return true;
+}
+
+void BarHistory::close() {
+  readers_.clear();
+  for (auto& kv : writers_) {
+    Writer& w = *kv.second;
+    // 扩展失败时映射已释放而文件仍打开，同样截断关闭；已关闭的再次调用无副作用
+    w.file.close(sizeof(HistHeader) + w.count * sizeof(BarRecord));
+  }
+  writers_.clear();
+}
+
+} // namespace ts
@@ -0,0 +1,278 @@
+#include "TradingSystem/CoStrategy.h"
+#include "TradingSystem/ITrader.h"
+
+namespace ts {
+
+CoStrategyBase::CoStrategyBase(size_t capacity) : slots_(capacity, nullptr) {
+  free_.reserve(capacity);
+  for (size_t i = capacity; i > 0; --i) free_.push_back(static_cast<uint32_t>(i - 1));
+  ready_.reserve(capacity * 2);
+  early_.resize(4);
+  inbox_.reserve(64);
+  inbox_work_.reserve(64);
+}
+
+int CoStrategyBase::acquire_slot() {
+  if (free_.empty()) return -1;
+  const uint32_t slot = free_.back();
+  free_.pop_back();
+  ++active_;
+  return static_cast<int>(slot);
+}
+
+void CoStrategyBase::enter() {
+  if (dispatch_tid_.load(std::memory_order_relaxed) != std::this_thread::get_id()) {
+    dispatch_tid_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+  }
+  if (inbox_pending_.load(std::memory_order_acquire)) drain_inbox();
+}
+
+void CoStrategyBase::drain_inbox() {
+  {
+    std::lock_guard<std::mutex> lk(inbox_mu_);
+    inbox_work_.swap(inbox_);
+    inbox_pending_.store(false, std::memory_order_relaxed);
+  }
+  for (const auto& ev : inbox_work_) handle_order(ev);
+  inbox_work_.clear();
+  run_ready();
+}
+
+void CoStrategyBase::on_start(ITrader* trader) {
+  trader_ = trader;
+  enter();
+  on_co_start();
+  run_ready();
+}
+
+void CoStrategyBase::on_stop(ITrader* trader) {
+  (void)trader;
+  enter();
+  on_co_stop();
+  // 未结束的协程不再恢复
+  for (CoFrame* f : slots_) {
+    if (f->active && f->timer_id && timers()) timers()->cancel_timer(f->timer_id);
+  }
+}
+
+void CoStrategyBase::on_market_data(const MarketDataEvent& md, ITrader* trader) {
+  (void)trader;
+  enter();
+  if (tick_waiters_ > 0) {
+    for (CoFrame* f : slots_) {
+      if (f->active && f->wait == CoFrame::Wait::Tick && (f->instrument.empty() || f->instrument == md.instrument)) {
+        f->tick = &md;
+        wake(*f);
+      }
+    }
+    run_ready();
+  }
+  on_co_tick(md);
+  run_ready();
+}
+
+void CoStrategyBase::on_bar(const BarEvent& bar, ITrader* trader) {
+  (void)trader;
+  enter();
+  if (bar_waiters_ > 0) {
+    for (CoFrame* f : slots_) {
+      if (f->active && f->wait == CoFrame::Wait::Bar && (f->instrument.empty() || f->instrument == bar.instrument) &&
+          --f->bars_left <= 0) {
+        f->bar = &bar;
+        wake(*f);
+      }
+    }
+    run_ready();
+  }
+  on_co_bar(bar);
+  run_ready();
+}
+
+void CoStrategyBase::on_order_status(const OrderStatusEvent& ev) {
+  // 非派发线程（实盘回报线程）：入收件箱，由定时器在派发线程上处理
+  if (dispatch_tid_.load(std::memory_order_relaxed) != std::this_thread::get_id()) {
+    bool first = false;
+    {
+      std::lock_guard<std::mutex> lk(inbox_mu_);
+      inbox_.push_back(ev);
+      first = !inbox_pending_.exchange(true, std::memory_order_release);
+    }
+    if (first && timers()) timers()->schedule_timer(1, 0, kInboxTimer);
+    return;
+  }
+  handle_order(ev);
+  run_ready();
+}
+
+void CoStrategyBase::on_timer(uint64_t timer_id, uint64_t user_data, ITrader* trader) {
+  (void)trader;
+  enter();
+  if (user_data == kInboxTimer) return;
+  if (user_data & kFrameTimer) {
+    const size_t slot = static_cast<size_t>(user_data & ~kFrameTimer);
+    if (slot < slots_.size()) {
+      CoFrame& f = *slots_[slot];
+      if (f.active && f.timer_id == timer_id && f.wait != CoFrame::Wait::None) {
+        f.timer_id = 0;
+        f.timed_out = true;
+        wake(f);
+        run_ready();
+      }
+    }
+    return;
+  }
+  on_co_timer(timer_id, user_data);
+  run_ready();
+}
+
+void CoStrategyBase::handle_order(const OrderStatusEvent& ev) {
+  for (CoFrame* f : slots_) {
+    if (f->active && !f->order_id.empty() && f->order_id == ev.order_id) {
+      apply(*f, ev);
+      return;
+    }
+  }
+  // 下单调用尚未返回订单ID，先暂存
+  if (placing_) {
+    if (early_n_ == early_.size()) early_.emplace_back();
+    early_[early_n_++] = ev;
+    return;
+  }
+  on_co_order(ev);
+}
+
+void CoStrategyBase::apply(CoFrame& f, const OrderStatusEvent& ev) {
+  f.order_status.assign(ev.status);
+  if ((ev.status == "Filled" || ev.status == "PartiallyFilled") && ev.filled_qty > 0) {
+    const int total = f.filled_qty + ev.filled_qty;
+    f.avg_fill_price = (f.avg_fill_price * f.filled_qty + ev.fill_price * ev.filled_qty) / total;
+    f.filled_qty = total;
+  }
+  if (ev.status == "Filled" || ev.status == "Canceled" || ev.status == "Rejected") {
+    f.order_done = true;
+    if (f.wait == CoFrame::Wait::Order) wake(f);
+  }
+}
+
+bool CoStrategyBase::place(CoFrame& f, const OrderRequest& req) {
+  f.order_id.clear();
+  f.order_status.clear();
+  f.order_done = false;
+  f.filled_qty = 0;
+  f.avg_fill_price = 0.0;
+  std::string id;
+  if (trader_) {
+    placing_ = true;
+    early_n_ = 0;
+    id = trader_->place_order(req);
+    placing_ = false;
+  }
+  if (id.empty()) {
+    f.order_done = true;
+    f.order_status.assign("Rejected");
+  } else {
+    f.order_id = std::move(id);
+  }
+  // 暂存的回报按ID归属；其他订单的交还给钩子
+  const size_t n = early_n_;
+  early_n_ = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (!f.order_id.empty() && early_[i].order_id == f.order_id) apply(f, early_[i]);
+    else on_co_order(early_[i]);
+  }
+  return !f.order_id.empty();
+}
+
+bool CoStrategyBase::cancel(CoFrame& f) {
+  if (!trader_ || f.order_id.empty() || f.order_done) return false;
+  return trader_->cancel_order(f.order_id);
+}
+
+void CoStrategyBase::arm(CoFrame& f, int64_t timeout_ms) {
+  f.timed_out = false;
+  f.timer_id = (timeout_ms > 0 && timers()) ? timers()->schedule_timer(timeout_ms, 0, kFrameTimer | f.slot) : 0;
+}
+
+bool CoStrategyBase::await_order(CoFrame& f, int64_t timeout_ms) {
+  if (f.order_id.empty() || f.order_done) return false;
+  f.wait = CoFrame::Wait::Order;
+  arm(f, timeout_ms);
+  return true;
+}
+
+bool CoStrategyBase::await_bars(CoFrame& f, const std::string& instrument, int n) {
+  if (n <= 0) return false;
+  f.wait = CoFrame::Wait::Bar;
+  f.instrument.assign(instrument);
+  f.bars_left = n;
+  f.timed_out = false;
+  ++bar_waiters_;
+  return true;
+}
+
+bool CoStrategyBase::await_tick(CoFrame& f, const std::string& instrument, int64_t timeout_ms) {
+  f.wait = CoFrame::Wait::Tick;
+  f.instrument.assign(instrument);
+  ++tick_waiters_;
+  arm(f, timeout_ms);
+  return true;
+}
+
+bool CoStrategyBase::sleep(CoFrame& f, int64_t ms) {
+  if (ms <= 0 || !timers()) return false;
+  f.wait = CoFrame::Wait::Sleep;
+  arm(f, ms);
+  return true;
+}
+
+void CoStrategyBase::wake(CoFrame& f) {
+  if (f.wait == CoFrame::Wait::Tick) --tick_waiters_;
+  else if (f.wait == CoFrame::Wait::Bar) --bar_waiters_;
+  f.wait = CoFrame::Wait::None;
+  if (f.timer_id) {
+    if (timers()) timers()->cancel_timer(f.timer_id);
+    f.timer_id = 0;
+  }
+  if (!f.queued) {
+    f.queued = true;
+    ready_.push_back(f.slot);
+  }
+}
+
+void CoStrategyBase::start(CoFrame& f) {
+  if (!f.active || f.queued) return;
+  f.queued = true;
+  ready_.push_back(f.slot);
+  run_ready();
+}
+
+void CoStrategyBase::run_ready() {
+  // 协程执行中触发的唤醒只排队，由最外层依次恢复，不嵌套
+  if (running_) return;
+  running_ = true;
+  for (size_t i = 0; i < ready_.size(); ++i) {
+    CoFrame& f = *slots_[ready_[i]];
+    f.queued = false;
+    if (!f.active) continue;
+    resume(f);
+    f.bar = nullptr;
+    f.tick = nullptr;
+    // 结束，或未挂起就返回的协程回收
+    if (f.resume_point == -1 || f.wait == CoFrame::Wait::None) release(f);
+  }
+  ready_.clear();
+  running_ = false;
+}
+
+void CoStrategyBase::release(CoFrame& f) {
+  if (f.wait == CoFrame::Wait::Tick) --tick_waiters_;
+  else if (f.wait == CoFrame::Wait::Bar) --bar_waiters_;
+  f.wait = CoFrame::Wait::None;
+  if (f.timer_id && timers()) timers()->cancel_timer(f.timer_id);
+  f.timer_id = 0;
+  f.active = false;
+  --active_;
+  free_.push_back(f.slot);
+}
+
+} // namespace ts
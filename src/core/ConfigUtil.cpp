@@ -21,11 +21,83 @@ namespace {
   }
 }
 
-AppConfig load_app_config(const std::string& path, bool* ok) {
-  AppConfig cfg;
+bool read_text_file(const std::string& path, std::string* out) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs.good()) return false;
+  std::stringstream buf;
+  buf << ifs.rdbuf();
+  *out = buf.str();
+  return true;
+}
+
+namespace {
+  // 定位 "key" 之后冒号后的首个非空白字符
+  size_t json_value_pos(const std::string& doc, const std::string& key) {
+    std::string pat = "\"" + key + "\"";
+    size_t p = doc.find(pat);
+    if (p == std::string::npos) return p;
+    p = doc.find(':', p + pat.size());
+    if (p == std::string::npos) return p;
+    ++p;
+    while (p < doc.size() && std::isspace(static_cast<unsigned char>(doc[p]))) ++p;
+    return p < doc.size() ? p : std::string::npos;
+  }
+}
+
+bool json_number(const std::string& doc, const std::string& key, double* out) {
+  size_t p = json_value_pos(doc, key);
+  if (p == std::string::npos) return false;
+  try { *out = std::stod(doc.substr(p, 32)); }
+  catch (...) { return false; }
+  return true;
+}
+
+bool json_string_array(const std::string& doc, const std::string& key, std::vector<std::string>* out) {
+  size_t p = json_value_pos(doc, key);
+  if (p == std::string::npos || doc[p] != '[') return false;
+  size_t end = doc.find(']', p);
+  if (end == std::string::npos) return false;
+  out->clear();
+  size_t q = p;
+  while ((q = doc.find('"', q + 1)) != std::string::npos && q < end) {
+    size_t e = doc.find('"', q + 1);
+    if (e == std::string::npos || e > end) break;
+    out->push_back(doc.substr(q + 1, e - q - 1));
+    q = e;
+  }
+  return true;
+}
+
+bool json_string(const std::string& doc, const std::string& key, std::string* out) {
+  size_t p = json_value_pos(doc, key);
+  if (p == std::string::npos || doc[p] != '"') return false;
+  size_t e = doc.find('"', p + 1);
+  if (e == std::string::npos) return false;
+  *out = doc.substr(p + 1, e - p - 1);
+  return true;
+}
+
+bool json_objects(const std::string& doc, std::vector<std::string>* out) {
+  out->clear();
+  size_t p = 0;
+  while ((p = doc.find('{', p)) != std::string::npos) {
+    size_t e = doc.find('}', p);
+    if (e == std::string::npos) return false;
+    out->push_back(doc.substr(p, e - p + 1));
+    p = e + 1;
+  }
+  return !out->empty();
+}
+
+AppConfig load_app_config(const std::string& path, bool* ok, const AppConfig* base) {
+  AppConfig cfg = base ? *base : AppConfig{};
   std::ifstream ifs(path);
   if (!ifs.good()) {
     if (ok) *ok = false;
+    if (base) {
+      std::cerr << "[Config] cannot open " << path << std::endl;
+      return cfg;
+    }
     std::cerr << "[Config] cannot open " << path << ", using defaults" << std::endl;
     // 默认值；保持与示例main一致
     cfg.use_ctp = false;
@@ -39,6 +111,7 @@ AppConfig load_app_config(const std::string& path, bool* ok) {
   }
 
   if (ok) *ok = true;
+  cfg.config_path = path;
   std::string line;
   while (std::getline(ifs, line)) {
     line = trim(line);
@@ -49,6 +122,7 @@ AppConfig load_app_config(const std::string& path, bool* ok) {
     std::string val = trim(line.substr(pos + 1));
     if (key == "use_ctp") cfg.use_ctp = parse_bool(val);
     else if (key == "use_backtest") cfg.use_backtest = parse_bool(val);
+    else if (key == "use_synthetic") cfg.use_synthetic = parse_bool(val);
     else if (key == "md_front") cfg.md_front = val;
     else if (key == "td_front") cfg.td_front = val;
     else if (key == "broker_id") cfg.broker_id = val;
@@ -77,14 +151,86 @@ AppConfig load_app_config(const std::string& path, bool* ok) {
     } else if (key == "backtest_file") {
       cfg.backtest_file = val;
     } else if (key == "backtest_speed_ms") {
-      try { cfg.backtest_speed_ms = std::max(1, std::stoi(val)); }
+      try { cfg.backtest_speed_ms = std::max(0, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "replay_pacing") {
+      cfg.replay_pacing = val;
+    } else if (key == "replay_speed") {
+      try { cfg.replay_speed = std::stod(val); }
+      catch (...) { /* keep default */ }
+    } else if (key == "replay_max_gap_ms") {
+      try { cfg.replay_max_gap_ms = std::max(0, std::stoi(val)); }
       catch (...) { /* keep default */ }
     } else if (key == "backtest_meta") {
       cfg.backtest_meta = val;
     } else if (key == "backtest_rules") {
       cfg.backtest_rules = val;
+    } else if (key == "backtest_clean") {
+      cfg.backtest_clean = parse_bool(val);
+    } else if (key == "backtest_clean_dir") {
+      cfg.backtest_clean_dir = val;
+    } else if (key == "backtest_bar_replay") {
+      cfg.backtest_bar_replay = parse_bool(val);
+    } else if (key == "bar_cache_dir") {
+      cfg.bar_cache_dir = val;
+    } else if (key == "bar_history_dir") {
+      cfg.bar_history_dir = val;
+    } else if (key == "cpu_feed" || key == "cpu_engine" || key == "cpu_logger") {
+      int* dst = key == "cpu_feed" ? &cfg.cpu_feed : key == "cpu_engine" ? &cfg.cpu_engine : &cfg.cpu_logger;
+      try { *dst = std::stoi(val); }
+      catch (...) { /* keep default */ }
+    } else if (key == "wait_logger") {
+      cfg.wait_logger = val;
+    } else if (key == "wait_engine") {
+      cfg.wait_engine = val;
+    } else if (key == "md_policy") {
+      cfg.md_policy = val;
+    } else if (key == "md_max_instruments") {
+      try { cfg.md_max_instruments = std::max(1, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "md_queue_capacity") {
+      try { cfg.md_queue_capacity = std::max(2, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "record_dir") {
+      cfg.record_dir = val;
+    } else if (key == "record_max_instruments") {
+      try { cfg.record_max_instruments = std::max(1, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "record_queue_capacity") {
+      try { cfg.record_queue_capacity = std::max(2, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "huge_pages") {
+      cfg.huge_pages = parse_bool(val);
+    } else if (key == "synth_instruments") {
+      try { cfg.synth_instruments = std::max(1, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "synth_model") {
+      cfg.synth_model = val;
+    } else if (key == "synth_rate" || key == "synth_burst_factor" || key == "synth_burst_prob" ||
+               key == "synth_burst_len" || key == "synth_zipf" || key == "synth_vol" ||
+               key == "synth_mean_revert" || key == "synth_price" || key == "synth_tick_size") {
+      double* dst = key == "synth_rate" ? &cfg.synth_rate
+                  : key == "synth_burst_factor" ? &cfg.synth_burst_factor
+                  : key == "synth_burst_prob" ? &cfg.synth_burst_prob
+                  : key == "synth_burst_len" ? &cfg.synth_burst_len
+                  : key == "synth_zipf" ? &cfg.synth_zipf
+                  : key == "synth_vol" ? &cfg.synth_vol
+                  : key == "synth_mean_revert" ? &cfg.synth_mean_revert
+                  : key == "synth_price" ? &cfg.synth_price : &cfg.synth_tick_size;
+      try { *dst = std::stod(val); }
+      catch (...) { /* keep default */ }
+    } else if (key == "synth_seed" || key == "synth_events") {
+      uint64_t* dst = key == "synth_seed" ? &cfg.synth_seed : &cfg.synth_events;
+      try { *dst = std::stoull(val); }
+      catch (...) { /* keep default */ }
+    } else if (key == "synth_store") {
+      cfg.synth_store = val;
+    } else if (key == "session_filter") {
+      cfg.session_filter = parse_bool(val);
+    } else if (key == "hot_reload") {
+      cfg.hot_reload = parse_bool(val);
     } else if (key == "run_seconds") {
-      try { cfg.run_seconds = std::max(1, std::stoi(val)); }
+      try { cfg.run_seconds = std::max(0, std::stoi(val)); }
       catch (...) { /* keep default */ }
     } else if (key == "enable_csv_logs") {
       cfg.enable_csv_logs = parse_bool(val);
@@ -99,6 +245,89 @@ AppConfig load_app_config(const std::string& path, bool* ok) {
     } else if (key == "strat_threshold") {
       try { cfg.strat_threshold = std::stod(val); }
       catch (...) { /* keep default */ }
+    } else if (key == "strat_order_timeout_ms") {
+      try { cfg.strat_order_timeout_ms = std::max(0, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "co_lookback_bars") {
+      try { cfg.co_lookback_bars = std::max(1, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "co_hold_bars") {
+      try { cfg.co_hold_bars = std::max(1, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "co_entry_offset") {
+      try { cfg.co_entry_offset = std::stod(val); }
+      catch (...) { /* keep default */ }
+    } else if (key == "co_entry_timeout_ms") {
+      try { cfg.co_entry_timeout_ms = std::max(1, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "metrics_sample_sec") {
+      try { cfg.metrics_sample_sec = std::max(1, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "metrics_http_port") {
+      try { cfg.metrics_http_port = std::max(0, std::min(65535, std::stoi(val))); }
+      catch (...) { /* keep default */ }
+    } else if (key == "metrics_snapshot_sec") {
+      try { cfg.metrics_snapshot_sec = std::max(0, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "metrics_snapshot_path") {
+      cfg.metrics_snapshot_path = val;
+    } else if (key == "trace_file") {
+      cfg.trace_file = val;
+    } else if (key == "trace_sample") {
+      try { cfg.trace_sample = std::max(1, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "trace_buffer_events") {
+      try { cfg.trace_buffer_events = std::max(1024, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "strategy_type") {
+      cfg.strategy_type = val;
+    } else if (key == "builtin_class") {
+      cfg.builtin_class = val;
+    } else if (key == "python_module") {
+      cfg.python_module = val;
+    } else if (key == "python_class") {
+      cfg.python_class = val;
+    } else if (key == "python_path") {
+      cfg.python_path = val;
+    } else if (key == "python_batch_size") {
+      try { cfg.python_batch_size = std::max(1, std::stoi(val)); }
+      catch (...) { /* keep default */ }
+    } else if (key == "strategies") {
+      cfg.strategies.clear();
+      std::stringstream ss(val);
+      std::string tok;
+      while (std::getline(ss, tok, ',')) {
+        tok = trim(tok);
+        if (!tok.empty()) cfg.strategies.push_back(tok);
+      }
+    } else if (key == "scenarios") {
+      cfg.scenarios.clear();
+      std::stringstream ss(val);
+      std::string tok;
+      while (std::getline(ss, tok, ',')) {
+        tok = trim(tok);
+        if (!tok.empty()) cfg.scenarios.push_back(tok);
+      }
+    } else if (key.rfind("scenario.", 0) == 0) {
+      // scenario.<名>.slippage_tick / partial_fill / match_type
+      const size_t dot = key.rfind('.');
+      if (dot <= 9) continue;
+      MatchingOverrides& o = cfg.scenario_rules[key.substr(9, dot - 9)];
+      const std::string field = key.substr(dot + 1);
+      if (field == "slippage_tick") {
+        try { o.slippage_tick = std::max(0.0, std::stod(val)); }
+        catch (...) { /* keep default */ }
+      } else if (field == "partial_fill") {
+        o.partial_fill = parse_bool(val) ? 1 : 0;
+      } else if (field == "match_type") {
+        o.match_type = val;
+      }
+    } else if (key == "signals_file") {
+      cfg.signals_file = val;
+    } else if (key == "log_level") {
+      cfg.log_level = val;
+    } else if (key.rfind("log_level.", 0) == 0) {
+      cfg.log_component_levels[key.substr(10)] = val;
     }
   }
   return cfg;
@@ -2,8 +2,28 @@
 #include "TradingSystem/BarAggregator.h"
 #include "TradingSystem/RiskManager.h"
 #include "TradingSystem/TraderProxy.h"
+#include "TradingSystem/IBarSource.h"
+#include "TradingSystem/ISessionFilter.h"
+#include "TradingSystem/SessionCalendar.h"
+#include "TradingSystem/PerfMetrics.h"
+#include "TradingSystem/ConfigUtil.h"
+#include "TradingSystem/TimeUtil.h"
+#include "TradingSystem/Log.h"
+#include "TradingSystem/ThreadManager.h"
+#include "TradingSystem/MarketDataStage.h"
+#include "TradingSystem/TickRecorder.h"
+#include "TradingSystem/ScenarioReplica.h"
+#include "TradingSystem/LiveConfig.h"
+#include "TradingSystem/MarketSnapshot.h"
+#include "TradingSystem/BarHistory.h"
+#include "TradingSystem/InstrumentMeta.h"
+#include "TradingSystem/MetricsRegistry.h"
+#include "TradingSystem/MetricsExporter.h"
+#include "TradingSystem/Tracer.h"
 #include <iostream>
 #include <thread>
+#include <mutex>
+#include <atomic>
 #include <chrono>
 #include <unordered_map>
 #include <fstream>
@@ -19,9 +39,50 @@ Engine::Engine(AppConfig cfg,
                std::unique_ptr<IMarketData> md,
                std::unique_ptr<ITrader> td,
                std::unique_ptr<Strategy> strat)
-    : cfg_(std::move(cfg)), md_(std::move(md)), td_(std::move(td)), strat_(std::move(strat)) {}
+    : cfg_(std::move(cfg)), md_(std::move(md)), td_(std::move(td)) {
+  std::vector<HostedStrategy> v;
+  if (strat) {
+    Subscription sub = strat->subscription();
+    v.push_back(HostedStrategy{cfg_.builtin_class, std::move(strat), std::move(sub)});
+  }
+  host_.reset(new StrategyHost(std::move(v)));
+}
+
+Engine::Engine(AppConfig cfg,
+               std::unique_ptr<IMarketData> md,
+               std::unique_ptr<ITrader> td,
+               std::vector<HostedStrategy> strategies)
+    : cfg_(std::move(cfg)), md_(std::move(md)), td_(std::move(td)),
+      host_(new StrategyHost(std::move(strategies))) {}
+
+Engine::~Engine() {
+  // 先停止行情线程，再释放交易与策略，避免行情回调访问已析构对象
+  md_.reset();
+  td_.reset();
+  host_.reset();
+}
+
+void Engine::add_scenario(const std::string& name, std::vector<HostedStrategy> strategies) {
+  scenarios_.emplace_back(new ScenarioReplica(name, std::move(strategies)));
+}
 
 int Engine::run() {
+  // 线程拓扑须在首条异步日志（日志线程启动）之前生效
+  ThreadConfig tcfg;
+  tcfg.cpu[static_cast<int>(ThreadRole::Feed)] = cfg_.cpu_feed;
+  tcfg.cpu[static_cast<int>(ThreadRole::Engine)] = cfg_.cpu_engine;
+  tcfg.cpu[static_cast<int>(ThreadRole::Logger)] = cfg_.cpu_logger;
+  const std::pair<const std::string*, ThreadRole> waits[] = {{&cfg_.wait_logger, ThreadRole::Logger},
+                                                             {&cfg_.wait_engine, ThreadRole::Engine}};
+  for (const auto& w : waits) {
+    if (!parse_wait_strategy(*w.first, &tcfg.wait[static_cast<int>(w.second)])) {
+      std::cerr << "[Engine] unknown wait strategy " << *w.first << ", using block\n";
+    }
+  }
+  tcfg.huge_pages = cfg_.huge_pages;
+  ThreadManager::instance().configure(tcfg);
+  ThreadManager::instance().enter(ThreadRole::Engine);
+  log::configure(cfg_.log_level, cfg_.log_component_levels);
   // 连接行情与交易
 #ifdef USE_CTP
   if (cfg_.use_ctp) {
@@ -40,7 +101,8 @@ int Engine::run() {
       std::cerr << "[Engine] Market data connect failed: " << cfg_.md_front << "\n";
       return 1;
     }
-    if (!td_->connect(cfg_.use_backtest ? "backtest" : "stub")) {
+    const bool matching = cfg_.use_backtest || cfg_.use_synthetic;
+    if (!td_->connect(matching ? "backtest" : "stub")) {
       std::cerr << "[Engine] Trader connect failed\n";
       return 1;
     }
@@ -48,21 +110,75 @@ int Engine::run() {
   }
 #endif
 
-  RiskManager risk(RiskConfig{cfg_.max_pos_per_instrument, cfg_.max_orders_per_bar, cfg_.min_order_interval_ms});
-  // 用交易代理包装底层交易接口，加入风控
+  const RiskConfig risk_cfg{cfg_.max_pos_per_instrument, cfg_.max_orders_per_bar, cfg_.min_order_interval_ms};
+  RiskManager risk(risk_cfg);
+  // 用交易代理包装底层交易接口，加入风控；各策略经各自的门面下单
   td_.reset(new TraderProxy(std::move(td_), &risk));
-  // 回测模式下，加载撮合配置
-  if (cfg_.use_backtest) {
+  host_->bind_trader(td_.get());
+  // 回测与合成行情模式下，加载撮合配置
+  if (cfg_.use_backtest || cfg_.use_synthetic) {
     if (auto proxy = dynamic_cast<TraderProxy*>(td_.get())) {
       proxy->configure_backtest(cfg_.backtest_meta, cfg_.backtest_rules);
     }
   }
 
-  BarAggregator bar_agg(cfg_.bar_interval_sec);
-  bar_agg.set_bar_handler([this, &risk](const BarEvent& bar) {
+  // 绩效统计：指标与输出格式取自回测规则文件（config.json）
+  PerfMetricsConfig pm_cfg;
+  pm_cfg.sample_sec = cfg_.metrics_sample_sec;
+  std::string rules_doc;
+  if (!cfg_.backtest_rules.empty() && read_text_file(cfg_.backtest_rules, &rules_doc)) {
+    json_string_array(rules_doc, "report_metrics", &pm_cfg.metrics);
+    json_string_array(rules_doc, "report_fmt", &pm_cfg.formats);
+    json_number(rules_doc, "initial_capital", &pm_cfg.initial_capital);
+  }
+  PerfMetrics metrics(pm_cfg);
+  // 最近一笔行情的事件时间（毫秒），成交按该时间计入统计
+  std::atomic<int64_t> last_event_ms{-1};
+
+  // 交易时段日历：取自meta.json的session字段
+  SessionCalendar sessions;
+  if (cfg_.session_filter && !cfg_.backtest_meta.empty()) {
+    size_t n = sessions.load_meta(cfg_.backtest_meta);
+    std::cout << "[Engine] trading sessions loaded for " << n << " instruments\n";
+  }
+  const SessionCalendar* calendar = sessions.empty() ? nullptr : &sessions;
+  risk.set_session_calendar(calendar);
+  // 合约参数：跳价、乘数与手续费，风控按定点价格与金额核算盈亏
+  InstrumentTable instruments;
+  const InstrumentTable* inst_table = instruments.load_meta(cfg_.backtest_meta) > 0 ? &instruments : nullptr;
+  risk.set_instruments(inst_table);
+  if (auto sf = dynamic_cast<ISessionFilter*>(md_.get())) sf->set_session_calendar(calendar);
+
+  // 运行期指标：行情计数与单笔处理延迟（每64笔采样一笔，避免每笔读时钟）
+  auto& registry = MetricsRegistry::instance();
+  const Counter ticks_total = registry.counter("ts_md_ticks_total", "Market data events processed by the engine");
+  const Counter bars_total = registry.counter("ts_bars_total", "Bars delivered to strategies");
+  const Histogram tick_latency = registry.histogram(
+      "ts_tick_latency_seconds", "Engine processing time per tick (sampled 1/64)", 1e9);
+  uint64_t tick_seq = 0;
+  std::unordered_map<std::string, Counter> order_events;
+
+  // Bar历史库：启动时供策略预热，运行中追加每根完成的Bar
+  std::unique_ptr<BarHistory> history;
+  if (!cfg_.bar_history_dir.empty()) history.reset(new BarHistory(cfg_.bar_history_dir, cfg_.bar_interval_sec));
+  BarHistory* hist = history.get();
+
+  BarAggregator bar_agg(cfg_.bar_interval_sec, calendar);
+  auto on_bar = [this, &risk, bars_total, hist](const BarEvent& bar) {
+    bars_total.inc();
+    TS_TRACE_SCOPE("bar", "bar.emit");
+    if (hist) {
+      const int64_t start = parse_datetime_ms(bar.ts);
+      if (start >= 0) hist->append(bar.instrument, BarRecord{start, bar.open, bar.high, bar.low, bar.close, bar.volume});
+    }
     risk.on_new_bar(bar.instrument);
-    if (strat_) strat_->on_bar(bar, td_.get());
-  });
+    host_->on_bar(bar);
+    for (auto& sc : scenarios_) sc->on_bar(bar);
+  };
+  bar_agg.set_bar_handler(on_bar);
+  // 行情源自带Bar（如Bar缓存回放）时直接送达策略，不再逐Tick聚合
+  auto* bar_src = dynamic_cast<IBarSource*>(md_.get());
+  if (bar_src) bar_src->set_bar_handler(on_bar);
 
   // 订单事件CSV日志
   std::string csv_dir_cfg = cfg_.csv_dir.empty() ? std::string("data") : cfg_.csv_dir;
@@ -80,29 +196,136 @@ int Engine::run() {
     trade_log << "order_id,status,instrument,filled_qty,fill_price,remaining_qty,message\n";
   }
 
-  md_->set_market_data_handler([this, &bar_agg, &risk](const MarketDataEvent& md_ev) {
-    if (strat_) {
-      strat_->on_market_data(md_ev, td_.get());
+  // 全市场快照：派发前逐笔更新，订阅列表中的合约预先分配序号
+  MarketSnapshot snapshot(std::max<size_t>(cfg_.instruments.size(), 1024));
+  for (const auto& inst : cfg_.instruments) snapshot.add(inst);
+  host_->bind_snapshot(&snapshot);
+  for (auto& sc : scenarios_) sc->bind_snapshot(&snapshot);
+
+  // 定时器时钟：回测与合成行情按行情事件时间（在派发本笔行情前触发到期定时器），实盘按单调时钟
+  const bool event_time = cfg_.use_backtest || cfg_.use_synthetic;
+  auto steady_ms = [] {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+  };
+  // 实盘且无缓冲级时行情线程直接派发，引擎线程推进定时器，二者经此锁串行化
+  std::mutex dispatch_mu;
+  bool serialize_dispatch = false;
+
+  auto on_tick = [this, &bar_agg, &risk, bar_src, &metrics, &last_event_ms, ticks_total, tick_latency, &snapshot,
+                  &tick_seq, event_time, steady_ms, &dispatch_mu, &serialize_dispatch](const MarketDataEvent& md_ev) {
+    std::unique_lock<std::mutex> dispatch_lk(dispatch_mu, std::defer_lock);
+    if (serialize_dispatch) dispatch_lk.lock();
+    ticks_total.inc();
+    TraceTick trace_tick;
+    const bool sampled = (tick_seq++ & 63) == 0;
+    std::chrono::steady_clock::time_point t0;
+    if (sampled) t0 = std::chrono::steady_clock::now();
+    int64_t ev_ms = parse_datetime_ms(md_ev.update_time);
+    if (ev_ms < 0) {
+      ev_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+    snapshot.update(md_ev, ev_ms);
+    // 到期定时器先于本笔行情触发
+    host_->advance_timers(event_time ? ev_ms : steady_ms());
+    // 风控先接收行情以追踪最新价、浮盈与交易时段，本笔行情触发的下单按其检查
+    {
+      TS_TRACE_SCOPE("risk", "risk.on_market_data");
+      risk.on_market_data(md_ev);
     }
+    // 按路由表只送达订阅了该合约行情的策略
+    host_->on_market_data(md_ev);
     // 将行情转发给交易代理，用于回测撮合
     if (auto proxy = dynamic_cast<TraderProxy*>(td_.get())) {
+      TS_TRACE_SCOPE("matching", "matching.on_market_data");
       proxy->on_market_data(md_ev);
     }
-    // 风控接收行情以追踪最新价和浮盈
-    risk.on_market_data(md_ev);
-    bar_agg.on_tick(md_ev);
-  });
+    last_event_ms.store(ev_ms, std::memory_order_relaxed);
+    auto pit = risk.pnl_info().find(md_ev.instrument);
+    if (pit != risk.pnl_info().end()) {
+      metrics.on_mark(md_ev.instrument, ev_ms, pit->second.realized_pnl + pit->second.unrealized_pnl);
+    }
+    // 其他场景：同一笔已解析的行情依次送入各副本
+    if (!scenarios_.empty()) {
+      TS_TRACE_SCOPE("scenario", "scenarios.on_tick");
+      for (auto& sc : scenarios_) sc->on_tick(md_ev, ev_ms);
+    }
+    if (!bar_src) {
+      TS_TRACE_SCOPE("bar", "bar.on_tick");
+      bar_agg.on_tick(md_ev);
+    }
+    snapshot.clear_dirty();
+    if (sampled) {
+      tick_latency.observe(static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count()));
+    }
+  };
+  // 行情缓冲级：行情线程只写入，引擎线程在主循环中取出并回调；direct时行情线程直接回调
+  MdPolicy md_policy = MdPolicy::Direct;
+  if (!parse_md_policy(cfg_.md_policy, &md_policy)) {
+    std::cerr << "[Engine] unknown md_policy " << cfg_.md_policy << ", using direct\n";
+  }
+  // 仅Bar回放的Bar与其合成行情须保持先后，不经缓冲
+  if (bar_src && md_policy != MdPolicy::Direct) {
+    std::cerr << "[Engine] md_policy ignored for bar replay\n";
+    md_policy = MdPolicy::Direct;
+  }
+  if (!cfg_.record_dir.empty()) {
+    recorder_.reset(new TickRecorder(cfg_.record_dir, static_cast<size_t>(cfg_.record_max_instruments),
+                                     static_cast<size_t>(cfg_.record_queue_capacity)));
+    if (!recorder_->start()) recorder_.reset();
+  }
+  TickRecorder* rec = recorder_.get();
+  if (md_policy != MdPolicy::Direct) {
+    md_stage_.reset(new MarketDataStage(md_policy, static_cast<size_t>(cfg_.md_max_instruments),
+                                        static_cast<size_t>(cfg_.md_queue_capacity)));
+    MarketDataStage* stage = md_stage_.get();
+    if (rec) {
+      md_->set_market_data_handler([stage, rec](const MarketDataEvent& md_ev) {
+        rec->record(md_ev);
+        stage->publish(md_ev);
+      });
+    } else {
+      md_->set_market_data_handler([stage](const MarketDataEvent& md_ev) { stage->publish(md_ev); });
+    }
+    std::cout << "[Engine] md_policy=" << md_policy_name(stage->policy()) << "\n";
+    registry.gauge_fn("ts_md_stage_published", "Events published into the market data stage",
+                      [stage] { return static_cast<double>(stage->published()); });
+    registry.gauge_fn("ts_md_stage_conflated", "Events merged into a pending slot by the market data stage",
+                      [stage] { return static_cast<double>(stage->conflated()); });
+    registry.gauge_fn("ts_md_stage_dropped", "Events dropped by the market data stage",
+                      [stage] { return static_cast<double>(stage->dropped()); });
+  } else if (rec) {
+    md_->set_market_data_handler([rec, on_tick](const MarketDataEvent& md_ev) {
+      rec->record(md_ev);
+      on_tick(md_ev);
+    });
+  } else {
+    md_->set_market_data_handler(on_tick);
+  }
+  serialize_dispatch = !event_time && !md_stage_;
 
   // 简单成交统计（按合约累计成交量与成交金额）
   std::unordered_map<std::string, std::pair<long, double>> stats;
-  td_->set_order_status_handler([this, &stats, &trade_log](const OrderStatusEvent& ev) {
-     std::cout << "[OrderStatus] id=" << ev.order_id
-               << " status=" << ev.status
-               << " inst=" << ev.instrument
-               << " qty=" << ev.filled_qty
-               << " px=" << ev.fill_price
-               << " remaining=" << ev.remaining_qty
-               << " msg=" << ev.message << std::endl;
+  td_->set_order_status_handler([this, &stats, &trade_log, &risk, &metrics, &last_event_ms, &registry,
+                                 &order_events](const OrderStatusEvent& ev) {
+    auto oit = order_events.find(ev.status);
+    if (oit == order_events.end()) {
+      oit = order_events.emplace(ev.status, registry.counter("ts_order_events_total", "Order status events by status",
+                                                             MetricsRegistry::label("status", ev.status))).first;
+    }
+    oit->second.inc();
+    // 订单回报不采样；状态名驻留一次后复用
+    const char* trace_name = nullptr;
+    if (Tracer::enabled()) {
+      trace_name = Tracer::instance().intern("order_status." + ev.status);
+      trace_instant("order", trace_name);
+    }
+    TraceSpan trace_span("order", trace_name ? trace_name : "order_status", true);
+     TS_LOG_INFO(Engine, "[OrderStatus] id=", ev.order_id, " status=", ev.status, " inst=", ev.instrument,
+                 " qty=", ev.filled_qty, " px=", ev.fill_price, " remaining=", ev.remaining_qty,
+                 " msg=", ev.message);
     if (cfg_.enable_csv_logs && trade_log) {
       trade_log << ev.order_id << "," << ev.status << "," << ev.instrument << ","
                 << ev.filled_qty << "," << ev.fill_price << "," << ev.remaining_qty << "," << ev.message << "\n";
@@ -111,8 +334,14 @@ int Engine::run() {
        auto &s = stats[ev.instrument];
        s.first += ev.filled_qty;
        s.second += ev.filled_qty * ev.fill_price;
+       auto pit = risk.pnl_info().find(ev.instrument);
+       if (pit != risk.pnl_info().end()) {
+         const auto& p = pit->second;
+         metrics.on_fill(ev.instrument, last_event_ms.load(std::memory_order_relaxed),
+                         p.long_open_qty + p.short_open_qty, p.realized_pnl);
+       }
      }
-     if (strat_) { strat_->on_order_status(ev); }
+     host_->on_order_status(ev);
    });
 
   if (!md_->login(cfg_.broker_id, cfg_.user_id, cfg_.password)) {
@@ -124,16 +353,117 @@ int Engine::run() {
     return 1;
   }
 
-  if (!md_->subscribe(cfg_.instruments)) {
+  // 指标导出：回环HTTP端点与周期快照，均在独立线程上抓取
+  std::string snapshot_path = cfg_.metrics_snapshot_path.empty() ? csv_dir + "/metrics.prom" : cfg_.metrics_snapshot_path;
+  MetricsExporter exporter(cfg_.metrics_http_port, cfg_.metrics_snapshot_sec, snapshot_path);
+  exporter.start();
+  // 事件时间线追踪（可选）：结束时写出Chrome trace-event JSON
+  if (!cfg_.trace_file.empty()) {
+    Tracer::instance().start(static_cast<size_t>(cfg_.trace_buffer_events), static_cast<uint32_t>(cfg_.trace_sample));
+  }
+
+  // 实盘定时器以启动时刻为起点；回测在首笔行情时以其事件时间为起点
+  if (!event_time) host_->advance_timers(steady_ms());
+  // 回放只预热回放起点之前已结束的Bar：历史库中此前回放写入的、落在回放区间内的Bar不得泄入预热（前视偏差）
+  const int64_t warmup_end_ms = hist ? md_->replay_start_ms() : -1;
+  if (hist && warmup_end_ms < 0) {
+    std::cerr << "[Engine] warm-up skipped: cannot determine the replay start time\n";
+  } else if (hist) {
+    const auto t0 = std::chrono::steady_clock::now();
+    size_t n = host_->warm_up(*hist, cfg_.instruments, warmup_end_ms);
+    if (event_time) {
+      for (auto& sc : scenarios_) n += sc->warm_up(*hist, cfg_.instruments, warmup_end_ms);
+    }
+    hist->close_readers();
+    std::cout << "[Engine] warm-up delivered " << n << " bars from " << cfg_.bar_history_dir;
+    if (warmup_end_ms != INT64_MAX) std::cout << " before " << format_datetime_ms(warmup_end_ms);
+    std::cout << " in "
+              << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count()
+              << " us\n";
+  }
+  host_->on_start();
+  if (!scenarios_.empty() && !event_time) {
+    std::cerr << "[Engine] scenarios require backtest or synthetic mode, ignored\n";
+    scenarios_.clear();
+  }
+  for (auto& sc : scenarios_) {
+    auto rit = cfg_.scenario_rules.find(sc->name());
+    const MatchingOverrides rules = rit != cfg_.scenario_rules.end() ? rit->second : MatchingOverrides{};
+    if (!sc->start(cfg_.backtest_meta, cfg_.backtest_rules, rules, risk_cfg, pm_cfg, calendar, inst_table)) return 1;
+  }
+  if (!scenarios_.empty()) std::cout << "[Engine] " << scenarios_.size() + 1 << " scenarios in one replay pass\n";
+  // 热更新：先发布启动时的参数快照，此后由监视线程替换；风控与策略在下单路径上无锁读取
+  if (cfg_.hot_reload) {
+    LiveConfig& live = LiveConfig::instance();
+    live.publish(live_params_from(cfg_));
+    risk.set_live_config(&live);
+    host_->bind_live_config(&live);
+    for (auto& sc : scenarios_) sc->bind_live_config(&live);
+    config_watcher_.reset(new ConfigWatcher(cfg_.config_path, cfg_));
+    config_watcher_->start();
+  }
+
+  if (!md_->subscribe(host_->subscribe_list(cfg_.instruments))) {
     std::cerr << "[Engine] Subscribe failed\n";
     return 1;
   }
 
-  // 主循环：等待行情线程运行完成（stub/backtest内部管理线程）
-  std::this_thread::sleep_for(std::chrono::seconds(cfg_.run_seconds));
+  // 事件循环：有缓冲级时本线程取出行情派发；实盘模式本线程按单调时钟推进定时器。
+  // 停止条件：有限行情源送完且缓冲已取空、收到stop()、或运行满run_seconds（<=0不限时）
+  const auto started = std::chrono::steady_clock::now();
+  const auto deadline = started + std::chrono::seconds(cfg_.run_seconds);
+  const WaitStrategy ws = ThreadManager::instance().wait_strategy(ThreadRole::Engine);
+  const Gauge depth = md_stage_ ? registry.gauge("ts_md_stage_depth", "Events waiting in the market data stage")
+                                : Gauge();
+  const char* stop_reason = "run_seconds elapsed";
+  unsigned idle = 0;
+  for (;;) {
+    // 先取完成标志再取缓冲：标志置位后不再有新行情，随后一次空的drain即表示全部派发完毕
+    const bool feed_done = md_->finished();
+    size_t n = 0;
+    if (md_stage_) {
+      n = md_stage_->drain(on_tick);
+      depth.set(static_cast<double>(md_stage_->published() - md_stage_->delivered()));
+    }
+    if (!event_time) {
+      std::unique_lock<std::mutex> dispatch_lk(dispatch_mu, std::defer_lock);
+      if (serialize_dispatch) dispatch_lk.lock();
+      host_->advance_timers(steady_ms());
+    }
+    if (stop_requested_.load(std::memory_order_relaxed)) { stop_reason = "stop requested"; break; }
+    if (feed_done && n == 0) { stop_reason = "feed finished"; break; }
+    if (cfg_.run_seconds > 0 && std::chrono::steady_clock::now() >= deadline) break;
+    if (n > 0) idle = 0;
+    else idle_wait(ws, idle);
+  }
+  std::cout << "[Engine] stopped (" << stop_reason << ") after "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count()
+            << " ms, pending timers=" << host_->pending_timers() << "\n";
+  if (md_stage_) {
+    md_stage_->close();
+    for (const char* n : {"ts_md_stage_published", "ts_md_stage_conflated", "ts_md_stage_dropped"}) {
+      registry.remove_gauge_fn(n);
+    }
+    std::cout << "[MDStage] published=" << md_stage_->published() << " delivered=" << md_stage_->delivered()
+              << " conflated=" << md_stage_->conflated() << " dropped=" << md_stage_->dropped() << "\n";
+  }
+  // 行情回调引用本函数的局部对象（风控、Bar聚合、统计等）：先停住行情线程再收尾（缓冲级已关闭，发布不再阻塞）
+  md_->stop();
+  if (recorder_) recorder_->stop();
+  if (config_watcher_) config_watcher_->stop();
+  host_->on_stop();
+  for (auto& sc : scenarios_) sc->stop();
+  exporter.stop();
+  if (!cfg_.trace_file.empty()) Tracer::instance().stop_and_write(cfg_.trace_file);
+
+  std::cout << "[Metrics]";
+  for (const auto& m : metrics.metric_names()) std::cout << " " << m << "=" << metrics.value(m);
+  std::cout << "\n";
+  if (!scenarios_.empty()) write_scenario_report(metrics, csv_dir);
 
   // 汇总成交均价CSV
   if (cfg_.enable_csv_logs) {
+    metrics.write_report(csv_dir);
     std::ofstream sum(csv_dir + "/trade_summary.csv");
     if (sum) {
       sum << "instrument,total_qty,avg_price\n";
@@ -166,8 +496,8 @@ int Engine::run() {
       pnl << "instrument,realized_pnl,unrealized_pnl,long_open_qty,long_avg_cost,short_open_qty,short_avg_cost\n";
       for (const auto& kv : risk.pnl_info()) {
         const auto &info = kv.second;
-        double long_avg = (info.long_open_qty > 0 ? info.long_open_cost_sum / info.long_open_qty : 0.0);
-        double short_avg = (info.short_open_qty > 0 ? info.short_open_cost_sum / info.short_open_qty : 0.0);
+        double long_avg = info.long_avg_cost;
+        double short_avg = info.short_avg_cost;
         pnl << kv.first << "," << info.realized_pnl << "," << info.unrealized_pnl << "," << info.long_open_qty << "," << long_avg
             << "," << info.short_open_qty << "," << short_avg << "\n";
       }
@@ -179,7 +509,7 @@ int Engine::run() {
 #ifdef _WIN32
       localtime_s(&tm, &tt);
 #else
-      localtime_r(&tm, &tt);
+      localtime_r(&tt, &tm);
 #endif
       std::ostringstream ts;
       ts << std::put_time(&tm, "%Y%m%d_%H%M%S");
@@ -189,8 +519,8 @@ int Engine::run() {
         pnl_fb << "instrument,realized_pnl,unrealized_pnl,long_open_qty,long_avg_cost,short_open_qty,short_avg_cost\n";
         for (const auto& kv : risk.pnl_info()) {
           const auto &info = kv.second;
-          double long_avg = (info.long_open_qty > 0 ? info.long_open_cost_sum / info.long_open_qty : 0.0);
-          double short_avg = (info.short_open_qty > 0 ? info.short_open_cost_sum / info.short_open_qty : 0.0);
+          double long_avg = info.long_avg_cost;
+          double short_avg = info.short_avg_cost;
           pnl_fb << kv.first << "," << info.realized_pnl << "," << info.unrealized_pnl << "," << info.long_open_qty << "," << long_avg
                  << "," << info.short_open_qty << "," << short_avg << "\n";
         }
@@ -204,4 +534,46 @@ int Engine::run() {
   return 0;
 }
 
+void Engine::write_scenario_report(const PerfMetrics& base, const std::string& csv_dir) const {
+  // 对比报表：主场景记为base，覆盖项为空表示沿用config.json
+  const auto& names = base.metric_names();
+  std::ofstream out;
+  if (cfg_.enable_csv_logs) {
+    out.open(csv_dir + "/scenarios.csv");
+    if (out) {
+      out << "scenario,slippage_tick,partial_fill,match_type";
+      for (const auto& m : names) out << "," << m;
+      out << "\n";
+    }
+  }
+  auto emit = [&](const std::string& name, const MatchingOverrides& r, const PerfMetrics& pm) {
+    std::ostringstream slip_os;
+    if (r.slippage_tick >= 0.0) slip_os << r.slippage_tick;
+    const std::string slip = slip_os.str();
+    const std::string pf = r.partial_fill < 0 ? std::string() : (r.partial_fill ? "true" : "false");
+    std::cout << "[Scenario] " << name;
+    if (!slip.empty()) std::cout << " slippage_tick=" << slip;
+    if (!pf.empty()) std::cout << " partial_fill=" << pf;
+    if (!r.match_type.empty()) std::cout << " match_type=" << r.match_type;
+    for (const auto& m : names) std::cout << " " << m << "=" << pm.value(m);
+    std::cout << "\n";
+    if (out) {
+      out << name << "," << slip << "," << pf << "," << r.match_type;
+      for (const auto& m : names) out << "," << pm.value(m);
+      out << "\n";
+    }
+  };
+  emit("base", MatchingOverrides{}, base);
+  for (const auto& sc : scenarios_) {
+    emit(sc->name(), sc->rules(), sc->metrics());
+    if (cfg_.enable_csv_logs) {
+      const std::string dir = csv_dir + "/scenario_" + sc->name();
+      std::error_code ec;
+      std::filesystem::create_directories(dir, ec);
+      if (ec) std::cerr << "[Engine] cannot create " << dir << ": " << ec.message() << "\n";
+      else sc->write_reports(dir);
+    }
+  }
+}
+
 } // namespace ts
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "TradingSystem/InstrumentMeta.h"
+#include "TradingSystem/ConfigUtil.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace ts {
+
+namespace {
+constexpr double kUnitEps = 1e-6;
+} // namespace
+
+void InstrumentMeta::finalize(bool known) {
+  if (!(tick_size > 0.0)) tick_size = 1.0;
+  if (contract_multiplier <= 0) contract_multiplier = 1;
+  per_tick = known ? 1 : 10000;
+  const double mpu = tick_size / static_cast<double>(per_tick) * contract_multiplier * kMoneyScale;
+  money_per_unit = std::llround(mpu);
+  if (money_per_unit <= 0 || std::fabs(mpu - static_cast<double>(money_per_unit)) > kUnitEps) {
+    std::cerr << "[Meta] tick value " << tick_size * contract_multiplier << " is not a multiple of 1/" << kMoneyScale
+              << ", PnL rounded" << std::endl;
+    if (money_per_unit <= 0) money_per_unit = 1;
+  }
+  const double scale = fee_per_lot ? static_cast<double>(kMoneyScale) : static_cast<double>(kFeeRateScale);
+  fee_open_fp = std::llround(fee_open * scale);
+  fee_close_fp = std::llround(fee_close * scale);
+  fee_close_today_fp = std::llround(fee_close_today * scale);
+}
+
+int64_t InstrumentMeta::to_units(double px) const {
+  return std::llround(px * static_cast<double>(per_tick) / tick_size);
+}
+
+int64_t InstrumentMeta::floor_units(double px) const {
+  const double x = px * static_cast<double>(per_tick) / tick_size;
+  const double r = std::round(x);
+  return static_cast<int64_t>(std::fabs(x - r) < kUnitEps ? r : std::floor(x));
+}
+
+int64_t InstrumentMeta::ceil_units(double px) const {
+  const double x = px * static_cast<double>(per_tick) / tick_size;
+  const double r = std::round(x);
+  return static_cast<int64_t>(std::fabs(x - r) < kUnitEps ? r : std::ceil(x));
+}
+
+int64_t InstrumentMeta::fee(int64_t fee_fp, int64_t px, int qty) const {
+  if (fee_fp == 0 || qty <= 0) return 0;
+  if (fee_per_lot) return fee_fp * qty;
+  // 按每手成交额取整后乘手数，避免大额时溢出
+  return div_round(px * money_per_unit * fee_fp, kFeeRateScale) * qty;
+}
+
+InstrumentTable::InstrumentTable() { default_.finalize(false); }
+
+size_t InstrumentTable::load_meta(const std::string& meta_path) {
+  // meta示例：[{"instrument":"IF2401","tick_size":0.2,"contract_multiplier":300,"slippage_tick":0.5,
+  //            "fee_open":0.00023,"fee_close":0.00023,"fee_close_today":0.00046,"fee_type":"percent"}, ...]
+  std::string doc;
+  if (meta_path.empty() || !read_text_file(meta_path, &doc)) return 0;
+  std::vector<std::string> objs;
+  json_objects(doc, &objs);
+  size_t n = 0;
+  for (const auto& o : objs) {
+    std::string instr;
+    if (!json_string(o, "instrument", &instr)) continue;
+    InstrumentMeta m;
+    double v = 0.0;
+    if (json_number(o, "tick_size", &v)) m.tick_size = v;
+    if (json_number(o, "contract_multiplier", &v)) m.contract_multiplier = static_cast<int>(v);
+    if (json_number(o, "slippage_tick", &v)) m.slippage_tick = v;
+    std::string fee_type;
+    if (json_string(o, "fee_type", &fee_type)) m.fee_per_lot = (fee_type == "per_lot");
+    if (json_number(o, "fee_open", &v)) m.fee_open = v;
+    if (json_number(o, "fee_close", &v)) m.fee_close = v;
+    m.fee_close_today = json_number(o, "fee_close_today", &v) ? v : m.fee_close;
+    m.finalize(true);
+    meta_[instr] = m;
+    ++n;
+  }
+  return n;
+}
+
+const InstrumentMeta& InstrumentTable::get(const std::string& instrument) const {
+  auto it = meta_.find(instrument);
+  return it == meta_.end() ? default_ : it->second;
+}
+
+} // namespace ts
@@ -0,0 +1,138 @@
+#include "TradingSystem/LiveConfig.h"
+#include "TradingSystem/ConfigUtil.h"
+#include "TradingSystem/Engine.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace ts {
+
+LiveParams live_params_from(const AppConfig& cfg) {
+  LiveParams p;
+  p.risk = RiskConfig{cfg.max_pos_per_instrument, cfg.max_orders_per_bar, cfg.min_order_interval_ms};
+  p.strat_ma_fast = cfg.strat_ma_fast;
+  p.strat_ma_slow = cfg.strat_ma_slow;
+  p.strat_threshold = cfg.strat_threshold;
+  p.strat_order_timeout_ms = cfg.strat_order_timeout_ms;
+  return p;
+}
+
+void apply_live_params(const LiveParams& p, AppConfig* cfg) {
+  cfg->max_pos_per_instrument = p.risk.max_pos_per_instrument;
+  cfg->max_orders_per_bar = p.risk.max_orders_per_bar;
+  cfg->min_order_interval_ms = p.risk.min_order_interval_ms;
+  cfg->strat_ma_fast = p.strat_ma_fast;
+  cfg->strat_ma_slow = p.strat_ma_slow;
+  cfg->strat_threshold = p.strat_threshold;
+  cfg->strat_order_timeout_ms = p.strat_order_timeout_ms;
+}
+
+LiveConfig& LiveConfig::instance() {
+  static LiveConfig lc;
+  return lc;
+}
+
+bool LiveConfig::publish(const LiveParams& p) {
+  std::lock_guard<std::mutex> lk(write_mu_);
+  const LiveParams* old = cur_.load(std::memory_order_relaxed);
+  if (old && old->risk.max_pos_per_instrument == p.risk.max_pos_per_instrument &&
+      old->risk.max_orders_per_bar == p.risk.max_orders_per_bar &&
+      old->risk.min_order_interval_ms == p.risk.min_order_interval_ms && old->strat_ma_fast == p.strat_ma_fast &&
+      old->strat_ma_slow == p.strat_ma_slow && old->strat_threshold == p.strat_threshold &&
+      old->strat_order_timeout_ms == p.strat_order_timeout_ms) {
+    return false;
+  }
+  auto next = std::make_unique<LiveParams>(p);
+  next->version = old ? old->version + 1 : 1;
+  cur_.store(next.get(), std::memory_order_release);
+  snapshots_.push_back(std::move(next));
+  return true;
+}
+
+ConfigWatcher::ConfigWatcher(std::string path, const AppConfig& base)
+    : path_(std::move(path)),
+      base_(std::make_unique<const AppConfig>(base)),
+      reloads_(MetricsRegistry::instance().counter("ts_config_reloads_total",
+                                                   "Live parameter snapshots published by the config watcher")) {}
+
+ConfigWatcher::~ConfigWatcher() { stop(); }
+
+bool ConfigWatcher::start() {
+  if (path_.empty() || !std::filesystem::exists(path_)) {
+    std::cerr << "[Config] hot reload disabled: cannot find " << path_ << std::endl;
+    return false;
+  }
+  running_.store(true);
+  worker_ = std::thread([this] { run(); });
+  std::cout << "[Config] watching " << path_ << " for live parameter changes" << std::endl;
+  return true;
+}
+
+void ConfigWatcher::stop() {
+  if (!running_.exchange(false)) return;
+  if (worker_.joinable()) worker_.join();
+}
+
+void ConfigWatcher::reload() {
+  AppConfig seed = *base_;
+  if (const LiveParams* cur = LiveConfig::instance().current()) apply_live_params(*cur, &seed);
+  bool ok = false;
+  const AppConfig cfg = load_app_config(path_, &ok, &seed);
+  // 改名替换的间隙文件可能暂不存在，等待下一次事件
+  if (!ok) return;
+  if (!LiveConfig::instance().publish(live_params_from(cfg))) return;
+  reloads_.inc();
+  const LiveParams* p = LiveConfig::instance().current();
+  std::cout << "[Config] reloaded v" << p->version << ": max_pos_per_instrument=" << p->risk.max_pos_per_instrument
+            << " max_orders_per_bar=" << p->risk.max_orders_per_bar
+            << " min_order_interval_ms=" << p->risk.min_order_interval_ms << " strat_ma=" << p->strat_ma_fast << "/"
+            << p->strat_ma_slow << " strat_threshold=" << p->strat_threshold
+            << " strat_order_timeout_ms=" << p->strat_order_timeout_ms << std::endl;
+}
+
+void ConfigWatcher::run() {
+  namespace fs = std::filesystem;
+#ifdef __linux__
+  const fs::path file = fs::absolute(path_);
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd >= 0 && inotify_add_watch(fd, file.parent_path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) >= 0) {
+    const std::string name = file.filename().string();
+    alignas(inotify_event) char buf[4096];
+    while (running_.load(std::memory_order_relaxed)) {
+      pollfd pfd{fd, POLLIN, 0};
+      if (::poll(&pfd, 1, 100) <= 0) continue;
+      bool hit = false;
+      for (;;) {
+        const ssize_t n = ::read(fd, buf, sizeof(buf));
+        if (n <= 0) break;
+        for (ssize_t off = 0; off < n;) {
+          const auto* ev = reinterpret_cast<const inotify_event*>(buf + off);
+          if (ev->len > 0 && name == ev->name) hit = true;
+          off += static_cast<ssize_t>(sizeof(inotify_event) + ev->len);
+        }
+      }
+      if (hit) reload();
+    }
+    ::close(fd);
+    return;
+  }
+  if (fd >= 0) ::close(fd);
+  std::cerr << "[Config] inotify unavailable, polling " << path_ << std::endl;
+#endif
+  std::error_code ec;
+  auto last = fs::last_write_time(path_, ec);
+  while (running_.load(std::memory_order_relaxed)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const auto t = fs::last_write_time(path_, ec);
+    if (ec || t == last) continue;
+    last = t;
+    reload();
+  }
+}
+
+} // namespace ts
@@ -0,0 +1,222 @@
+#include "TradingSystem/Log.h"
+#include "TradingSystem/ThreadManager.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
+namespace ts {
+namespace log {
+namespace {
+
+// 有界多生产者/单消费者环形队列（Vyukov算法），容量为2的幂
+constexpr size_t kQueueCapacity = 8192;
+
+struct Cell {
+  detail::Slot slot;  // 必须为首成员：commit时由Slot*还原Cell*
+  std::atomic<size_t> seq{0};
+};
+static_assert(std::is_trivially_destructible<Cell>::value, "cells live in raw mapped memory");
+
+const char* kComponentNames[] = {"engine", "md", "trader", "risk", "strategy"};
+static_assert(sizeof(kComponentNames) / sizeof(kComponentNames[0]) == static_cast<size_t>(Component::Count),
+              "component name table out of sync");
+
+class Logger {
+ public:
+  Logger() {
+    // 环形队列约2MB，按配置放入大页以减少TLB缺失
+    if (!buf_.allocate(sizeof(Cell) * kQueueCapacity, ThreadManager::instance().huge_pages())) {
+      std::cerr << "[Log] queue allocation failed" << std::endl;
+      stopped_.store(true);
+      return;
+    }
+    cells_ = static_cast<Cell*>(buf_.data());
+    for (size_t i = 0; i < kQueueCapacity; ++i) new (&cells_[i]) Cell{};
+    for (size_t i = 0; i < kQueueCapacity; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    worker_ = std::thread(&Logger::run, this);
+  }
+  ~Logger() { stop(); }
+
+  detail::Slot* acquire() {
+    if (stopped_.load(std::memory_order_relaxed)) return nullptr;
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& c = cells_[pos & (kQueueCapacity - 1)];
+      size_t seq = c.seq.load(std::memory_order_acquire);
+      auto dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (dif == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) return &c.slot;
+      } else if (dif < 0) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void commit(detail::Slot* s) {
+    Cell* c = reinterpret_cast<Cell*>(s);
+    // 空闲槽位的序号等于其入队位置；提交后序号+1表示可消费
+    size_t pos = c->seq.load(std::memory_order_relaxed);
+    c->seq.store(pos + 1, std::memory_order_release);
+  }
+
+  void stop() {
+    bool expected = false;
+    if (!stopped_.compare_exchange_strong(expected, true)) return;
+    if (worker_.joinable()) worker_.join();
+  }
+
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  void run() {
+    ThreadManager& tm = ThreadManager::instance();
+    tm.enter(ThreadRole::Logger);
+    const WaitStrategy ws = tm.wait_strategy(ThreadRole::Logger);
+    unsigned idle = 0;
+    for (;;) {
+      bool stopping = stopped_.load(std::memory_order_acquire);
+      size_t n = drain();
+      if (n == 0) {
+        if (stopping) break;
+        idle_wait(ws, idle);
+      } else {
+        idle = 0;
+      }
+    }
+    uint64_t d = dropped();
+    if (d > 0) std::cerr << "[Log] dropped " << d << " records (queue full)" << std::endl;
+  }
+
+  size_t drain() {
+    size_t n = 0;
+    bool out_used = false, err_used = false;
+    for (;;) {
+      Cell& c = cells_[dequeue_pos_ & (kQueueCapacity - 1)];
+      if (c.seq.load(std::memory_order_acquire) != dequeue_pos_ + 1) break;
+      const detail::Slot& s = c.slot;
+      line_.str(std::string());
+      format_prefix(s);
+      s.decode(s.payload, s.nargs, line_);
+      line_ << '\n';
+      const std::string text = line_.str();
+      bool to_err = (s.level >= Level::Warn);
+      std::fwrite(text.data(), 1, text.size(), to_err ? stderr : stdout);
+      (to_err ? err_used : out_used) = true;
+      c.seq.store(dequeue_pos_ + kQueueCapacity, std::memory_order_release);
+      ++dequeue_pos_;
+      ++n;
+    }
+    if (out_used) std::fflush(stdout);
+    if (err_used) std::fflush(stderr);
+    return n;
+  }
+
+  void format_prefix(const detail::Slot& s) {
+    static const char kLevelChar[] = {'T', 'D', 'I', 'W', 'E', 'O'};
+    std::time_t sec = static_cast<std::time_t>(s.ts_ns / 1000000000);
+    if (sec != cached_sec_) {
+      std::tm tm{};
+#ifdef _WIN32
+      localtime_s(&tm, &sec);
+#else
+      localtime_r(&sec, &tm);
+#endif
+      char buf[16];
+      std::strftime(buf, sizeof(buf), "%H:%M:%S", &tm);
+      cached_hms_ = buf;
+      cached_sec_ = sec;
+    }
+    char us[8];
+    std::snprintf(us, sizeof(us), ".%06d", static_cast<int>((s.ts_ns / 1000) % 1000000));
+    line_ << cached_hms_ << us << ' ' << kLevelChar[static_cast<int>(s.level)] << ' ';
+  }
+
+  HugePageBuffer buf_;
+  Cell* cells_{nullptr};
+  alignas(64) std::atomic<size_t> enqueue_pos_{0};
+  alignas(64) size_t dequeue_pos_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<bool> stopped_{false};
+  std::ostringstream line_;
+  std::time_t cached_sec_{-1};
+  std::string cached_hms_;
+  std::thread worker_;
+};
+
+Logger& logger() {
+  static Logger inst;
+  return inst;
+}
+
+std::string lower(const std::string& s) {
+  std::string r(s);
+  std::transform(r.begin(), r.end(), r.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return r;
+}
+
+}  // namespace
+
+namespace detail {
+Slot* acquire() { return logger().acquire(); }
+void commit(Slot* s) { logger().commit(s); }
+int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch()).count();
+}
+}  // namespace detail
+
+bool parse_level(const std::string& s, Level* out) {
+  std::string v = lower(s);
+  Level lvl;
+  if (v == "trace") lvl = Level::Trace;
+  else if (v == "debug") lvl = Level::Debug;
+  else if (v == "info") lvl = Level::Info;
+  else if (v == "warn" || v == "warning") lvl = Level::Warn;
+  else if (v == "error") lvl = Level::Error;
+  else if (v == "off" || v == "none") lvl = Level::Off;
+  else return false;
+  if (out) *out = lvl;
+  return true;
+}
+
+void configure(const std::string& default_level,
+               const std::unordered_map<std::string, std::string>& component_levels) {
+  Level def = Level::Info;
+  if (!default_level.empty() && !parse_level(default_level, &def)) {
+    std::cerr << "[Log] unknown log_level=" << default_level << ", using info" << std::endl;
+  }
+  for (auto& l : g_levels) l.store(static_cast<int>(def), std::memory_order_relaxed);
+  for (const auto& kv : component_levels) {
+    std::string name = lower(kv.first);
+    Level lvl;
+    if (!parse_level(kv.second, &lvl)) {
+      std::cerr << "[Log] unknown level " << kv.second << " for component " << kv.first << std::endl;
+      continue;
+    }
+    bool found = false;
+    for (int i = 0; i < static_cast<int>(Component::Count); ++i) {
+      if (name == kComponentNames[i]) {
+        g_levels[i].store(static_cast<int>(lvl), std::memory_order_relaxed);
+        found = true;
+      }
+    }
+    if (!found) std::cerr << "[Log] unknown log component: " << kv.first << std::endl;
+  }
+}
+
+void shutdown() { logger().stop(); }
+
+uint64_t dropped() { return logger().dropped(); }
+
+}  // namespace log
+}  // namespace ts
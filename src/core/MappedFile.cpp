@@ -0,0 +1,174 @@
+#include "TradingSystem/MappedFile.h"
+#include <utility>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ts {
+
+MappedFile::~MappedFile() { close(); }
+
+MappedFile::MappedFile(MappedFile&& o) noexcept { *this = std::move(o); }
+
+MappedFile& MappedFile::operator=(MappedFile&& o) noexcept {
+  if (this != &o) {
+    close();
+    std::swap(data_, o.data_);
+    std::swap(size_, o.size_);
+    std::swap(opened_, o.opened_);
+#ifdef _WIN32
+    std::swap(file_, o.file_);
+    std::swap(mapping_, o.mapping_);
+#endif
+  }
+  return *this;
+}
+
+bool MappedFile::open(const std::string& path) {
+  close();
+#ifdef _WIN32
+  HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (f == INVALID_HANDLE_VALUE) return false;
+  LARGE_INTEGER sz;
+  if (!GetFileSizeEx(f, &sz)) { CloseHandle(f); return false; }
+  size_ = static_cast<size_t>(sz.QuadPart);
+  file_ = f;
+  opened_ = true;
+  if (size_ == 0) return true;
+  HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!m) { close(); return false; }
+  mapping_ = m;
+  data_ = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+  if (!data_) { close(); return false; }
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0) { ::close(fd); return false; }
+  size_ = static_cast<size_t>(st.st_size);
+  opened_ = true;
+  if (size_ > 0) {
+    void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) { ::close(fd); size_ = 0; opened_ = false; return false; }
+    // 顺序扫描为主，提示内核预读
+    madvise(p, size_, MADV_SEQUENTIAL);
+    data_ = p;
+  }
+  ::close(fd);
+#endif
+  return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+  if (data_) UnmapViewOfFile(data_);
+  if (mapping_) CloseHandle(static_cast<HANDLE>(mapping_));
+  if (file_) CloseHandle(static_cast<HANDLE>(file_));
+  mapping_ = nullptr;
+  file_ = nullptr;
+#else
+  if (data_) munmap(data_, size_);
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  opened_ = false;
+}
+
+WritableMappedFile::~WritableMappedFile() {
+  if (is_open()) close(size_);
+}
+
+bool WritableMappedFile::open(const std::string& path, size_t initial_size, bool keep) {
+  if (is_open()) close(size_);
+  size_t existing = 0;
+#ifdef _WIN32
+  HANDLE f = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                         keep ? OPEN_ALWAYS : CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (f == INVALID_HANDLE_VALUE) return false;
+  file_ = f;
+  LARGE_INTEGER sz;
+  if (keep && GetFileSizeEx(f, &sz)) existing = static_cast<size_t>(sz.QuadPart);
+#else
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | (keep ? 0 : O_TRUNC), 0644);
+  if (fd_ < 0) return false;
+  struct stat st;
+  if (keep && fstat(fd_, &st) == 0) existing = static_cast<size_t>(st.st_size);
+#endif
+  if (!map(existing > initial_size ? existing : initial_size)) {
+    close(0);
+    return false;
+  }
+  return true;
+}
+
+bool WritableMappedFile::reserve(size_t size) {
+  if (size <= size_) return true;
+  size_t next = size_ * 2;
+  if (next < size) next = size;
+  unmap();
+  return map(next);
+}
+
+// 扩展文件到size并映射；Windows下创建映射即扩展文件
+bool WritableMappedFile::map(size_t size) {
+  if (size == 0) return false;
+#ifdef _WIN32
+  const unsigned long long sz = size;
+  HANDLE m = CreateFileMappingA(static_cast<HANDLE>(file_), nullptr, PAGE_READWRITE, static_cast<DWORD>(sz >> 32),
+                                static_cast<DWORD>(sz & 0xFFFFFFFFu), nullptr);
+  if (!m) return false;
+  mapping_ = m;
+  data_ = MapViewOfFile(m, FILE_MAP_WRITE, 0, 0, 0);
+  if (!data_) {
+    CloseHandle(m);
+    mapping_ = nullptr;
+    return false;
+  }
+#else
+  if (ftruncate(fd_, static_cast<off_t>(size)) != 0) return false;
+  void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (p == MAP_FAILED) return false;
+  data_ = p;
+#endif
+  size_ = size;
+  return true;
+}
+
+void WritableMappedFile::unmap() {
+#ifdef _WIN32
+  if (data_) UnmapViewOfFile(data_);
+  if (mapping_) CloseHandle(static_cast<HANDLE>(mapping_));
+  mapping_ = nullptr;
+#else
+  if (data_) munmap(data_, size_);
+#endif
+  data_ = nullptr;
+  size_ = 0;
+}
+
+bool WritableMappedFile::close(size_t final_size) {
+  unmap();
+  bool ok = true;
+#ifdef _WIN32
+  if (!file_) return false;
+  LARGE_INTEGER pos;
+  pos.QuadPart = static_cast<LONGLONG>(final_size);
+  ok = SetFilePointerEx(static_cast<HANDLE>(file_), pos, nullptr, FILE_BEGIN) && SetEndOfFile(static_cast<HANDLE>(file_));
+  CloseHandle(static_cast<HANDLE>(file_));
+  file_ = nullptr;
+#else
+  if (fd_ < 0) return false;
+  ok = ftruncate(fd_, static_cast<off_t>(final_size)) == 0;
+  ok = (::close(fd_) == 0) && ok;
+  fd_ = -1;
+#endif
+  return ok;
+}
+
+} // namespace ts
@@ -0,0 +1,126 @@
+#include "TradingSystem/MarketDataStage.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <new>
+
+namespace ts {
+
+bool parse_md_policy(const std::string& s, MdPolicy* out) {
+  std::string v(s);
+  std::transform(v.begin(), v.end(), v.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  MdPolicy p;
+  if (v == "direct" || v == "none" || v.empty()) p = MdPolicy::Direct;
+  else if (v == "conflate") p = MdPolicy::Conflate;
+  else if (v == "queue") p = MdPolicy::Queue;
+  else if (v == "drop") p = MdPolicy::Drop;
+  else return false;
+  if (out) *out = p;
+  return true;
+}
+
+const char* md_policy_name(MdPolicy p) {
+  switch (p) {
+    case MdPolicy::Conflate: return "conflate";
+    case MdPolicy::Queue: return "queue";
+    case MdPolicy::Drop: return "drop";
+    default: return "direct";
+  }
+}
+
+MarketDataStage::MarketDataStage(MdPolicy policy, size_t max_instruments, size_t queue_capacity) : policy_(policy) {
+  if (policy_ == MdPolicy::Queue) {
+    size_t cap = 1;
+    while (cap < std::max<size_t>(queue_capacity, 2)) cap <<= 1;
+    if (!ring_.allocate(sizeof(Cell) * cap, ThreadManager::instance().huge_pages())) {
+      std::cerr << "[MDStage] queue allocation failed, falling back to conflate" << std::endl;
+      policy_ = MdPolicy::Conflate;
+    } else {
+      cells_ = static_cast<Cell*>(ring_.data());
+      for (size_t i = 0; i < cap; ++i) new (&cells_[i]) Cell{};
+      mask_ = cap - 1;
+    }
+  }
+  if (policy_ == MdPolicy::Conflate || policy_ == MdPolicy::Drop) {
+    nwords_ = (std::max<size_t>(max_instruments, 1) + 63) / 64;
+    nslots_ = nwords_ * 64;
+    slots_.reset(new Slot[nslots_]);
+    dirty_.reset(new std::atomic<uint64_t>[nwords_]);
+    for (size_t i = 0; i < nwords_; ++i) dirty_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+MarketDataStage::~MarketDataStage() {
+  if (cells_) {
+    for (size_t i = 0; i <= mask_; ++i) cells_[i].~Cell();
+  }
+}
+
+int MarketDataStage::slot_of(const std::string& instrument) {
+  auto it = ids_.find(instrument);
+  if (it != ids_.end()) return it->second;
+  if (ids_.size() >= nslots_) return -1;
+  int id = static_cast<int>(ids_.size());
+  ids_.emplace(instrument, id);
+  return id;
+}
+
+void MarketDataStage::publish(const MarketDataEvent& ev) {
+  if (closed_.load(std::memory_order_relaxed)) return;
+  published_.fetch_add(1, std::memory_order_relaxed);
+  if (policy_ == MdPolicy::Queue) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    unsigned spins = 0;
+    // 队列满：等待消费者腾出位置（反压到行情线程）
+    while (tail - head_.load(std::memory_order_acquire) > mask_) {
+      if (closed_.load(std::memory_order_acquire)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      idle_wait(ThreadManager::instance().wait_strategy(ThreadRole::Feed), spins);
+    }
+    cells_[tail & mask_].ev = ev;
+    tail_.store(tail + 1, std::memory_order_release);
+    return;
+  }
+
+  int id = slot_of(ev.instrument);
+  if (id < 0) {
+    if (!warned_full_) {
+      std::cerr << "[MDStage] instrument slots exhausted (" << nslots_ << "), dropping " << ev.instrument << std::endl;
+      warned_full_ = true;
+    }
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Slot& s = slots_[id];
+  lock(s);
+  const bool had = s.pending;
+  if (had && policy_ == MdPolicy::Drop) {
+    unlock(s);
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  s.ev = ev;  // 字符串复用已有容量，稳态下不分配
+  s.pending = true;
+  unlock(s);
+  if (had) {
+    conflated_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    dirty_[id >> 6].fetch_or(uint64_t(1) << (id & 63), std::memory_order_release);
+  }
+}
+
+bool MarketDataStage::take(size_t id, MarketDataEvent* out) {
+  Slot& s = slots_[id];
+  lock(s);
+  bool had = s.pending;
+  if (had) {
+    *out = s.ev;
+    s.pending = false;
+  }
+  unlock(s);
+  return had;
+}
+
+} // namespace ts
@@ -0,0 +1,62 @@
+#include "TradingSystem/MarketSnapshot.h"
+
+namespace ts {
+
+MarketSnapshot::MarketSnapshot(size_t reserve) {
+  ids_.reserve(reserve);
+  names_.reserve(reserve);
+  for (auto* v : {&bid_, &ask_, &last_, &volume_sum_}) v->reserve(reserve);
+  for (auto* v : {&bid_vol_, &ask_vol_, &volume_}) v->reserve(reserve);
+  ts_ms_.reserve(reserve);
+  update_seq_.reserve(reserve);
+  dirty_flag_.reserve(reserve);
+}
+
+int MarketSnapshot::add(const std::string& instrument) {
+  auto it = ids_.find(instrument);
+  if (it != ids_.end()) return it->second;
+  const int id = static_cast<int>(names_.size());
+  ids_.emplace(instrument, id);
+  names_.push_back(instrument);
+  for (auto* v : {&bid_, &ask_, &last_, &volume_sum_}) v->push_back(0.0);
+  for (auto* v : {&bid_vol_, &ask_vol_, &volume_}) v->push_back(0);
+  ts_ms_.push_back(0);
+  update_seq_.push_back(0);
+  dirty_flag_.push_back(0);
+  return id;
+}
+
+int MarketSnapshot::find(const std::string& instrument) const {
+  auto it = ids_.find(instrument);
+  return it == ids_.end() ? -1 : it->second;
+}
+
+int MarketSnapshot::update(const MarketDataEvent& ev, int64_t ev_ms) {
+  int id = last_id_;
+  if (id < 0 || names_[static_cast<size_t>(id)] != ev.instrument) {
+    id = add(ev.instrument);
+    last_id_ = id;
+  }
+  const size_t i = static_cast<size_t>(id);
+  bid_[i] = ev.bid_price;
+  ask_[i] = ev.ask_price;
+  last_[i] = ev.last_price;
+  bid_vol_[i] = ev.bid_volume;
+  ask_vol_[i] = ev.ask_volume;
+  volume_[i] = ev.volume;
+  volume_sum_[i] += ev.volume;
+  ts_ms_[i] = ev_ms;
+  update_seq_[i] = ++seq_;
+  if (!dirty_flag_[i]) {
+    dirty_flag_[i] = 1;
+    dirty_.push_back(id);
+  }
+  return id;
+}
+
+void MarketSnapshot::clear_dirty() {
+  for (int32_t id : dirty_) dirty_flag_[static_cast<size_t>(id)] = 0;
+  dirty_.clear();
+}
+
+} // namespace ts
@@ -0,0 +1,153 @@
+#include "TradingSystem/MetricsExporter.h"
+#include "TradingSystem/MetricsRegistry.h"
+#include "TradingSystem/ThreadManager.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+using socket_t = SOCKET;
+#define TS_INVALID_SOCKET INVALID_SOCKET
+#define TS_CLOSE_SOCKET closesocket
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using socket_t = int;
+#define TS_INVALID_SOCKET (-1)
+#define TS_CLOSE_SOCKET ::close
+#endif
+
+namespace ts {
+
+MetricsExporter::MetricsExporter(int port, int snapshot_sec, std::string snapshot_path)
+    : port_(port), snapshot_sec_(snapshot_sec), snapshot_path_(std::move(snapshot_path)) {}
+
+MetricsExporter::~MetricsExporter() { stop(); }
+
+bool MetricsExporter::open_listener() {
+#ifdef _WIN32
+  WSADATA wsa;
+  if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+  socket_t s = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (s == TS_INVALID_SOCKET) return false;
+  int one = 1;
+  ::setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&one), sizeof(one));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(port_));
+  // 仅监听回环地址
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (::bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(s, 8) != 0) {
+    TS_CLOSE_SOCKET(s);
+    return false;
+  }
+  listen_fd_ = static_cast<long long>(s);
+  return true;
+}
+
+bool MetricsExporter::start() {
+  if (port_ <= 0 && (snapshot_sec_ <= 0 || snapshot_path_.empty())) return false;
+  if (port_ > 0) {
+    if (!open_listener()) {
+      std::cerr << "[Metrics] cannot listen on 127.0.0.1:" << port_ << std::endl;
+      port_ = 0;
+    } else {
+      std::cout << "[Metrics] serving http://127.0.0.1:" << port_ << "/metrics" << std::endl;
+    }
+  }
+  if (snapshot_sec_ > 0 && !snapshot_path_.empty()) {
+    std::cout << "[Metrics] snapshot every " << snapshot_sec_ << "s -> " << snapshot_path_ << std::endl;
+  }
+  running_.store(true);
+  worker_ = std::thread(&MetricsExporter::run, this);
+  return true;
+}
+
+void MetricsExporter::stop() {
+  if (!running_.exchange(false)) return;
+  if (worker_.joinable()) worker_.join();
+  if (listen_fd_ >= 0) {
+    TS_CLOSE_SOCKET(static_cast<socket_t>(listen_fd_));
+    listen_fd_ = -1;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+  }
+  if (snapshot_sec_ > 0 && !snapshot_path_.empty()) write_snapshot();
+}
+
+void MetricsExporter::write_snapshot() {
+  std::string body = MetricsRegistry::instance().render_prometheus();
+  std::string tmp = snapshot_path_ + ".tmp";
+  std::FILE* f = std::fopen(tmp.c_str(), "wb");
+  if (!f) return;
+  bool ok = std::fwrite(body.data(), 1, body.size(), f) == body.size();
+  ok = (std::fclose(f) == 0) && ok;
+  std::error_code ec;
+  if (ok) std::filesystem::rename(tmp, snapshot_path_, ec);
+  else std::filesystem::remove(tmp, ec);
+}
+
+void MetricsExporter::serve_one() {
+  socket_t c = ::accept(static_cast<socket_t>(listen_fd_), nullptr, nullptr);
+  if (c == TS_INVALID_SOCKET) return;
+  // 读掉请求头（不解析路径，任意GET都返回全部指标）；客户端不发送时最多等待500ms
+#ifdef _WIN32
+  DWORD tmo = 500;
+  ::setsockopt(c, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&tmo), sizeof(tmo));
+#else
+  timeval tmo{0, 500000};
+  ::setsockopt(c, SOL_SOCKET, SO_RCVTIMEO, &tmo, sizeof(tmo));
+#endif
+  char req[1024];
+  ::recv(c, req, sizeof(req), 0);
+  std::string body = MetricsRegistry::instance().render_prometheus();
+  std::string resp = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                     std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+  size_t off = 0;
+  while (off < resp.size()) {
+    int n = ::send(c, resp.data() + off, static_cast<int>(resp.size() - off), 0);
+    if (n <= 0) break;
+    off += static_cast<size_t>(n);
+  }
+  TS_CLOSE_SOCKET(c);
+}
+
+void MetricsExporter::run() {
+  // 与日志线程同属后台角色，共用其CPU，不占引擎与行情核
+  ThreadManager::instance().enter(ThreadRole::Logger);
+  using clock = std::chrono::steady_clock;
+  auto next_snap = clock::now() + std::chrono::seconds(snapshot_sec_ > 0 ? snapshot_sec_ : 1);
+  while (running_.load()) {
+    // 以200ms为粒度等待连接，兼顾停止响应与快照周期
+    bool readable = false;
+    if (listen_fd_ >= 0) {
+#ifdef _WIN32
+      fd_set rd;
+      FD_ZERO(&rd);
+      FD_SET(static_cast<socket_t>(listen_fd_), &rd);
+      timeval tv{0, 200000};
+      readable = ::select(0, &rd, nullptr, nullptr, &tv) > 0;
+#else
+      pollfd p{static_cast<int>(listen_fd_), POLLIN, 0};
+      readable = ::poll(&p, 1, 200) > 0 && (p.revents & POLLIN);
+#endif
+    } else {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    if (readable) serve_one();
+    if (snapshot_sec_ > 0 && !snapshot_path_.empty() && clock::now() >= next_snap) {
+      write_snapshot();
+      next_snap += std::chrono::seconds(snapshot_sec_);
+    }
+  }
+}
+
+} // namespace ts
@@ -0,0 +1,229 @@
+#include "TradingSystem/MetricsRegistry.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+namespace ts {
+
+struct MetricsRegistry::Shard {
+  alignas(64) metrics_detail::Cell cells[metrics_detail::kCellsPerShard];
+  bool in_use{false};
+  Shard() {
+    for (auto& c : cells) c.store(0, std::memory_order_relaxed);
+  }
+};
+
+namespace {
+// 线程退出时归还分片；分片内的累计值保留，由下一个线程继续累加
+struct ShardLease {
+  MetricsRegistry::Shard* shard{nullptr};
+  ~ShardLease() {
+    if (shard) MetricsRegistry::instance().release_shard(shard);
+    metrics_detail::tls_cells = nullptr;
+  }
+};
+thread_local ShardLease tls_lease;
+
+void append_number(std::string* out, double v) {
+  char buf[32];
+  if (std::isnan(v)) {
+    out->append("NaN");
+  } else if (std::isinf(v)) {
+    out->append(v > 0 ? "+Inf" : "-Inf");
+  } else {
+    std::snprintf(buf, sizeof(buf), "%.17g", v);
+    out->append(buf);
+  }
+}
+
+void append_series(std::string* out, const std::string& name, const std::string& labels, const std::string& extra) {
+  out->append(name);
+  if (!labels.empty() || !extra.empty()) {
+    out->push_back('{');
+    out->append(labels);
+    if (!labels.empty() && !extra.empty()) out->push_back(',');
+    out->append(extra);
+    out->push_back('}');
+  }
+  out->push_back(' ');
+}
+} // namespace
+
+namespace metrics_detail {
+std::atomic<uint64_t>* acquire_shard() {
+  return MetricsRegistry::instance().acquire_shard_cells();
+}
+} // namespace metrics_detail
+
+MetricsRegistry& MetricsRegistry::instance() {
+  // 有意不析构：进程退出时仍可能有线程或导出线程访问
+  static MetricsRegistry* r = new MetricsRegistry();
+  return *r;
+}
+
+MetricsRegistry::MetricsRegistry() = default;
+
+std::atomic<uint64_t>* MetricsRegistry::acquire_shard_cells() {
+  std::lock_guard<std::mutex> lk(mu_);
+  Shard* s = nullptr;
+  for (auto& p : shards_) {
+    if (!p->in_use) { s = p.get(); break; }
+  }
+  if (!s) {
+    shards_.emplace_back(new Shard());
+    s = shards_.back().get();
+  }
+  s->in_use = true;
+  tls_lease.shard = s;
+  metrics_detail::tls_cells = s->cells;
+  return s->cells;
+}
+
+void MetricsRegistry::release_shard(Shard* s) {
+  std::lock_guard<std::mutex> lk(mu_);
+  s->in_use = false;
+}
+
+const MetricsRegistry::Entry* MetricsRegistry::find(const std::string& name, const std::string& labels,
+                                                    Kind kind) const {
+  for (const auto& e : entries_) {
+    if (e.kind == kind && e.name == name && e.labels == labels) return &e;
+  }
+  return nullptr;
+}
+
+Counter MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (const Entry* e = find(name, labels, Kind::Counter)) return Counter(e->id);
+  if (next_cell_ + 1 > metrics_detail::kCellsPerShard) {
+    std::cerr << "[Metrics] cell capacity exhausted, dropping " << name << std::endl;
+    return Counter();
+  }
+  entries_.push_back(Entry{name, help, labels, Kind::Counter, next_cell_});
+  return Counter(next_cell_++);
+}
+
+Gauge MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (const Entry* e = find(name, labels, Kind::Gauge)) return Gauge(e->id);
+  if (next_gauge_ >= metrics_detail::kMaxGauges) {
+    std::cerr << "[Metrics] gauge capacity exhausted, dropping " << name << std::endl;
+    return Gauge();
+  }
+  entries_.push_back(Entry{name, help, labels, Kind::Gauge, next_gauge_});
+  return Gauge(next_gauge_++);
+}
+
+void MetricsRegistry::gauge_fn(const std::string& name, const std::string& help, std::function<double()> fn,
+                               const std::string& labels) {
+  std::lock_guard<std::mutex> lk(mu_);
+  // 同名同标签覆盖旧回调（如引擎重复运行）
+  for (auto& e : entries_) {
+    if (e.kind == Kind::GaugeFn && e.name == name && e.labels == labels) { e.fn = std::move(fn); return; }
+  }
+  Entry e{name, help, labels, Kind::GaugeFn, 0};
+  e.fn = std::move(fn);
+  entries_.push_back(std::move(e));
+}
+
+void MetricsRegistry::remove_gauge_fn(const std::string& name, const std::string& labels) {
+  std::lock_guard<std::mutex> lk(mu_);
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->kind == Kind::GaugeFn && it->name == name && it->labels == labels) { entries_.erase(it); return; }
+  }
+}
+
+Histogram MetricsRegistry::histogram(const std::string& name, const std::string& help, double scale,
+                                     const std::string& labels) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (const Entry* e = find(name, labels, Kind::Histogram)) return Histogram(e->id);
+  const uint32_t need = Histogram::kHistBuckets + 1;
+  if (next_cell_ + need > metrics_detail::kCellsPerShard) {
+    std::cerr << "[Metrics] cell capacity exhausted, dropping " << name << std::endl;
+    return Histogram();
+  }
+  Entry e{name, help, labels, Kind::Histogram, next_cell_};
+  e.scale = scale > 0.0 ? scale : 1.0;
+  entries_.push_back(std::move(e));
+  next_cell_ += need;
+  return Histogram(next_cell_ - need);
+}
+
+std::string MetricsRegistry::label(const std::string& key, const std::string& value) {
+  std::string out = key + "=\"";
+  for (char c : value) {
+    if (c == '\\' || c == '"') { out.push_back('\\'); out.push_back(c); }
+    else if (c == '\n') out.append("\\n");
+    else out.push_back(c);
+  }
+  out.push_back('"');
+  return out;
+}
+
+uint64_t MetricsRegistry::sum_cell(uint32_t id) const {
+  uint64_t v = 0;
+  for (const auto& s : shards_) v += s->cells[id].load(std::memory_order_relaxed);
+  return v;
+}
+
+std::string MetricsRegistry::render_prometheus() {
+  std::string out;
+  out.reserve(8192);
+  std::lock_guard<std::mutex> lk(mu_);
+  // 同名不同标签的序列共用一组 HELP/TYPE，按首次注册顺序输出
+  std::vector<bool> done(entries_.size(), false);
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    if (done[i]) continue;
+    const Entry& head = entries_[i];
+    const char* type = head.kind == Kind::Counter ? "counter" : head.kind == Kind::Histogram ? "histogram" : "gauge";
+    out.append("# HELP ").append(head.name).append(" ").append(head.help).append("\n");
+    out.append("# TYPE ").append(head.name).append(" ").append(type).append("\n");
+    for (size_t j = i; j < entries_.size(); ++j) {
+      const Entry& e = entries_[j];
+      if (done[j] || e.name != head.name) continue;
+      done[j] = true;
+      switch (e.kind) {
+        case Kind::Counter:
+          append_series(&out, e.name, e.labels, "");
+          out.append(std::to_string(sum_cell(e.id))).append("\n");
+          break;
+        case Kind::Gauge:
+          append_series(&out, e.name, e.labels, "");
+          append_number(&out, metrics_detail::g_gauges[e.id].v.load(std::memory_order_relaxed));
+          out.append("\n");
+          break;
+        case Kind::GaugeFn:
+          append_series(&out, e.name, e.labels, "");
+          append_number(&out, e.fn ? e.fn() : 0.0);
+          out.append("\n");
+          break;
+        case Kind::Histogram: {
+          uint64_t cum = 0;
+          for (uint32_t b = 0; b < Histogram::kHistBuckets; ++b) {
+            cum += sum_cell(e.id + b);
+            std::string le = "le=\"";
+            if (b + 1 == Histogram::kHistBuckets) {
+              le += "+Inf";
+            } else {
+              char buf[32];
+              std::snprintf(buf, sizeof(buf), "%.17g", std::ldexp(1.0, static_cast<int>(b)) / e.scale);
+              le += buf;
+            }
+            le += "\"";
+            append_series(&out, e.name + "_bucket", e.labels, le);
+            out.append(std::to_string(cum)).append("\n");
+          }
+          append_series(&out, e.name + "_sum", e.labels, "");
+          append_number(&out, static_cast<double>(sum_cell(e.id + Histogram::kHistBuckets)) / e.scale);
+          out.append("\n");
+          append_series(&out, e.name + "_count", e.labels, "");
+          out.append(std::to_string(cum)).append("\n");
+          break;
+        }
+      }
+    }
+  }
+  return out;
+}
+
+} // namespace ts
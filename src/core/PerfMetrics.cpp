@@ -0,0 +1,155 @@
+#include "TradingSystem/PerfMetrics.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+namespace ts {
+namespace {
+const char* kAllMetrics[] = {"total_ret", "ann_ret", "win_rate", "pls_ratio", "max_dd",
+                             "dd_duration", "sharpe", "calmar", "trade_count", "avg_hold_secs"};
+constexpr double kSecPerYear = 365.0 * 86400.0;
+
+bool has_format(const std::vector<std::string>& fmts, const char* f) {
+  if (fmts.empty()) return std::string(f) == "csv";
+  for (auto s : fmts) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (s == f) return true;
+  }
+  return false;
+}
+} // namespace
+
+PerfMetrics::PerfMetrics(PerfMetricsConfig cfg) : cfg_(std::move(cfg)) {
+  if (cfg_.sample_sec < 1) cfg_.sample_sec = 1;
+  if (cfg_.initial_capital <= 0.0) cfg_.initial_capital = 1.0;
+  for (const auto& m : cfg_.metrics) {
+    if (std::find(std::begin(kAllMetrics), std::end(kAllMetrics), m) != std::end(kAllMetrics)) names_.push_back(m);
+    else std::cerr << "[Metrics] unknown metric ignored: " << m << std::endl;
+  }
+  if (cfg_.metrics.empty()) names_.assign(std::begin(kAllMetrics), std::end(kAllMetrics));
+  peak_ = cfg_.initial_capital;
+  last_sample_equity_ = cfg_.initial_capital;
+}
+
+void PerfMetrics::on_fill(const std::string& instrument, int64_t ts_ms, int open_qty, double realized) {
+  if (first_ts_ < 0) first_ts_ = ts_ms;
+  auto& s = inst_[instrument];
+  ++fills_;
+  double t = rel_sec(ts_ms);
+  int delta = open_qty - s.open_qty;
+  const bool closing = delta < 0 && s.open_qty > 0;
+  if (delta > 0) {
+    s.entry_ts_qty += delta * t;
+  } else if (closing) {
+    // 平仓：按加权平均开仓时间计算持仓时长
+    int q = std::min(-delta, s.open_qty);
+    double avg_entry = s.entry_ts_qty / s.open_qty;
+    hold_qty_secs_ += q * (t - avg_entry);
+    closed_qty_ += q;
+    s.entry_ts_qty -= q * avg_entry;
+  }
+  s.open_qty = open_qty;
+  // 胜负只按平仓成交统计；开仓手续费留到下一次平仓一并计入该笔盈亏
+  if (!closing) return;
+  double r = realized - s.realized;
+  s.realized = realized;
+  if (r > 0.0) { ++wins_; win_sum_ += r; }
+  else if (r < 0.0) { ++losses_; loss_sum_ -= r; }
+}
+
+void PerfMetrics::on_mark(const std::string& instrument, int64_t ts_ms, double inst_pnl) {
+  if (first_ts_ < 0) first_ts_ = ts_ms;
+  auto& s = inst_[instrument];
+  total_pnl_ += inst_pnl - s.pnl;
+  s.pnl = inst_pnl;
+  observe(ts_ms);
+}
+
+void PerfMetrics::observe(int64_t ts_ms) {
+  last_ts_ = std::max(last_ts_, ts_ms);
+  double equity = cfg_.initial_capital + total_pnl_;
+  if (peak_ts_ < 0) peak_ts_ = ts_ms;
+  if (equity >= peak_) {
+    peak_ = equity;
+    peak_ts_ = ts_ms;
+  } else {
+    max_dd_ = std::max(max_dd_, (peak_ - equity) / peak_);
+    max_dd_secs_ = std::max(max_dd_secs_, static_cast<double>(ts_ms - peak_ts_) / 1000.0);
+  }
+  // 事件时间采样：跨过采样边界时记录一次区间收益
+  const int64_t period = static_cast<int64_t>(cfg_.sample_sec) * 1000;
+  if (next_sample_ts_ < 0) {
+    next_sample_ts_ = ts_ms + period;
+    last_sample_equity_ = equity;
+  } else if (ts_ms >= next_sample_ts_) {
+    double r = last_sample_equity_ != 0.0 ? equity / last_sample_equity_ - 1.0 : 0.0;
+    ++n_samples_;
+    double d = r - mean_;
+    mean_ += d / static_cast<double>(n_samples_);
+    m2_ += d * (r - mean_);
+    last_sample_equity_ = equity;
+    next_sample_ts_ = ts_ms - (ts_ms - next_sample_ts_) % period + period;
+  }
+}
+
+double PerfMetrics::value(const std::string& metric) const {
+  const double equity = cfg_.initial_capital + total_pnl_;
+  const double total_ret = equity / cfg_.initial_capital - 1.0;
+  const double elapsed = (first_ts_ >= 0 && last_ts_ > first_ts_) ? (last_ts_ - first_ts_) / 1000.0 : 0.0;
+  auto ann_ret = [&]() {
+    if (elapsed <= 0.0 || total_ret <= -1.0) return 0.0;
+    return std::pow(1.0 + total_ret, kSecPerYear / elapsed) - 1.0;
+  };
+  if (metric == "total_ret") return total_ret;
+  if (metric == "ann_ret") return ann_ret();
+  if (metric == "win_rate") return (wins_ + losses_) > 0 ? static_cast<double>(wins_) / (wins_ + losses_) : 0.0;
+  if (metric == "pls_ratio") {
+    if (wins_ == 0 || losses_ == 0) return 0.0;
+    return (win_sum_ / wins_) / (loss_sum_ / losses_);
+  }
+  if (metric == "max_dd") return max_dd_;
+  if (metric == "dd_duration") {
+    // 末尾仍处于回撤中时计入当前回撤时长
+    double open_dd = (equity < peak_ && last_ts_ >= 0) ? (last_ts_ - peak_ts_) / 1000.0 : 0.0;
+    return std::max(max_dd_secs_, open_dd);
+  }
+  if (metric == "sharpe") {
+    if (n_samples_ < 2 || elapsed <= 0.0) return 0.0;
+    double sd = std::sqrt(m2_ / static_cast<double>(n_samples_ - 1));
+    if (sd <= 0.0) return 0.0;
+    double per_year = n_samples_ / (elapsed / kSecPerYear);
+    return mean_ / sd * std::sqrt(per_year);
+  }
+  if (metric == "calmar") return max_dd_ > 0.0 ? ann_ret() / max_dd_ : 0.0;
+  if (metric == "trade_count") return static_cast<double>(fills_);
+  if (metric == "avg_hold_secs") return closed_qty_ > 0 ? hold_qty_secs_ / closed_qty_ : 0.0;
+  return std::numeric_limits<double>::quiet_NaN();
+}
+
+void PerfMetrics::write_report(const std::string& dir) const {
+  if (has_format(cfg_.formats, "csv")) {
+    std::ofstream ofs(dir + "/metrics.csv");
+    if (ofs) {
+      ofs << "metric,value\n";
+      for (const auto& m : names_) ofs << m << "," << value(m) << "\n";
+    } else {
+      std::cerr << "[Metrics] cannot write " << dir << "/metrics.csv" << std::endl;
+    }
+  }
+  if (has_format(cfg_.formats, "html")) {
+    std::ofstream ofs(dir + "/report.html");
+    if (ofs) {
+      ofs << "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>Backtest Report</title></head><body>\n"
+          << "<h1>Backtest Report</h1>\n<table border=\"1\" cellpadding=\"4\">\n<tr><th>metric</th><th>value</th></tr>\n";
+      for (const auto& m : names_) ofs << "<tr><td>" << m << "</td><td>" << value(m) << "</td></tr>\n";
+      ofs << "</table>\n</body></html>\n";
+    } else {
+      std::cerr << "[Metrics] cannot write " << dir << "/report.html" << std::endl;
+    }
+  }
+}
+
+} // namespace ts
@@ -0,0 +1,32 @@
+#include "TradingSystem/ReplayClock.h"
+#include "TradingSystem/ThreadManager.h"
+#include <algorithm>
+#include <thread>
+
+namespace ts {
+
+ReplayClock::ReplayClock(double speed, int64_t max_gap_ms, int spin_us)
+    : speed_(speed > 0.0 ? speed : 1.0), max_gap_ms_(max_gap_ms > 0 ? max_gap_ms : 0), spin_(std::max(0, spin_us)) {}
+
+void ReplayClock::wait_until_event(int64_t event_ms) {
+  if (event_ms < 0) return;
+  if (!anchored_) {
+    anchored_ = true;
+    anchor_wall_ = Clock::now();
+    last_event_ms_ = event_ms;
+    elapsed_us_ = 0.0;
+    return;
+  }
+  int64_t gap = event_ms - last_event_ms_;
+  if (gap <= 0) return;
+  last_event_ms_ = event_ms;
+  if (max_gap_ms_ > 0) gap = std::min(gap, max_gap_ms_);
+  elapsed_us_ += static_cast<double>(gap) * 1000.0 / speed_;
+  const auto target = anchor_wall_ + std::chrono::microseconds(static_cast<int64_t>(elapsed_us_));
+  auto now = Clock::now();
+  if (target - now > spin_) std::this_thread::sleep_until(target - spin_);
+  unsigned spins = 0;
+  while (Clock::now() < target) idle_wait(WaitStrategy::Spin, spins);
+}
+
+} // namespace ts
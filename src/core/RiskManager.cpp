@@ -1,25 +1,54 @@
 #include "TradingSystem/RiskManager.h"
+#include "TradingSystem/LiveConfig.h"
+#include "TradingSystem/Log.h"
+#include "TradingSystem/SessionCalendar.h"
+#include "TradingSystem/TimeUtil.h"
 #include <algorithm>
-#include <iostream>
 
 namespace ts {
-RiskManager::RiskManager(RiskConfig cfg) : cfg_(cfg) {}
+RiskManager::RiskManager(RiskConfig cfg)
+    : cfg_(cfg),
+      pending_gauge_(MetricsRegistry::instance().gauge("ts_risk_pending_orders", "Orders tracked by risk awaiting a final status")) {
+  default_meta_.finalize(false);
+}
+
+Counter& RiskManager::reject_counter(const char* reason) {
+  auto it = reject_counters_.find(reason);
+  if (it != reject_counters_.end()) return it->second;
+  Counter c = MetricsRegistry::instance().counter("ts_risk_rejects_total", "Orders rejected by pre-trade risk checks",
+                                                  MetricsRegistry::label("reason", reason));
+  return reject_counters_.emplace(reason, c).first->second;
+}
 
 bool RiskManager::can_place(const OrderRequest& req, std::string* reject_reason) {
   const auto& inst = req.instrument;
   auto now = std::chrono::steady_clock::now();
+  const LiveParams* live = live_ ? live_->current() : nullptr;
+  const RiskConfig& cfg = live ? live->risk : cfg_;
+  // 交易时段
+  if (calendar_) {
+    const TradingSessions* ss = calendar_->find(inst);
+    auto st = last_sec_.find(inst);
+    if (ss && st != last_sec_.end() && st->second >= 0 && !ss->contains_sec(st->second)) {
+      if (reject_reason) *reject_reason = "Outside trading session";
+      reject_counter("Outside trading session").inc();
+      return false;
+    }
+  }
   // 每Bar限单
   int used = orders_this_bar_[inst];
-  if (used >= cfg_.max_orders_per_bar) {
+  if (used >= cfg.max_orders_per_bar) {
     if (reject_reason) *reject_reason = "Exceeded max orders per bar";
+    reject_counter("Exceeded max orders per bar").inc();
     return false;
   }
   // 最小间隔
   auto it = last_order_time_.find(inst);
   if (it != last_order_time_.end()) {
     auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(now - it->second).count();
-    if (diff < cfg_.min_order_interval_ms) {
+    if (diff < cfg.min_order_interval_ms) {
       if (reject_reason) *reject_reason = "Order interval too short";
+      reject_counter("Order interval too short").inc();
       return false;
     }
   }
@@ -29,8 +58,9 @@ bool RiskManager::can_place(const OrderRequest& req, std::string* reject_reason)
     int cur = pos_[inst];
     // 买开视为+1，卖开视为-1；限制绝对值
     int trial = cur + (req.direction == Direction::Buy ? 1 : -1);
-    if (std::abs(trial) > cfg_.max_pos_per_instrument) {
+    if (std::abs(trial) > cfg.max_pos_per_instrument) {
       if (reject_reason) *reject_reason = "Exceeded max position per instrument";
+      reject_counter("Exceeded max position per instrument").inc();
       return false;
     }
   }
@@ -48,82 +78,144 @@ void RiskManager::on_new_bar(const std::string& instrument) {
 
 void RiskManager::register_order(const std::string& order_id, const OrderRequest& req) {
   pending_orders_[order_id] = req;
+  pending_gauge_.set(static_cast<double>(pending_orders_.size()));
+}
+
+bool RiskManager::can_modify(const std::string& order_id, double new_price, int new_qty, std::string* reject_reason) {
+  (void)new_price;
+  auto it = pending_orders_.find(order_id);
+  if (it == pending_orders_.end()) {
+    if (reject_reason) *reject_reason = "Unknown or completed order";
+    reject_counter("Unknown or completed order").inc();
+    return false;
+  }
+  if (new_qty <= 0) {
+    if (reject_reason) *reject_reason = "Invalid modify quantity";
+    reject_counter("Invalid modify quantity").inc();
+    return false;
+  }
+  if (calendar_) {
+    const auto& inst = it->second.instrument;
+    const TradingSessions* ss = calendar_->find(inst);
+    auto st = last_sec_.find(inst);
+    if (ss && st != last_sec_.end() && st->second >= 0 && !ss->contains_sec(st->second)) {
+      if (reject_reason) *reject_reason = "Outside trading session";
+      reject_counter("Outside trading session").inc();
+      return false;
+    }
+  }
+  return true;
+}
+
+const OrderRequest* RiskManager::pending_request(const std::string& order_id) const {
+  auto it = pending_orders_.find(order_id);
+  return it == pending_orders_.end() ? nullptr : &it->second;
+}
+
+void RiskManager::on_order_modified(const std::string& order_id, const std::string& new_id, const OrderRequest& req) {
+  if (new_id == order_id) {
+    // 原地改单：改价后在调用内同步成交的订单已随Filled移除，不再挂回
+    auto it = pending_orders_.find(order_id);
+    if (it != pending_orders_.end()) it->second = req;
+  } else {
+    // 撤单+新单：旧单保留至其终态回报（撤单确认前的成交照常结算），新单另行登记；
+    // 旧单若已成交，渠道对新单回报Rejected，登记随之移除
+    pending_orders_[new_id] = req;
+  }
+  pending_gauge_.set(static_cast<double>(pending_orders_.size()));
 }
 
 void RiskManager::on_order_status(const OrderStatusEvent& ev) {
   auto it = pending_orders_.find(ev.order_id);
   if (it == pending_orders_.end()) {
-    std::cerr << "[Risk] unmatched order_id=" << ev.order_id
-              << " status=" << ev.status
-              << " inst=" << ev.instrument << std::endl;
+    TS_LOG_WARN(Risk, "[Risk] unmatched order_id=", ev.order_id, " status=", ev.status, " inst=", ev.instrument);
     return;
   }
   const OrderRequest& req = it->second;
   const auto& inst = req.instrument;
-  // 根据结构化字段更新持仓与盈亏，支持部分成交
+  // 根据结构化字段更新持仓与盈亏，支持部分成交；成本与盈亏全程整数运算
   if ((ev.status == "Filled" || ev.status == "PartiallyFilled") && ev.filled_qty > 0) {
+    const InstrumentMeta& m = meta_of(inst);
     int qty = ev.filled_qty;
-    double px = ev.fill_price;
+    const int64_t px = m.to_units(ev.fill_price);
     int delta = (req.direction == Direction::Buy ? qty : -qty);
     auto &d = pos_detail_[inst];
     auto &p = pnl_[inst];
+    // 换日后今仓转为昨仓
+    if (p.trading_day != trading_day_) {
+      p.long_today_qty = 0;
+      p.short_today_qty = 0;
+      p.trading_day = trading_day_;
+    }
     if (req.offset == Offset::Open) {
       pos_[inst] += delta;
       if (req.direction == Direction::Buy) {
         d.long_qty += qty;
         p.long_open_qty += qty;
-        p.long_open_cost_sum += qty * px;
+        p.long_today_qty += qty;
+        p.long_open_cost += px * qty;
       } else {
         d.short_qty += qty;
         p.short_open_qty += qty;
-        p.short_open_cost_sum += qty * px;
+        p.short_today_qty += qty;
+        p.short_open_cost += px * qty;
       }
+      p.fees += m.fee(m.fee_open_fp, px, qty);
     } else { // Close
       pos_[inst] -= delta; // 对冲减少净持仓
-      if (req.direction == Direction::Buy) {
-        // 平空：以平均空头成本结算
-        int avail = std::max(0, p.short_open_qty);
-        double avg_short = (avail > 0 ? p.short_open_cost_sum / avail : 0.0);
-        int used = std::min(qty, avail);
-        p.realized_pnl += used * (avg_short - px);
-        // 更新空头库存
-        p.short_open_qty = std::max(0, avail - used);
-        p.short_open_cost_sum = std::max(0.0, p.short_open_cost_sum - used * avg_short);
-        // 明细减少空头
-        d.short_qty = std::max(0, d.short_qty - used);
-      } else {
-        // 平多：以平均多头成本结算
-        int avail = std::max(0, p.long_open_qty);
-        double avg_long = (avail > 0 ? p.long_open_cost_sum / avail : 0.0);
-        int used = std::min(qty, avail);
-        p.realized_pnl += used * (px - avg_long);
-        // 更新多头库存
-        p.long_open_qty = std::max(0, avail - used);
-        p.long_open_cost_sum = std::max(0.0, p.long_open_cost_sum - used * avg_long);
-        // 明细减少多头
-        d.long_qty = std::max(0, d.long_qty - used);
-      }
+      const bool close_short = (req.direction == Direction::Buy);
+      int& open_qty = close_short ? p.short_open_qty : p.long_open_qty;
+      int64_t& open_cost = close_short ? p.short_open_cost : p.long_open_cost;
+      int& today_qty = close_short ? p.short_today_qty : p.long_today_qty;
+      // 以库存均价结算：按比例扣减成本，平完最后一手时成本恰好归零
+      int avail = std::max(0, open_qty);
+      int used = std::min(qty, avail);
+      const int64_t cost = (used == avail) ? open_cost : div_round(open_cost * used, avail);
+      const int64_t pnl_units = close_short ? (cost - px * used) : (px * used - cost);
+      p.realized += pnl_units * m.money_per_unit;
+      open_qty = avail - used;
+      open_cost -= cost;
+      // 先平昨仓，不足部分按平今收费
+      const int from_today = std::max(0, used - (avail - std::min(today_qty, avail)));
+      today_qty = std::max(0, std::min(today_qty, avail) - from_today);
+      p.fees += m.fee(m.fee_close_fp, px, used - from_today) + m.fee(m.fee_close_today_fp, px, from_today);
+      // 明细减少对应方向持仓
+      if (close_short) d.short_qty = std::max(0, d.short_qty - used);
+      else d.long_qty = std::max(0, d.long_qty - used);
     }
+    p.realized_pnl = static_cast<double>(p.realized - p.fees) / kMoneyScale;
+    p.long_avg_cost = p.long_open_qty > 0 ? m.to_price(p.long_open_cost) / p.long_open_qty : 0.0;
+    p.short_avg_cost = p.short_open_qty > 0 ? m.to_price(p.short_open_cost) / p.short_open_qty : 0.0;
   }
   if (ev.status == "Filled") {
     pending_orders_.erase(it);
   } else if (ev.status == "Canceled" || ev.status == "Rejected") {
     pending_orders_.erase(it);
   }
+  pending_gauge_.set(static_cast<double>(pending_orders_.size()));
 }
 
 void RiskManager::on_market_data(const MarketDataEvent& ev) {
   if (ev.instrument.empty()) return;
   last_price_[ev.instrument] = ev.last_price;
-  // 计算并更新未实现盈亏（基于最新价与库存均价）
+  if (calendar_ || instruments_) {
+    int64_t ms = parse_datetime_ms(ev.update_time);
+    if (ms >= 0) trading_day_ = trading_day(ms);
+    if (calendar_) {
+      if (ms < 0) ms = parse_time_of_day_ms(ev.update_time);
+      last_sec_[ev.instrument] = ms >= 0 ? seconds_of_day(ms) : -1;
+    }
+  }
+  // 计算并更新未实现盈亏（基于最新价与库存成本）
   auto pit = pnl_.find(ev.instrument);
   if (pit != pnl_.end()) {
     auto &p = pit->second;
-    double last = ev.last_price;
-    double long_avg = (p.long_open_qty > 0 ? p.long_open_cost_sum / p.long_open_qty : 0.0);
-    double short_avg = (p.short_open_qty > 0 ? p.short_open_cost_sum / p.short_open_qty : 0.0);
-    p.unrealized_pnl = (last - long_avg) * static_cast<double>(std::max(0, p.long_open_qty))
-                     + (short_avg - last) * static_cast<double>(std::max(0, p.short_open_qty));
+    const InstrumentMeta& m = meta_of(ev.instrument);
+    const int64_t last = m.to_units(ev.last_price);
+    const int64_t units = (last * std::max(0, p.long_open_qty) - p.long_open_cost)
+                        + (p.short_open_cost - last * std::max(0, p.short_open_qty));
+    p.unrealized = units * m.money_per_unit;
+    p.unrealized_pnl = static_cast<double>(p.unrealized) / kMoneyScale;
   }
 }
 
@@ -0,0 +1,93 @@
+#include "TradingSystem/ScenarioReplica.h"
+#include "TradingSystem/BacktestTrader.h"
+#include "TradingSystem/TraderProxy.h"
+#include <fstream>
+#include <iostream>
+
+namespace ts {
+
+ScenarioReplica::ScenarioReplica(std::string name, std::vector<HostedStrategy> strategies)
+    : name_(std::move(name)), host_(std::move(strategies)) {}
+
+ScenarioReplica::~ScenarioReplica() = default;
+
+bool ScenarioReplica::start(const std::string& meta_path, const std::string& rules_path, const MatchingOverrides& rules,
+                            const RiskConfig& risk_cfg, const PerfMetricsConfig& pm_cfg,
+                            const SessionCalendar* calendar, const InstrumentTable* instruments) {
+  rules_ = rules;
+  risk_.reset(new RiskManager(risk_cfg));
+  risk_->set_session_calendar(calendar);
+  risk_->set_instruments(instruments);
+  metrics_.reset(new PerfMetrics(pm_cfg));
+  auto matcher = std::make_unique<BacktestTrader>();
+  matcher->configure(meta_path, rules_path);
+  matcher->override_rules(rules_);
+  matcher_ = matcher.get();
+  trader_.reset(new TraderProxy(std::move(matcher), risk_.get()));
+  trader_->set_order_status_handler([this](const OrderStatusEvent& ev) { on_order_status(ev); });
+  if (!trader_->connect("backtest") || !trader_->login("", "", "")) {
+    std::cerr << "[Scenario] " << name_ << ": trader login failed\n";
+    return false;
+  }
+  host_.bind_trader(trader_.get());
+  host_.on_start();
+  return true;
+}
+
+void ScenarioReplica::on_tick(const MarketDataEvent& ev, int64_t ev_ms) {
+  host_.advance_timers(ev_ms);
+  risk_->on_market_data(ev);
+  host_.on_market_data(ev);
+  matcher_->on_market_data(ev);
+  last_event_ms_ = ev_ms;
+  auto pit = risk_->pnl_info().find(ev.instrument);
+  if (pit != risk_->pnl_info().end()) {
+    metrics_->on_mark(ev.instrument, ev_ms, pit->second.realized_pnl + pit->second.unrealized_pnl);
+  }
+}
+
+void ScenarioReplica::on_bar(const BarEvent& bar) {
+  risk_->on_new_bar(bar.instrument);
+  host_.on_bar(bar);
+}
+
+void ScenarioReplica::stop() { host_.on_stop(); }
+
+void ScenarioReplica::on_order_status(const OrderStatusEvent& ev) {
+  if ((ev.status == "Filled" || ev.status == "PartiallyFilled") && ev.filled_qty > 0 && !ev.instrument.empty()) {
+    auto& s = stats_[ev.instrument];
+    s.first += ev.filled_qty;
+    s.second += ev.filled_qty * ev.fill_price;
+    auto pit = risk_->pnl_info().find(ev.instrument);
+    if (pit != risk_->pnl_info().end()) {
+      const auto& p = pit->second;
+      metrics_->on_fill(ev.instrument, last_event_ms_, p.long_open_qty + p.short_open_qty, p.realized_pnl);
+    }
+  }
+  host_.on_order_status(ev);
+}
+
+void ScenarioReplica::write_reports(const std::string& dir) const {
+  metrics_->write_report(dir);
+  std::ofstream sum(dir + "/trade_summary.csv");
+  if (sum) {
+    sum << "instrument,total_qty,avg_price\n";
+    for (const auto& kv : stats_) {
+      double avg = (kv.second.first > 0 ? kv.second.second / kv.second.first : 0.0);
+      sum << kv.first << "," << kv.second.first << "," << avg << "\n";
+    }
+  }
+  std::ofstream pnl(dir + "/pnl.csv");
+  if (pnl) {
+    pnl << "instrument,realized_pnl,unrealized_pnl,long_open_qty,long_avg_cost,short_open_qty,short_avg_cost\n";
+    for (const auto& kv : risk_->pnl_info()) {
+      const auto& info = kv.second;
+      double long_avg = info.long_avg_cost;
+      double short_avg = info.short_avg_cost;
+      pnl << kv.first << "," << info.realized_pnl << "," << info.unrealized_pnl << "," << info.long_open_qty << ","
+          << long_avg << "," << info.short_open_qty << "," << short_avg << "\n";
+    }
+  }
+}
+
+} // namespace ts
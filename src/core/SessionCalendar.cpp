@@ -0,0 +1,121 @@
+#include "TradingSystem/SessionCalendar.h"
+#include "TradingSystem/ConfigUtil.h"
+#include "TradingSystem/TimeUtil.h"
+#include <algorithm>
+#include <iostream>
+
+namespace ts {
+namespace {
+// "HH:MM" 或 "HH:MM:SS" -> 日内秒；失败返回-1
+int parse_hms(const std::string& s) {
+  int h = 0, m = 0, sec = 0;
+  size_t n = s.size();
+  auto dig = [&](size_t i) { return i < n && s[i] >= '0' && s[i] <= '9'; };
+  if (!(dig(0) && dig(1) && n > 2 && s[2] == ':' && dig(3) && dig(4))) return -1;
+  h = (s[0] - '0') * 10 + (s[1] - '0');
+  m = (s[3] - '0') * 10 + (s[4] - '0');
+  if (n >= 8 && s[5] == ':' && dig(6) && dig(7)) sec = (s[6] - '0') * 10 + (s[7] - '0');
+  else if (n != 5) return -1;
+  if (h > 24 || m > 59 || sec > 59) return -1;
+  int v = h * 3600 + m * 60 + sec;
+  return v <= kSecPerDay ? v : -1;
+}
+
+std::string strip(const std::string& s) {
+  size_t b = s.find_first_not_of(" \t");
+  if (b == std::string::npos) return std::string();
+  size_t e = s.find_last_not_of(" \t");
+  return s.substr(b, e - b + 1);
+}
+} // namespace
+
+bool TradingSessions::contains_ms(int64_t ms) const {
+  return contains_sec(seconds_of_day(ms));
+}
+
+int64_t TradingSessions::bar_start_ms(int64_t ms, int interval_sec) const {
+  int sec = seconds_of_day(ms);
+  if (!contains_sec(sec)) return -1;
+  if (interval_sec <= 0) interval_sec = 1;
+  for (const auto& seg : segments) {
+    int s = sec;
+    // 夜盘凌晨部分：折算到前一日时段起点之后
+    if (seg.end > kSecPerDay && s < seg.start) s += kSecPerDay;
+    if (s < seg.start || s > seg.end) continue;
+    int off = s - seg.start;
+    // 收盘秒并入最后一根Bar
+    if (s == seg.end && off > 0) off -= 1;
+    int bucket = off / interval_sec * interval_sec;
+    int64_t sec_floor_ms = ms - ((ms % kMsPerSecond) + kMsPerSecond) % kMsPerSecond;
+    return sec_floor_ms - static_cast<int64_t>(s - seg.start - bucket) * kMsPerSecond;
+  }
+  return -1;
+}
+
+bool SessionCalendar::add(const std::string& instrument, const std::string& spec) {
+  TradingSessions compiled;
+  size_t b = 0;
+  while (b <= spec.size()) {
+    size_t e = spec.find(',', b);
+    std::string part = strip(spec.substr(b, e == std::string::npos ? std::string::npos : e - b));
+    b = (e == std::string::npos) ? spec.size() + 1 : e + 1;
+    if (part.empty()) continue;
+    size_t dash = part.find('-');
+    if (dash == std::string::npos) return false;
+    int s = parse_hms(strip(part.substr(0, dash)));
+    int t = parse_hms(strip(part.substr(dash + 1)));
+    if (s < 0 || t < 0 || s == t) return false;
+    if (s == kSecPerDay) s = 0;
+    // 结束早于开始即跨越午夜（如 21:00-02:30）
+    if (t < s) t += kSecPerDay;
+    compiled.segments.push_back({s, t});
+    for (int x = s; x <= t; ++x) compiled.open.set(static_cast<size_t>(x % kSecPerDay));
+  }
+  if (compiled.segments.empty()) return false;
+  std::sort(compiled.segments.begin(), compiled.segments.end(),
+            [](const TradingSessions::Segment& a, const TradingSessions::Segment& b) { return a.start < b.start; });
+  sessions_[instrument] = std::move(compiled);
+  return true;
+}
+
+size_t SessionCalendar::load_meta(const std::string& meta_path) {
+  std::string doc;
+  if (meta_path.empty() || !read_text_file(meta_path, &doc)) return 0;
+  std::vector<std::string> objs;
+  json_objects(doc, &objs);
+  size_t n = 0;
+  for (const auto& o : objs) {
+    std::string inst, spec;
+    if (!json_string(o, "instrument", &inst) || !json_string(o, "session", &spec)) continue;
+    if (add(inst, spec)) {
+      ++n;
+    } else {
+      std::cerr << "[Session] invalid session for " << inst << ": " << spec << std::endl;
+    }
+  }
+  return n;
+}
+
+uint64_t SessionCalendar::fingerprint() const {
+  uint64_t sum = 0;
+  for (const auto& kv : sessions_) {
+    // FNV-1a 64位：合约名与各时段起止
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](unsigned char c) { h ^= c; h *= 1099511628211ULL; };
+    for (unsigned char c : kv.first) mix(c);
+    for (const auto& seg : kv.second.segments) {
+      for (int v : {seg.start, seg.end}) {
+        for (int k = 0; k < 4; ++k) mix(static_cast<unsigned char>(static_cast<uint32_t>(v) >> (8 * k)));
+      }
+    }
+    sum += h;
+  }
+  return sum;
+}
+
+const TradingSessions* SessionCalendar::find(const std::string& instrument) const {
+  auto it = sessions_.find(instrument);
+  return it == sessions_.end() ? nullptr : &it->second;
+}
+
+} // namespace ts
@@ -0,0 +1,89 @@
+#include "TradingSystem/StrategyFactory.h"
+#include <iostream>
+#include <map>
+#include <sstream>
+
+namespace ts {
+namespace {
+std::map<std::string, StrategyFactory::Creator>& registry() {
+  static std::map<std::string, StrategyFactory::Creator> r;
+  return r;
+}
+
+// strategy_type=python_embed且编译了嵌入解释器时由PythonStrategy承载
+bool python_embedded(const AppConfig& cfg) {
+  return cfg.strategy_type == "python_embed" && registry().count("PythonStrategy") > 0;
+}
+} // namespace
+
+bool StrategyFactory::register_strategy(const std::string& name, Creator creator) {
+  return registry().emplace(name, std::move(creator)).second;
+}
+
+std::unique_ptr<Strategy> StrategyFactory::create(const std::string& name, const AppConfig& cfg) {
+  auto it = registry().find(name);
+  if (it == registry().end()) return nullptr;
+  return it->second(cfg);
+}
+
+std::unique_ptr<Strategy> StrategyFactory::create_from_config(const AppConfig& cfg) {
+  std::string name = cfg.builtin_class;
+  if (cfg.strategy_type == "python_embed") {
+    if (python_embedded(cfg)) {
+      name = "PythonStrategy";
+    } else {
+      std::cerr << "[StrategyFactory] python_embed not compiled in (build with -DUSE_PY_EMBED=ON), using "
+                << cfg.builtin_class << std::endl;
+    }
+  }
+  auto s = create(name, cfg);
+  if (!s) {
+    std::cerr << "[StrategyFactory] unknown strategy: " << name << ", registered:";
+    for (const auto& n : registered()) std::cerr << " " << n;
+    std::cerr << std::endl;
+  }
+  return s;
+}
+
+bool StrategyFactory::create_hosted(const AppConfig& cfg, std::vector<HostedStrategy>* out) {
+  out->clear();
+  if (cfg.strategies.empty()) {
+    auto s = create_from_config(cfg);
+    if (!s) return false;
+    Subscription sub = s->subscription();
+    // 日志、trace与指标中的策略名：Python策略取模块.类名
+    std::string label = python_embedded(cfg) ? cfg.python_module + "." + cfg.python_class : cfg.builtin_class;
+    out->push_back(HostedStrategy{std::move(label), std::move(s), std::move(sub)});
+    return true;
+  }
+  for (const auto& spec : cfg.strategies) {
+    size_t at = spec.find('@');
+    std::string name = spec.substr(0, at);
+    auto s = create(name, cfg);
+    if (!s) {
+      std::cerr << "[StrategyFactory] unknown strategy: " << name << ", registered:";
+      for (const auto& n : registered()) std::cerr << " " << n;
+      std::cerr << std::endl;
+      return false;
+    }
+    Subscription sub = s->subscription();
+    if (at != std::string::npos) {
+      sub.instruments.clear();
+      std::stringstream ss(spec.substr(at + 1));
+      std::string inst;
+      while (std::getline(ss, inst, '|')) {
+        if (!inst.empty()) sub.instruments.push_back(inst);
+      }
+    }
+    out->push_back(HostedStrategy{spec, std::move(s), std::move(sub)});
+  }
+  return true;
+}
+
+std::vector<std::string> StrategyFactory::registered() {
+  std::vector<std::string> v;
+  for (const auto& kv : registry()) v.push_back(kv.first);
+  return v;
+}
+
+} // namespace ts
@@ -0,0 +1,294 @@
+#include "TradingSystem/StrategyHost.h"
+#include "TradingSystem/BarHistory.h"
+#include "TradingSystem/Log.h"
+#include "TradingSystem/Tracer.h"
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+
+namespace ts {
+
+// 单个策略看到的交易接口：下单经托管层登记归属后转发给底层交易
+class StrategyHost::StrategyTrader : public ITrader {
+ public:
+  StrategyTrader(StrategyHost* host, uint32_t idx) : host_(host), idx_(idx) {}
+  // 连接、登录与回调注册由引擎统一完成
+  bool connect(const std::string&) override { return true; }
+  bool login(const std::string&, const std::string&, const std::string&) override { return true; }
+  std::string place_order(const OrderRequest& req) override { return host_->place_for(idx_, req); }
+  bool cancel_order(const std::string& order_id) override {
+    return host_->trader_ ? host_->trader_->cancel_order(order_id) : false;
+  }
+  std::string modify_order(const std::string& order_id, double new_price, int new_qty) override {
+    return host_->modify_for(idx_, order_id, new_price, new_qty);
+  }
+  void set_order_status_handler(OrderStatusHandler) override {}
+
+ private:
+  StrategyHost* host_;
+  uint32_t idx_;
+};
+
+class StrategyHost::StrategyTimers : public ITimerService {
+ public:
+  StrategyTimers(StrategyHost* host, uint32_t idx) : host_(host), idx_(idx) {}
+  uint64_t schedule_timer(int64_t delay_ms, int64_t interval_ms, uint64_t user_data) override {
+    std::lock_guard<std::mutex> lk(host_->timer_mu_);
+    return host_->wheel_.schedule(host_->wheel_.now() + delay_ms, interval_ms, idx_, user_data);
+  }
+  bool cancel_timer(uint64_t timer_id) override {
+    std::lock_guard<std::mutex> lk(host_->timer_mu_);
+    return host_->wheel_.cancel(timer_id);
+  }
+  int64_t timer_now_ms() const override { return host_->timer_now_.load(std::memory_order_relaxed); }
+
+ private:
+  StrategyHost* host_;
+  uint32_t idx_;
+};
+
+struct StrategyHost::Slot {
+  HostedStrategy hosted;
+  StrategyTrader trader;
+  StrategyTimers timers;
+  const char* trace_tick;  // 时间线分段名：strategy.<名称>.tick/bar/order/timer
+  const char* trace_bar;
+  const char* trace_order;
+  const char* trace_timer;
+  Slot(HostedStrategy h, StrategyHost* host, uint32_t idx)
+      : hosted(std::move(h)), trader(host, idx), timers(host, idx) {
+    hosted.strategy->set_timer_service(&timers);
+    Tracer& t = Tracer::instance();
+    trace_timer = t.intern("strategy." + hosted.name + ".timer");
+    trace_tick = t.intern("strategy." + hosted.name + ".tick");
+    trace_bar = t.intern("strategy." + hosted.name + ".bar");
+    trace_order = t.intern("strategy." + hosted.name + ".order");
+  }
+};
+
+namespace {
+bool is_terminal(const std::string& status) {
+  return status == "Filled" || status == "Canceled" || status == "Rejected";
+}
+} // namespace
+
+StrategyHost::StrategyHost(std::vector<HostedStrategy> strategies) {
+  slots_.reserve(strategies.size());
+  for (auto& h : strategies) {
+    if (!h.strategy) continue;
+    uint32_t idx = static_cast<uint32_t>(slots_.size());
+    slots_.emplace_back(new Slot(std::move(h), this, idx));
+  }
+  // 预建路由表：按策略序号登记，同一合约内保持配置顺序
+  for (uint32_t i = 0; i < slots_.size(); ++i) {
+    const Subscription& sub = slots_[i]->hosted.sub;
+    if (sub.instruments.empty()) {
+      if (sub.events & kTickEvents) wildcard_.ticks.push_back(i);
+      if (sub.events & kBarEvents) wildcard_.bars.push_back(i);
+    }
+  }
+  for (uint32_t i = 0; i < slots_.size(); ++i) {
+    const Subscription& sub = slots_[i]->hosted.sub;
+    for (const auto& inst : sub.instruments) routes_.emplace(inst, Route{});
+  }
+  for (auto& kv : routes_) {
+    for (uint32_t i = 0; i < slots_.size(); ++i) {
+      const Subscription& sub = slots_[i]->hosted.sub;
+      bool hit = sub.instruments.empty() ||
+                 std::find(sub.instruments.begin(), sub.instruments.end(), kv.first) != sub.instruments.end();
+      if (!hit) continue;
+      if (sub.events & kTickEvents) kv.second.ticks.push_back(i);
+      if (sub.events & kBarEvents) kv.second.bars.push_back(i);
+    }
+  }
+  for (const auto& s : slots_) {
+    const Subscription& sub = s->hosted.sub;
+    std::cout << "[Host] strategy " << s->hosted.name << " instruments=";
+    if (sub.instruments.empty()) std::cout << "*";
+    for (size_t k = 0; k < sub.instruments.size(); ++k) std::cout << (k ? "|" : "") << sub.instruments[k];
+    std::cout << " events=" << ((sub.events & kTickEvents) ? "t" : "") << ((sub.events & kBarEvents) ? "b" : "")
+              << ((sub.events & kOrderEvents) ? "o" : "") << "\n";
+  }
+}
+
+StrategyHost::~StrategyHost() = default;
+
+void StrategyHost::bind_snapshot(const MarketSnapshot* snapshot) {
+  for (auto& s : slots_) s->hosted.strategy->set_market_snapshot(snapshot);
+}
+
+void StrategyHost::bind_live_config(const LiveConfig* live) {
+  for (auto& s : slots_) s->hosted.strategy->set_live_config(live);
+}
+
+std::vector<std::string> StrategyHost::subscribe_list(const std::vector<std::string>& base) const {
+  if (base.empty()) return {};
+  std::vector<std::string> out = base;
+  std::unordered_set<std::string> seen(base.begin(), base.end());
+  for (const auto& s : slots_) {
+    if (s->hosted.sub.instruments.empty()) continue;
+    for (const auto& inst : s->hosted.sub.instruments) {
+      if (seen.insert(inst).second) out.push_back(inst);
+    }
+  }
+  return out;
+}
+
+size_t StrategyHost::warm_up(BarHistory& history, const std::vector<std::string>& universe, int64_t end_ms) {
+  size_t total = 0;
+  std::vector<std::string> stored;
+  bool listed = false;
+  for (auto& s : slots_) {
+    Strategy& st = *s->hosted.strategy;
+    const size_t want = st.warmup_bars();
+    if (want == 0) continue;
+    const std::vector<std::string>* insts = &s->hosted.sub.instruments;
+    if (insts->empty()) insts = &universe;
+    if (insts->empty()) {
+      if (!listed) {
+        stored = history.instruments();
+        listed = true;
+      }
+      insts = &stored;
+    }
+    for (const auto& inst : *insts) {
+      size_t n = 0;
+      const BarRecord* bars = history.load(inst, &n, end_ms);
+      if (!bars || n == 0) continue;
+      const size_t take = std::min(n, want);
+      st.on_warmup(inst, bars + (n - take), take);
+      total += take;
+    }
+  }
+  return total;
+}
+
+void StrategyHost::on_start() {
+  for (auto& s : slots_) s->hosted.strategy->on_start(&s->trader);
+}
+
+void StrategyHost::on_stop() {
+  for (auto& s : slots_) s->hosted.strategy->on_stop(&s->trader);
+}
+
+const StrategyHost::Route& StrategyHost::route(const std::string& instrument) {
+  if (last_inst_ && *last_inst_ == instrument) return *last_route_;
+  auto it = routes_.find(instrument);
+  if (it == routes_.end()) it = routes_.emplace(instrument, wildcard_).first;
+  last_inst_ = &it->first;
+  last_route_ = &it->second;
+  return it->second;
+}
+
+void StrategyHost::on_market_data(const MarketDataEvent& ev) {
+  for (uint32_t i : route(ev.instrument).ticks) {
+    Slot& s = *slots_[i];
+    TS_TRACE_SCOPE("strategy", s.trace_tick);
+    s.hosted.strategy->on_market_data(ev, &s.trader);
+  }
+}
+
+void StrategyHost::on_bar(const BarEvent& bar) {
+  for (uint32_t i : route(bar.instrument).bars) {
+    Slot& s = *slots_[i];
+    TS_TRACE_SCOPE("strategy", s.trace_bar);
+    s.hosted.strategy->on_bar(bar, &s.trader);
+  }
+}
+
+void StrategyHost::advance_timers(int64_t now_ms) {
+  if (clock_set_ && now_ms <= timer_now_.load(std::memory_order_relaxed)) return;
+  {
+    std::lock_guard<std::mutex> lk(timer_mu_);
+    if (!clock_set_) {
+      wheel_.rebase(now_ms);
+      clock_set_ = true;
+    } else {
+      wheel_.advance(now_ms);
+    }
+    timer_now_.store(wheel_.now(), std::memory_order_relaxed);
+  }
+  for (;;) {
+    TimerWheel::Fired f;
+    {
+      std::lock_guard<std::mutex> lk(timer_mu_);
+      if (!wheel_.pop_ready(&f)) break;
+    }
+    Slot& s = *slots_[f.owner];
+    TS_TRACE_SCOPE_ALWAYS("strategy", s.trace_timer);
+    s.hosted.strategy->on_timer(f.id, f.user_data, &s.trader);
+  }
+}
+
+size_t StrategyHost::pending_timers() {
+  std::lock_guard<std::mutex> lk(timer_mu_);
+  return wheel_.size();
+}
+
+std::string StrategyHost::place_for(uint32_t idx, const OrderRequest& req) {
+  if (!trader_) return std::string();
+  // 持锁跨越底层下单：同步回调在本线程重入并按placing_归属；其他线程的回调等到ID登记后再查表
+  std::lock_guard<std::recursive_mutex> lk(order_mu_);
+  int prev = placing_;
+  placing_ = static_cast<int>(idx);
+  placing_done_id_.clear();
+  std::string id = trader_->place_order(req);
+  placing_ = prev;
+  if (!id.empty() && id != placing_done_id_) owner_[id] = idx;
+  placing_done_id_.clear();
+  return id;
+}
+
+std::string StrategyHost::modify_for(uint32_t idx, const std::string& order_id, double new_price, int new_qty) {
+  if (!trader_) return std::string();
+  // 与下单相同：渠道以撤单+新单实现时，新ID的同步回报按placing_归属到发起策略
+  std::lock_guard<std::recursive_mutex> lk(order_mu_);
+  int prev = placing_;
+  placing_ = static_cast<int>(idx);
+  placing_done_id_.clear();
+  std::string id = trader_->modify_order(order_id, new_price, new_qty);
+  placing_ = prev;
+  if (!id.empty() && id != order_id && id != placing_done_id_) owner_[id] = idx;
+  placing_done_id_.clear();
+  return id;
+}
+
+bool StrategyHost::wants_orders(uint32_t idx, const std::string& instrument) const {
+  const Subscription& sub = slots_[idx]->hosted.sub;
+  if (!(sub.events & kOrderEvents)) return false;
+  return sub.instruments.empty() || instrument.empty() ||
+         std::find(sub.instruments.begin(), sub.instruments.end(), instrument) != sub.instruments.end();
+}
+
+void StrategyHost::on_order_status(const OrderStatusEvent& ev) {
+  int owner = -1;
+  {
+    std::lock_guard<std::recursive_mutex> lk(order_mu_);
+    auto it = owner_.find(ev.order_id);
+    if (it != owner_.end()) {
+      owner = static_cast<int>(it->second);
+      if (is_terminal(ev.status)) owner_.erase(it);
+    } else if (placing_ >= 0) {
+      owner = placing_;
+      if (!is_terminal(ev.status)) owner_[ev.order_id] = static_cast<uint32_t>(owner);
+    }
+    if (placing_ >= 0 && is_terminal(ev.status)) placing_done_id_ = ev.order_id;
+  }
+  if (owner >= 0) {
+    Slot& s = *slots_[owner];
+    if (s.hosted.sub.events & kOrderEvents) {
+      TS_TRACE_SCOPE_ALWAYS("strategy", s.trace_order);
+      s.hosted.strategy->on_order_status(ev);
+    }
+    return;
+  }
+  // 归属未知（如外部下单）：按合约送达关心订单事件的策略
+  TS_LOG_DEBUG(Strategy, "[Host] unowned order_id=", ev.order_id, " inst=", ev.instrument);
+  for (uint32_t i = 0; i < slots_.size(); ++i) {
+    if (!wants_orders(i, ev.instrument)) continue;
+    TS_TRACE_SCOPE_ALWAYS("strategy", slots_[i]->trace_order);
+    slots_[i]->hosted.strategy->on_order_status(ev);
+  }
+}
+
+} // namespace ts
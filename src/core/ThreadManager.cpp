@@ -0,0 +1,149 @@
+#include "TradingSystem/ThreadManager.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ts {
+namespace {
+const char* kRoleNames[] = {"ts-feed", "ts-engine", "ts-logger"};
+thread_local const char* tls_role_name = nullptr;
+static_assert(sizeof(kRoleNames) / sizeof(kRoleNames[0]) == static_cast<size_t>(ThreadRole::Count),
+              "role name table out of sync");
+
+#ifndef _WIN32
+constexpr size_t kHugePageSize = 2u << 20;
+#endif
+} // namespace
+
+bool parse_wait_strategy(const std::string& s, WaitStrategy* out) {
+  std::string v(s);
+  std::transform(v.begin(), v.end(), v.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  WaitStrategy ws;
+  if (v == "block" || v == "sleep") ws = WaitStrategy::Block;
+  else if (v == "yield") ws = WaitStrategy::Yield;
+  else if (v == "spin" || v == "busy") ws = WaitStrategy::Spin;
+  else return false;
+  if (out) *out = ws;
+  return true;
+}
+
+ThreadManager& ThreadManager::instance() {
+  static ThreadManager inst;
+  return inst;
+}
+
+void ThreadManager::configure(const ThreadConfig& cfg) {
+  cfg_ = cfg;
+  unsigned ncpu = std::thread::hardware_concurrency();
+  for (int i = 0; i < static_cast<int>(ThreadRole::Count); ++i) {
+    if (cfg_.cpu[i] >= 0 && ncpu > 0 && static_cast<unsigned>(cfg_.cpu[i]) >= ncpu) {
+      std::cerr << "[Thread] cpu " << cfg_.cpu[i] << " for " << kRoleNames[i] << " out of range (" << ncpu
+                << " cpus), not pinning" << std::endl;
+      cfg_.cpu[i] = -1;
+    }
+  }
+}
+
+const char* ThreadManager::thread_name() { return tls_role_name; }
+
+void ThreadManager::enter(ThreadRole role) {
+  const int idx = static_cast<int>(role);
+  tls_role_name = kRoleNames[idx];
+  const int cpu = cfg_.cpu[idx];
+#ifdef _WIN32
+  if (cpu >= 0 && !SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu)) {
+    std::cerr << "[Thread] pin " << kRoleNames[idx] << " to cpu " << cpu << " failed" << std::endl;
+  }
+#elif defined(__linux__)
+  pthread_setname_np(pthread_self(), kRoleNames[idx]);
+  if (cpu >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+      std::cerr << "[Thread] pin " << kRoleNames[idx] << " to cpu " << cpu << " failed: " << std::strerror(rc) << std::endl;
+    }
+  }
+#else
+  if (cpu >= 0) std::cerr << "[Thread] cpu pinning not supported on this platform" << std::endl;
+#endif
+}
+
+HugePageBuffer::HugePageBuffer(HugePageBuffer&& o) noexcept { *this = std::move(o); }
+
+HugePageBuffer& HugePageBuffer::operator=(HugePageBuffer&& o) noexcept {
+  if (this != &o) {
+    release();
+    std::swap(data_, o.data_);
+    std::swap(size_, o.size_);
+    std::swap(mapped_, o.mapped_);
+    std::swap(huge_, o.huge_);
+  }
+  return *this;
+}
+
+bool HugePageBuffer::allocate(size_t bytes, bool want_huge) {
+  release();
+  if (bytes == 0) return false;
+#ifdef _WIN32
+  if (want_huge) {
+    SIZE_T large = GetLargePageMinimum();
+    if (large > 0) {
+      size_t len = (bytes + large - 1) / large * large;
+      data_ = VirtualAlloc(nullptr, len, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+      if (data_) { mapped_ = len; huge_ = true; }
+    }
+  }
+  if (!data_) {
+    data_ = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    mapped_ = bytes;
+  }
+#else
+  if (want_huge) {
+#ifdef MAP_HUGETLB
+    size_t len = (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) { data_ = p; mapped_ = len; huge_ = true; }
+#endif
+  }
+  if (!data_) {
+    // 大页池不可用：普通匿名映射，按大页对齐长度并建议内核使用透明大页
+    size_t len = want_huge ? (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize : bytes;
+    void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return false;
+#ifdef MADV_HUGEPAGE
+    if (want_huge) madvise(p, len, MADV_HUGEPAGE);
+#endif
+    data_ = p;
+    mapped_ = len;
+  }
+#endif
+  if (!data_) return false;
+  size_ = bytes;
+  return true;
+}
+
+void HugePageBuffer::release() {
+  if (!data_) return;
+#ifdef _WIN32
+  VirtualFree(data_, 0, MEM_RELEASE);
+#else
+  munmap(data_, mapped_);
+#endif
+  data_ = nullptr;
+  size_ = mapped_ = 0;
+  huge_ = false;
+}
+
+} // namespace ts
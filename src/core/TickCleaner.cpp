@@ -0,0 +1,419 @@
+#include "TradingSystem/TickCleaner.h"
+#include "TradingSystem/MappedFile.h"
+#include "TradingSystem/TimeUtil.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <queue>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ts {
+namespace {
+
+struct Rec {
+  std::string_view inst;
+  int64_t ts;
+  double last, bid, ask;
+  int64_t bid_vol, ask_vol, volume;
+  uint64_t line;  // 块内行号，归并后换算为全局行号
+};
+
+struct Issue {
+  uint64_t line;
+  std::string_view inst;
+  TickAnomaly type;
+};
+
+struct Chunk {
+  const char* begin;
+  const char* end;
+  std::vector<Rec> recs;
+  std::vector<Issue> issues;
+  uint64_t lines{0};
+  uint64_t base{0};  // 本块首行的全局行号-1
+};
+
+template <class T>
+bool parse_num(std::string_view s, T* out) {
+  while (!s.empty() && s.front() == ' ') s.remove_prefix(1);
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\r')) s.remove_suffix(1);
+  if (s.empty()) return false;
+  auto r = std::from_chars(s.data(), s.data() + s.size(), *out);
+  return r.ec == std::errc() && r.ptr == s.data() + s.size();
+}
+
+// 整数列也接受 "5.0" 这类写法
+bool parse_qty(std::string_view s, int64_t* out) {
+  if (parse_num(s, out)) return true;
+  double d = 0.0;
+  if (!parse_num(s, &d) || !std::isfinite(d)) return false;
+  *out = static_cast<int64_t>(d);
+  return true;
+}
+
+bool is_header(std::string_view line) {
+  return line.size() >= 11 && line.compare(0, 11, "instrument,") == 0;
+}
+
+void parse_chunk(Chunk* c) {
+  std::string_view all(c->begin, static_cast<size_t>(c->end - c->begin));
+  c->recs.reserve(all.size() / 64 + 1);
+  std::string_view cols[16];
+  size_t pos = 0;
+  uint64_t line_no = 0;
+  auto flag = [&](std::string_view inst, TickAnomaly t) { c->issues.push_back({line_no, inst, t}); };
+  while (pos < all.size()) {
+    size_t eol = all.find('\n', pos);
+    if (eol == std::string_view::npos) eol = all.size();
+    std::string_view line = all.substr(pos, eol - pos);
+    pos = eol + 1;
+    ++line_no;
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    if (line.empty() || is_header(line)) continue;
+    ++c->lines;
+    size_t nc = 0, b = 0;
+    while (nc < 16) {
+      size_t p = line.find(',', b);
+      cols[nc++] = line.substr(b, p == std::string_view::npos ? std::string_view::npos : p - b);
+      if (p == std::string_view::npos) break;
+      b = p + 1;
+    }
+    std::string_view inst = cols[0];
+    if (nc < 3 || inst.empty()) { flag(inst, TickAnomaly::Malformed); continue; }
+    Rec r{inst, -1, 0.0, 0.0, 0.0, 0, 0, 0, line_no};
+    bool ok = true;
+    if (nc >= 8 && (r.ts = parse_datetime_ms(cols[1])) >= 0) {
+      // 格式2：instrument,datetime,last,bid,ask,bid_vol,ask_vol,volume
+      ok = parse_num(cols[2], &r.last) && parse_qty(cols[7], &r.volume);
+      if (ok) {
+        if (!parse_num(cols[3], &r.bid)) r.bid = 0.0;
+        if (!parse_num(cols[4], &r.ask)) r.ask = 0.0;
+        if (!parse_qty(cols[5], &r.bid_vol)) r.bid_vol = 0;
+        if (!parse_qty(cols[6], &r.ask_vol)) r.ask_vol = 0;
+      }
+    } else {
+      // 格式1：instrument,last,volume[,bid,ask,update_time]；另兼容 instrument,last,volume,datetime
+      ok = parse_num(cols[1], &r.last) && parse_qty(cols[2], &r.volume);
+      if (ok) {
+        if (nc >= 6) r.ts = parse_datetime_ms(cols[5]);
+        if (r.ts < 0 && nc == 4) r.ts = parse_datetime_ms(cols[3]);
+        if (nc >= 5) {
+          if (!parse_num(cols[3], &r.bid)) r.bid = 0.0;
+          if (!parse_num(cols[4], &r.ask)) r.ask = 0.0;
+        }
+      }
+    }
+    if (!ok || r.volume < 0 || r.bid_vol < 0 || r.ask_vol < 0) { flag(inst, TickAnomaly::Malformed); continue; }
+    if (r.ts < 0) { flag(inst, TickAnomaly::NoTimestamp); continue; }
+    if (!(std::isfinite(r.last) && r.last > 0.0)) { flag(inst, TickAnomaly::BadPrice); continue; }
+    if (!std::isfinite(r.bid)) r.bid = 0.0;
+    if (!std::isfinite(r.ask)) r.ask = 0.0;
+    if (r.bid > 0.0 && r.ask > 0.0 && r.bid > r.ask) { flag(inst, TickAnomaly::Crossed); continue; }
+    if (r.bid <= 0.0 || r.ask <= 0.0) {
+      if (r.bid <= 0.0) r.bid = r.last;
+      if (r.ask <= 0.0) r.ask = r.last;
+      flag(inst, TickAnomaly::MissingQuote);
+    }
+    c->recs.push_back(r);
+  }
+}
+
+bool same_quote(const Rec& a, const Rec& b) {
+  return a.ts == b.ts && a.last == b.last && a.bid == b.bid && a.ask == b.ask && a.bid_vol == b.bid_vol &&
+         a.ask_vol == b.ask_vol && a.volume == b.volume;
+}
+
+// 顺序写出缓冲：满1MB落盘
+class OutBuf {
+ public:
+  explicit OutBuf(std::FILE* f) : f_(f) { buf_.reserve(kCap + 256); }
+  ~OutBuf() { flush(); }
+  void put(std::string_view s) { buf_.append(s.data(), s.size()); maybe_flush(); }
+  void put(char c) { buf_.push_back(c); }
+  template <class T>
+  void num(T v) {
+    char tmp[32];
+    auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    buf_.append(tmp, static_cast<size_t>(r.ptr - tmp));
+  }
+  void flush() {
+    if (!buf_.empty() && f_) std::fwrite(buf_.data(), 1, buf_.size(), f_);
+    buf_.clear();
+  }
+  void maybe_flush() { if (buf_.size() >= kCap) flush(); }
+
+ private:
+  static constexpr size_t kCap = 1 << 20;
+  std::FILE* f_;
+  std::string buf_;
+};
+
+} // namespace
+
+const char* tick_anomaly_name(TickAnomaly a) {
+  static const char* kNames[] = {"malformed", "no_timestamp", "bad_price", "crossed",
+                                 "missing_quote", "duplicate", "out_of_order"};
+  static_assert(sizeof(kNames) / sizeof(kNames[0]) == static_cast<size_t>(TickAnomaly::Count),
+                "anomaly name table out of sync");
+  return kNames[static_cast<int>(a)];
+}
+
+bool clean_tick_file(const std::string& src, const std::string& out_csv, const std::string& anomaly_csv,
+                     const TickCleanOptions& opts, TickCleanReport* report, std::string* err) {
+  auto t0 = std::chrono::steady_clock::now();
+  MappedFile mf;
+  if (!mf.open(src)) {
+    if (err) *err = "cannot open " + src;
+    return false;
+  }
+  // 1) 按行边界切块，并行解析与校验
+  unsigned nthreads = opts.threads ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+  const size_t min_chunk = 1 << 20;
+  nthreads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(nthreads, mf.size() / min_chunk + 1)));
+  std::vector<Chunk> chunks(nthreads);
+  const char* base = mf.data();
+  const char* end = base + mf.size();
+  const char* cur = base;
+  for (unsigned i = 0; i < nthreads; ++i) {
+    const char* stop = (i + 1 == nthreads) ? end : base + mf.size() * (i + 1) / nthreads;
+    if (stop < cur) stop = cur;
+    while (stop < end && stop > base && stop[-1] != '\n') ++stop;
+    chunks[i].begin = cur;
+    chunks[i].end = stop;
+    cur = stop;
+  }
+  {
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < nthreads; ++i) workers.emplace_back(parse_chunk, &chunks[i]);
+    parse_chunk(&chunks[0]);
+    for (auto& w : workers) w.join();
+  }
+  // 块内物理行号 -> 全局行号（以文件行计，含表头）
+  uint64_t line_base = 0;
+  for (auto& c : chunks) {
+    c.base = line_base;
+    line_base += static_cast<uint64_t>(std::count(c.begin, c.end, '\n'));
+    if (c.end > c.begin && c.end[-1] != '\n') ++line_base;
+  }
+  // 2) 分块内按时间稳定排序（并行），随后多路有序归并
+  if (opts.sort_by_time) {
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < nthreads; ++i) {
+      workers.emplace_back([&chunks, i] {
+        std::stable_sort(chunks[i].recs.begin(), chunks[i].recs.end(),
+                         [](const Rec& a, const Rec& b) { return a.ts < b.ts; });
+      });
+    }
+    std::stable_sort(chunks[0].recs.begin(), chunks[0].recs.end(), [](const Rec& a, const Rec& b) { return a.ts < b.ts; });
+    for (auto& w : workers) w.join();
+  }
+
+  TickCleanReport rep;
+  rep.threads = nthreads;
+  for (const auto& c : chunks) {
+    rep.lines += c.lines;
+    for (const auto& is : c.issues) ++rep.counts[static_cast<int>(is.type)];
+  }
+  // 3) 顺序归并并去重：只决定保留哪些记录，格式化另行并行
+  std::vector<const Rec*> kept;
+  std::vector<Issue> late;  // 归并阶段发现的异常（重复、乱序），行号已为全局
+  {
+    struct InstState {
+      const Rec* last{nullptr};
+      uint64_t max_line{0};
+    };
+    std::unordered_map<std::string_view, InstState> state;
+    size_t total = 0;
+    for (const auto& c : chunks) total += c.recs.size();
+    kept.reserve(total);
+    auto accept = [&](const Rec& r, uint64_t gline) {
+      InstState& st = state[r.inst];
+      if (st.last) {
+        if (opts.drop_duplicates && same_quote(r, *st.last)) {
+          late.push_back({gline, r.inst, TickAnomaly::Duplicate});
+          return;
+        }
+        bool out_of_order = opts.sort_by_time ? (gline < st.max_line) : (r.ts < st.last->ts);
+        if (out_of_order) {
+          late.push_back({gline, r.inst, TickAnomaly::OutOfOrder});
+          if (!opts.sort_by_time) return;
+        }
+      }
+      st.last = &r;
+      st.max_line = std::max(st.max_line, gline);
+      kept.push_back(&r);
+    };
+    if (opts.sort_by_time && nthreads > 1) {
+      // 堆顶为(时间, 块序号)最小者；同一时间按文件顺序输出
+      using Key = std::pair<int64_t, unsigned>;
+      std::priority_queue<Key, std::vector<Key>, std::greater<Key>> heap;
+      std::vector<size_t> idx(nthreads, 0);
+      for (unsigned i = 0; i < nthreads; ++i) {
+        if (!chunks[i].recs.empty()) heap.push({chunks[i].recs[0].ts, i});
+      }
+      while (!heap.empty()) {
+        unsigned i = heap.top().second;
+        heap.pop();
+        const Chunk& c = chunks[i];
+        const Rec& r = c.recs[idx[i]++];
+        accept(r, c.base + r.line);
+        if (idx[i] < c.recs.size()) heap.push({c.recs[idx[i]].ts, i});
+      }
+    } else {
+      for (const auto& c : chunks) {
+        for (const auto& r : c.recs) accept(r, c.base + r.line);
+      }
+    }
+  }
+  for (const auto& is : late) ++rep.counts[static_cast<int>(is.type)];
+  rep.kept = kept.size();
+
+  // 4) 按段并行格式化，再按序写出
+  std::FILE* out = std::fopen(out_csv.c_str(), "wb");
+  if (!out) {
+    if (err) *err = "cannot write " + out_csv;
+    return false;
+  }
+  {
+    std::vector<std::string> parts(nthreads);
+    auto format_range = [&kept, &parts, nthreads](unsigned k) {
+      size_t lo = kept.size() * k / nthreads, hi = kept.size() * (k + 1) / nthreads;
+      std::string& buf = parts[k];
+      buf.reserve((hi - lo) * 72);
+      int64_t cached_sec = INT64_MIN;
+      std::string cached;  // "YYYY-MM-DD HH:MM:SS"，同一秒内复用
+      char tmp[32];
+      auto num = [&](auto v) {
+        auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+        buf.append(tmp, static_cast<size_t>(r.ptr - tmp));
+      };
+      for (size_t i = lo; i < hi; ++i) {
+        const Rec& r = *kept[i];
+        int64_t sec = r.ts >= 0 ? r.ts / kMsPerSecond : (r.ts - kMsPerSecond + 1) / kMsPerSecond;
+        if (sec != cached_sec) {
+          cached = format_datetime_ms(sec * kMsPerSecond);
+          cached.resize(cached.size() - 4);
+          cached_sec = sec;
+        }
+        int ms = static_cast<int>(r.ts - sec * kMsPerSecond);
+        buf.append(r.inst.data(), r.inst.size());
+        buf.push_back(',');
+        buf.append(cached);
+        buf.push_back('.');
+        buf.push_back(static_cast<char>('0' + ms / 100));
+        buf.push_back(static_cast<char>('0' + ms / 10 % 10));
+        buf.push_back(static_cast<char>('0' + ms % 10));
+        buf.push_back(',');
+        num(r.last);
+        buf.push_back(',');
+        num(r.bid);
+        buf.push_back(',');
+        num(r.ask);
+        buf.push_back(',');
+        num(r.bid_vol);
+        buf.push_back(',');
+        num(r.ask_vol);
+        buf.push_back(',');
+        num(r.volume);
+        buf.push_back('\n');
+      }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned k = 1; k < nthreads; ++k) workers.emplace_back(format_range, k);
+    format_range(0);
+    for (auto& w : workers) w.join();
+    static const char kHeader[] = "instrument,datetime,last_price,bid_price,ask_price,bid_volume,ask_volume,volume\n";
+    std::fwrite(kHeader, 1, sizeof(kHeader) - 1, out);
+    for (const auto& p : parts) std::fwrite(p.data(), 1, p.size(), out);
+  }
+  std::fclose(out);
+
+  // 5) 异常明细：line,instrument,type,action
+  if (!anomaly_csv.empty()) {
+    std::FILE* af = std::fopen(anomaly_csv.c_str(), "wb");
+    if (!af) {
+      if (err) *err = "cannot write " + anomaly_csv;
+      return false;
+    }
+    std::vector<Issue> all;
+    for (const auto& c : chunks) {
+      for (auto is : c.issues) {
+        is.line += c.base;
+        all.push_back(is);
+      }
+    }
+    all.insert(all.end(), late.begin(), late.end());
+    std::stable_sort(all.begin(), all.end(), [](const Issue& a, const Issue& b) { return a.line < b.line; });
+    OutBuf ob(af);
+    ob.put("line,instrument,type,action\n");
+    for (const auto& is : all) {
+      const char* action = "dropped";
+      if (is.type == TickAnomaly::MissingQuote) action = "filled_from_last";
+      else if (is.type == TickAnomaly::OutOfOrder && opts.sort_by_time) action = "reordered";
+      ob.num(is.line);
+      ob.put(',');
+      ob.put(is.inst);
+      ob.put(',');
+      ob.put(tick_anomaly_name(is.type));
+      ob.put(',');
+      ob.put(action);
+      ob.put('\n');
+      ob.maybe_flush();
+    }
+    ob.flush();
+    std::fclose(af);
+  }
+  rep.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  if (report) *report = rep;
+  return true;
+}
+
+bool ensure_clean_ticks(const std::string& clean_dir, const std::string& src, std::string* out_path, std::string* err) {
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  fs::create_directories(clean_dir, ec);
+  auto src_size = fs::file_size(src, ec);
+  auto src_time = ec ? fs::file_time_type{} : fs::last_write_time(src, ec);
+  if (ec) {
+    if (err) *err = "cannot stat " + src;
+    return false;
+  }
+  // 以源文件(绝对路径+大小+修改时间)为键：同名源文件互不覆盖，源文件替换（含改回旧时间戳）后不会误用旧结果
+  std::string key = fs::absolute(src, ec).lexically_normal().string() + "|" + std::to_string(src_size) + "|" +
+                    std::to_string(static_cast<int64_t>(src_time.time_since_epoch().count()));
+  // FNV-1a 64位
+  uint64_t h = 1469598103934665603ULL;
+  for (unsigned char c : key) { h ^= c; h *= 1099511628211ULL; }
+  char hex[17];
+  std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(h));
+  std::string stem = fs::path(src).stem().string() + "." + hex;
+  fs::path out = fs::path(clean_dir) / (stem + ".clean.csv");
+  fs::path anomalies = fs::path(clean_dir) / (stem + ".anomalies.csv");
+  *out_path = out.string();
+  if (fs::is_regular_file(out, ec)) return true;
+  // 先写临时文件再改名，避免中断后留下半截数据被当作有效缓存
+  std::string tmp = out.string() + ".tmp";
+  TickCleanReport rep;
+  if (!clean_tick_file(src, tmp, anomalies.string(), TickCleanOptions{}, &rep, err)) return false;
+  fs::rename(tmp, out, ec);
+  if (ec) {
+    if (err) *err = "cannot rename " + tmp;
+    return false;
+  }
+  std::cout << "[Clean] " << src << " lines=" << rep.lines << " kept=" << rep.kept;
+  for (int i = 0; i < static_cast<int>(TickAnomaly::Count); ++i) {
+    if (rep.counts[i]) std::cout << " " << tick_anomaly_name(static_cast<TickAnomaly>(i)) << "=" << rep.counts[i];
+  }
+  std::cout << " ms=" << rep.elapsed_ms << " -> " << *out_path << std::endl;
+  return true;
+}
+
+} // namespace ts
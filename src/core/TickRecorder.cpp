@@ -0,0 +1,161 @@
+#include "TradingSystem/TickRecorder.h"
+#include "TradingSystem/TimeUtil.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace ts {
+
+TickRecorder::TickRecorder(std::string dir, size_t max_instruments, size_t queue_capacity)
+    : dir_(std::move(dir)), max_instruments_(max_instruments > 0 ? max_instruments : 1) {
+  size_t cap = 1024;
+  while (cap < queue_capacity) cap <<= 1;
+  ring_.allocate(cap * sizeof(TickRecord), ThreadManager::instance().huge_pages());
+  cells_ = static_cast<TickRecord*>(ring_.data());
+  mask_ = cap - 1;
+  names_.resize(max_instruments_);
+  seg_named_.assign(max_instruments_, false);
+  auto& r = MetricsRegistry::instance();
+  written_ = r.counter("ts_recorder_ticks_total", "Ticks written to the recorder segment files");
+  dropped_counter_ = r.counter("ts_recorder_dropped_total", "Ticks dropped by the recorder (queue full or table full)");
+}
+
+TickRecorder::~TickRecorder() { stop(); }
+
+bool TickRecorder::start() {
+  if (!cells_) {
+    std::cerr << "[Recorder] cannot allocate ring buffer" << std::endl;
+    return false;
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(dir_, ec);
+  if (ec) {
+    std::cerr << "[Recorder] cannot create " << dir_ << ": " << ec.message() << std::endl;
+    return false;
+  }
+  running_.store(true);
+  worker_ = std::thread([this] { run_loop(); });
+  std::cout << "[Recorder] recording to " << dir_ << " (" << (mask_ + 1) << " slots, " << max_instruments_
+            << " instruments)" << std::endl;
+  return true;
+}
+
+void TickRecorder::record(const MarketDataEvent& ev) {
+  if (closed_.load(std::memory_order_relaxed)) return;
+  auto it = ids_.find(ev.instrument);
+  if (it == ids_.end()) {
+    if (ids_.size() >= max_instruments_) {
+      if (!warned_full_.exchange(true)) {
+        std::cerr << "[Recorder] instrument table full (" << max_instruments_ << "), dropping " << ev.instrument
+                  << std::endl;
+      }
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      dropped_counter_.inc();
+      return;
+    }
+    const int32_t id = static_cast<int32_t>(ids_.size());
+    auto& name = names_[static_cast<size_t>(id)];
+    std::strncpy(name.data(), ev.instrument.c_str(), name.size() - 1);
+    it = ids_.emplace(ev.instrument, id).first;
+  }
+  const uint64_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) > mask_) {
+    // 写盘跟不上时丢弃，不反压行情线程
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    dropped_counter_.inc();
+    return;
+  }
+  TickRecord& r = cells_[tail & mask_];
+  int64_t ms = parse_datetime_ms(ev.update_time);
+  if (ms < 0) {
+    // 与引擎一致：行情不带完整日期时间时取本机时钟
+    ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+  r.ts_ms = ms;
+  r.last = ev.last_price;
+  r.bid = ev.bid_price;
+  r.ask = ev.ask_price;
+  r.inst = it->second;
+  r.volume = ev.volume;
+  r.bid_volume = ev.bid_volume;
+  r.ask_volume = ev.ask_volume;
+  tail_.store(tail + 1, std::memory_order_release);
+}
+
+void TickRecorder::stop() {
+  if (closed_.exchange(true)) return;
+  running_.store(false);
+  if (worker_.joinable()) worker_.join();
+  std::cout << "[Recorder] recorded=" << recorded() << " dropped=" << dropped() << std::endl;
+}
+
+void TickRecorder::rotate(int64_t day) {
+  if (seg_.is_open()) {
+    const uint64_t n = seg_.count();
+    if (!seg_.close()) std::cerr << "[Recorder] segment close failed" << std::endl;
+    else std::cout << "[Recorder] closed segment with " << n << " ticks" << std::endl;
+  }
+  // 交易日文件名YYYYMMDD；同日重启时追加序号，不覆盖已有段
+  std::string date = format_datetime_ms(day * kMsPerDay).substr(0, 10);
+  date.erase(7, 1);
+  date.erase(4, 1);
+  std::filesystem::path path = std::filesystem::path(dir_) / (date + ".ticks");
+  for (int k = 1; std::filesystem::exists(path); ++k) {
+    path = std::filesystem::path(dir_) / (date + "-" + std::to_string(k) + ".ticks");
+  }
+  seg_day_ = day;
+  seg_named_.assign(max_instruments_, false);
+  if (!seg_.open(path.string(), max_instruments_)) {
+    std::cerr << "[Recorder] cannot open segment " << path.string() << std::endl;
+    return;
+  }
+  std::cout << "[Recorder] segment " << path.string() << std::endl;
+}
+
+void TickRecorder::run_loop() {
+  unsigned idle = 0;
+  for (;;) {
+    // 先取运行标志：停止后再取空一次缓冲即全部写完
+    const bool running = running_.load(std::memory_order_acquire);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    const uint64_t tail = tail_.load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+      const TickRecord& r = cells_[head & mask_];
+      const int64_t day = trading_day(r.ts_ms);
+      // 只向后轮换：迟到的上一交易日行情仍写入当前段；打开失败的交易日不再重试
+      if (day > seg_day_) rotate(day);
+      if (!seg_.is_open()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        dropped_counter_.inc();
+        continue;
+      }
+      const size_t id = static_cast<size_t>(r.inst);
+      if (!seg_named_[id]) {
+        seg_.set_instrument(id, names_[id].data());
+        seg_named_[id] = true;
+      }
+      if (seg_.append(r)) {
+        written_.inc();
+        written_total_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    if (head != head_.load(std::memory_order_relaxed)) {
+      head_.store(head, std::memory_order_release);
+      // 每批回填笔数，已写部分随时可回放
+      seg_.commit();
+      idle = 0;
+      continue;
+    }
+    if (!running) break;
+    idle_wait(WaitStrategy::Block, idle);
+  }
+  if (seg_.is_open()) {
+    const uint64_t n = seg_.count();
+    if (!seg_.close()) std::cerr << "[Recorder] segment close failed" << std::endl;
+    else std::cout << "[Recorder] closed segment with " << n << " ticks" << std::endl;
+  }
+}
+
+} // namespace ts
@@ -0,0 +1,164 @@
+#include "TradingSystem/TickStore.h"
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+
+namespace ts {
+namespace {
+
+constexpr char kMagic[8] = {'T', 'S', 'T', 'I', 'C', 'K', '1', '\0'};
+constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t instrument_count;
+  uint64_t tick_count;
+};
+
+struct FileIndex {
+  char name[32];
+};
+
+} // namespace
+
+bool is_tick_store_path(const std::string& path) {
+  return std::filesystem::path(path).extension() == ".ticks";
+}
+
+TickStoreWriter::~TickStoreWriter() {
+  if (f_) close();
+}
+
+bool TickStoreWriter::open(const std::string& path, const std::vector<std::string>& instruments) {
+  if (f_) close();
+  path_ = path;
+  count_ = 0;
+  failed_ = false;
+  buf_.clear();
+  buf_.reserve(kBatch);
+  std::error_code ec;
+  auto parent = std::filesystem::path(path).parent_path();
+  if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+  // 先写临时文件再改名，避免并发读到半成品
+  f_ = std::fopen((path + ".tmp").c_str(), "wb");
+  if (!f_) return false;
+  FileHeader hdr{};
+  std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
+  hdr.version = kVersion;
+  hdr.instrument_count = static_cast<uint32_t>(instruments.size());
+  std::vector<FileIndex> index(instruments.size());
+  for (size_t i = 0; i < instruments.size(); ++i) {
+    std::memset(index[i].name, 0, sizeof(index[i].name));
+    std::strncpy(index[i].name, instruments[i].c_str(), sizeof(index[i].name) - 1);
+  }
+  if (std::fwrite(&hdr, sizeof(hdr), 1, f_) != 1 ||
+      (!index.empty() && std::fwrite(index.data(), sizeof(FileIndex), index.size(), f_) != index.size())) {
+    failed_ = true;
+  }
+  return !failed_;
+}
+
+void TickStoreWriter::flush() {
+  if (!f_ || buf_.empty()) return;
+  if (std::fwrite(buf_.data(), sizeof(TickRecord), buf_.size(), f_) != buf_.size()) failed_ = true;
+  count_ += buf_.size();
+  buf_.clear();
+}
+
+bool TickStoreWriter::close() {
+  if (!f_) return false;
+  flush();
+  // 回填笔数
+  if (std::fseek(f_, static_cast<long>(offsetof(FileHeader, tick_count)), SEEK_SET) != 0 ||
+      std::fwrite(&count_, sizeof(count_), 1, f_) != 1) {
+    failed_ = true;
+  }
+  if (std::fclose(f_) != 0) failed_ = true;
+  f_ = nullptr;
+  std::error_code ec;
+  if (failed_) {
+    std::filesystem::remove(path_ + ".tmp", ec);
+    return false;
+  }
+  std::filesystem::rename(path_ + ".tmp", path_, ec);
+  return !ec;
+}
+
+TickSegmentWriter::~TickSegmentWriter() {
+  if (is_open()) close();
+}
+
+bool TickSegmentWriter::open(const std::string& path, size_t max_instruments) {
+  if (is_open()) close();
+  max_instruments_ = max_instruments;
+  data_offset_ = sizeof(FileHeader) + max_instruments * sizeof(FileIndex);
+  count_ = 0;
+  failed_ = false;
+  std::error_code ec;
+  auto parent = std::filesystem::path(path).parent_path();
+  if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+  // 首段预留约1MB记录，之后按需翻倍扩展
+  if (!file_.open(path, data_offset_ + (size_t(1) << 20) / sizeof(TickRecord) * sizeof(TickRecord))) return false;
+  // 新扩展的文件内容为0：未登记的合约名为空串，读取端照常跳过
+  FileHeader hdr{};
+  std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
+  hdr.version = kVersion;
+  hdr.instrument_count = static_cast<uint32_t>(max_instruments);
+  std::memcpy(file_.data(), &hdr, sizeof(hdr));
+  return true;
+}
+
+void TickSegmentWriter::set_instrument(size_t id, const char* name) {
+  if (!is_open() || id >= max_instruments_) return;
+  auto* idx = reinterpret_cast<FileIndex*>(file_.data() + sizeof(FileHeader));
+  std::memset(idx[id].name, 0, sizeof(idx[id].name));
+  std::strncpy(idx[id].name, name, sizeof(idx[id].name) - 1);
+}
+
+bool TickSegmentWriter::append(const TickRecord& r) {
+  const size_t end = data_offset_ + (count_ + 1) * sizeof(TickRecord);
+  if (failed_ || !file_.reserve(end)) {
+    failed_ = true;
+    return false;
+  }
+  std::memcpy(file_.data() + end - sizeof(TickRecord), &r, sizeof(r));
+  ++count_;
+  return true;
+}
+
+void TickSegmentWriter::commit() {
+  if (!is_open()) return;
+  std::memcpy(file_.data() + offsetof(FileHeader, tick_count), &count_, sizeof(count_));
+}
+
+bool TickSegmentWriter::close() {
+  if (!is_open()) return false;
+  commit();
+  const bool ok = file_.close(data_offset_ + count_ * sizeof(TickRecord));
+  return ok && !failed_;
+}
+
+bool TickStoreFile::open(const std::string& path) {
+  if (!file_.open(path) || file_.size() < sizeof(FileHeader)) return false;
+  FileHeader hdr;
+  std::memcpy(&hdr, file_.data(), sizeof(hdr));
+  if (std::memcmp(hdr.magic, kMagic, sizeof(kMagic)) != 0 || hdr.version != kVersion) return false;
+  size_t need = sizeof(FileHeader) + hdr.instrument_count * sizeof(FileIndex);
+  if (file_.size() < need || file_.size() < need + hdr.tick_count * sizeof(TickRecord)) return false;
+  count_ = hdr.instrument_count;
+  ticks_ = static_cast<size_t>(hdr.tick_count);
+  return true;
+}
+
+std::string TickStoreFile::instrument(size_t i) const {
+  const auto* idx = reinterpret_cast<const FileIndex*>(file_.data() + sizeof(FileHeader));
+  return std::string(idx[i].name, strnlen(idx[i].name, sizeof(idx[i].name)));
+}
+
+const TickRecord* TickStoreFile::ticks(size_t* n) const {
+  if (n) *n = ticks_;
+  return reinterpret_cast<const TickRecord*>(file_.data() + sizeof(FileHeader) + count_ * sizeof(FileIndex));
+}
+
+} // namespace ts
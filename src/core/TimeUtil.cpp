@@ -0,0 +1,122 @@
+#include "TradingSystem/TimeUtil.h"
+#include <cstdio>
+
+namespace ts {
+namespace {
+// 读取固定位数的十进制数字；遇到非数字返回false
+bool read_digits(std::string_view s, size_t pos, size_t n, int* out) {
+  if (pos + n > s.size()) return false;
+  int v = 0;
+  for (size_t i = 0; i < n; ++i) {
+    char c = s[pos + i];
+    if (c < '0' || c > '9') return false;
+    v = v * 10 + (c - '0');
+  }
+  *out = v;
+  return true;
+}
+
+// Howard Hinnant的days_from_civil算法
+int64_t days_from_civil(int y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  const int era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return static_cast<int64_t>(era) * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+void civil_from_days(int64_t z, int* y, unsigned* m, unsigned* d) {
+  z += 719468;
+  const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const unsigned doe = static_cast<unsigned>(z - era * 146097);
+  const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const unsigned mp = (5 * doy + 2) / 153;
+  *d = doy - (153 * mp + 2) / 5 + 1;
+  *m = mp < 10 ? mp + 3 : mp - 9;
+  *y = static_cast<int>(yoe + era * 400 + (*m <= 2));
+}
+} // namespace
+
+int64_t parse_time_of_day_ms(std::string_view s) {
+  int hh, mm, ss;
+  if (!read_digits(s, 0, 2, &hh) || s.size() < 8 || s[2] != ':' || !read_digits(s, 3, 2, &mm) ||
+      s[5] != ':' || !read_digits(s, 6, 2, &ss)) {
+    return -1;
+  }
+  int64_t ms = (hh * 3600LL + mm * 60LL + ss) * kMsPerSecond;
+  if (s.size() > 9 && (s[8] == '.' || s[8] == ',')) {
+    int frac = 0, digits = 0;
+    for (size_t i = 9; i < s.size() && digits < 3; ++i, ++digits) {
+      char c = s[i];
+      if (c < '0' || c > '9') break;
+      frac = frac * 10 + (c - '0');
+    }
+    for (; digits < 3; ++digits) frac *= 10;
+    ms += frac;
+  }
+  return ms;
+}
+
+int64_t parse_datetime_ms(std::string_view s) {
+  int y, mo, d;
+  size_t tpos;
+  if (s.size() >= 19 && s[4] == '-') {
+    if (!read_digits(s, 0, 4, &y) || !read_digits(s, 5, 2, &mo) || s[7] != '-' || !read_digits(s, 8, 2, &d)) return -1;
+    tpos = 11;
+  } else if (s.size() >= 17) {
+    if (!read_digits(s, 0, 4, &y) || !read_digits(s, 4, 2, &mo) || !read_digits(s, 6, 2, &d)) return -1;
+    tpos = 9;
+  } else {
+    return -1;
+  }
+  char sep = s[tpos - 1];
+  if (sep != ' ' && sep != 'T') return -1;
+  if (mo < 1 || mo > 12 || d < 1 || d > 31) return -1;
+  int64_t tod = parse_time_of_day_ms(s.substr(tpos));
+  if (tod < 0) return -1;
+  return days_from_civil(y, static_cast<unsigned>(mo), static_cast<unsigned>(d)) * kMsPerDay + tod;
+}
+
+std::string format_datetime_ms(int64_t ms) {
+  int64_t days = ms / kMsPerDay;
+  int64_t rem = ms % kMsPerDay;
+  if (rem < 0) { rem += kMsPerDay; --days; }
+  int y; unsigned m, d;
+  civil_from_days(days, &y, &m, &d);
+  int sec = static_cast<int>(rem / 1000);
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u %02d:%02d:%02d.%03d", y, m, d,
+                sec / 3600, (sec / 60) % 60, sec % 60, static_cast<int>(rem % 1000));
+  return buf;
+}
+
+int64_t trading_day(int64_t ms) {
+  // 平移7小时：17:00及以后的夜盘落到次日
+  const int64_t shifted = ms + 7 * 3600 * kMsPerSecond;
+  int64_t day = shifted / kMsPerDay;
+  if (shifted % kMsPerDay < 0) --day;
+  // 1970-01-01为周四：(day+4)%7 得0=周日…6=周六
+  const int64_t wd = ((day + 4) % 7 + 7) % 7;
+  if (wd == 6) day += 2;
+  else if (wd == 0) day += 1;
+  return day;
+}
+
+void DatetimeFormatter::format(int64_t ms, std::string* out) {
+  int64_t sec = ms / kMsPerSecond;
+  int64_t frac = ms % kMsPerSecond;
+  if (frac < 0) { frac += kMsPerSecond; --sec; }
+  if (sec != sec_) {
+    cached_ = format_datetime_ms(sec * kMsPerSecond);
+    sec_ = sec;
+  }
+  out->assign(cached_);
+  char* p = &(*out)[out->size() - 3];
+  p[0] = static_cast<char>('0' + frac / 100);
+  p[1] = static_cast<char>('0' + frac / 10 % 10);
+  p[2] = static_cast<char>('0' + frac % 10);
+}
+
+} // namespace ts
@@ -0,0 +1,157 @@
+#include "TradingSystem/TimerWheel.h"
+#include <algorithm>
+
+namespace ts {
+
+TimerWheel::TimerId TimerWheel::schedule(int64_t due_ms, int64_t interval_ms, uint32_t owner, uint64_t user_data) {
+  uint32_t idx;
+  if (!free_.empty()) {
+    idx = free_.back();
+    free_.pop_back();
+  } else {
+    idx = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+  }
+  Node& n = nodes_[idx];
+  n.due = std::max(due_ms, now_ + 1);
+  n.interval = std::max<int64_t>(interval_ms, 0);
+  n.owner = owner;
+  n.user_data = user_data;
+  place(idx);
+  ++live_;
+  return (static_cast<uint64_t>(n.gen) << 32) | idx;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+  const uint32_t idx = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+  const uint32_t gen = static_cast<uint32_t>(id >> 32);
+  if (idx >= nodes_.size()) return false;
+  Node& n = nodes_[idx];
+  if (n.gen != gen || n.list == kFree) return false;
+  unlink(idx);
+  release(idx);
+  return true;
+}
+
+void TimerWheel::advance(int64_t now_ms) {
+  while (now_ < now_ms) {
+    // 最低非空层为L时，下一个可能有定时器移动的时刻是下一个2^(8L)边界，其间整段跳过
+    int lowest = -1;
+    for (int l = 0; l < kLevels; ++l) {
+      if (level_count_[l]) { lowest = l; break; }
+    }
+    if (lowest < 0) {
+      now_ = now_ms;
+      break;
+    }
+    if (lowest > 0) {
+      const int shift = kBits * lowest;
+      const int64_t boundary = ((now_ >> shift) + 1) << shift;
+      now_ = std::min(now_ms, boundary - 1);
+      if (now_ == now_ms) break;
+    }
+    ++now_;
+    // 自上而下下移：高层先落到低层，同一时刻低层再按需继续下移
+    for (int l = kLevels - 1; l >= 1; --l) {
+      if ((now_ & ((int64_t(1) << (kBits * l)) - 1)) == 0) cascade(l);
+    }
+    const int32_t list = static_cast<int32_t>(now_ & (kSlots - 1));
+    while (heads_[list] != kNil) {
+      uint32_t idx = heads_[list];
+      unlink(idx);
+      link(idx, kReady);
+    }
+  }
+}
+
+bool TimerWheel::pop_ready(Fired* out) {
+  const uint32_t idx = heads_[kReady];
+  if (idx == kNil) return false;
+  unlink(idx);
+  Node& n = nodes_[idx];
+  out->id = (static_cast<uint64_t>(n.gen) << 32) | idx;
+  out->owner = n.owner;
+  out->user_data = n.user_data;
+  out->due_ms = n.due;
+  if (n.interval > 0) {
+    // 周期定时器保持相位；长时间未推进（如回测休市空档）时跳过错过的周期，不补发
+    n.due += n.interval;
+    if (n.due <= now_) n.due += ((now_ - n.due) / n.interval + 1) * n.interval;
+    place(idx);
+  } else {
+    release(idx);
+  }
+  return true;
+}
+
+void TimerWheel::rebase(int64_t now_ms) {
+  const int64_t delta = now_ms - now_;
+  std::vector<uint32_t> pending;
+  pending.reserve(live_);
+  for (uint32_t i = 0; i < nodes_.size(); ++i) {
+    if (nodes_[i].list == kFree) continue;
+    unlink(i);
+    nodes_[i].due += delta;
+    pending.push_back(i);
+  }
+  now_ = now_ms;
+  for (uint32_t i : pending) place(i);
+}
+
+void TimerWheel::place(uint32_t idx) {
+  Node& n = nodes_[idx];
+  if (n.due <= now_) {
+    link(idx, kReady);
+    return;
+  }
+  const uint64_t delta = static_cast<uint64_t>(n.due - now_);
+  int level = 0;
+  while (level < kLevels - 1 && delta >= (uint64_t(1) << (kBits * (level + 1)))) ++level;
+  int64_t at = n.due;
+  // 超出覆盖范围的先挂在最高层最远的槽，下移时按真实到期时间重新放置
+  const uint64_t span = uint64_t(1) << (kBits * kLevels);
+  if (delta >= span) at = now_ + static_cast<int64_t>(span - 1);
+  const int32_t slot = static_cast<int32_t>((at >> (kBits * level)) & (kSlots - 1));
+  link(idx, level * kSlots + slot);
+}
+
+void TimerWheel::link(uint32_t idx, int32_t list) {
+  Node& n = nodes_[idx];
+  n.list = list;
+  n.next = kNil;
+  n.prev = tails_[list];
+  if (n.prev != kNil) nodes_[n.prev].next = idx;
+  else heads_[list] = idx;
+  tails_[list] = idx;
+  if (list < kReady) ++level_count_[list / kSlots];
+}
+
+void TimerWheel::unlink(uint32_t idx) {
+  Node& n = nodes_[idx];
+  const int32_t list = n.list;
+  if (n.prev != kNil) nodes_[n.prev].next = n.next;
+  else heads_[list] = n.next;
+  if (n.next != kNil) nodes_[n.next].prev = n.prev;
+  else tails_[list] = n.prev;
+  if (list < kReady) --level_count_[list / kSlots];
+  n.prev = n.next = kNil;
+}
+
+void TimerWheel::release(uint32_t idx) {
+  Node& n = nodes_[idx];
+  n.list = kFree;
+  if (++n.gen == 0) n.gen = 1;
+  free_.push_back(idx);
+  --live_;
+}
+
+void TimerWheel::cascade(int level) {
+  const int32_t list = level * kSlots + static_cast<int32_t>((now_ >> (kBits * level)) & (kSlots - 1));
+  while (heads_[list] != kNil) {
+    uint32_t idx = heads_[list];
+    unlink(idx);
+    place(idx);
+  }
+}
+
+} // namespace ts
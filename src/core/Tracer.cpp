@@ -0,0 +1,157 @@
+#include "TradingSystem/Tracer.h"
+#include "TradingSystem/ThreadManager.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+namespace ts {
+
+namespace trace_detail {
+// 单写者环形缓冲：仅所属线程写入，head以release发布，导出时读取
+struct ThreadBuffer {
+  std::vector<Event> ring;
+  uint64_t mask{0};
+  std::atomic<uint64_t> head{0};
+  std::string name;
+  int tid{0};
+};
+} // namespace trace_detail
+
+using trace_detail::Event;
+using trace_detail::ThreadBuffer;
+
+namespace {
+uint64_t now_ns() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void append_json_string(std::string* out, const char* s) {
+  out->push_back('"');
+  for (; *s; ++s) {
+    char c = *s;
+    if (c == '"' || c == '\\') { out->push_back('\\'); out->push_back(c); }
+    else if (static_cast<unsigned char>(c) < 0x20) out->push_back(' ');
+    else out->push_back(c);
+  }
+  out->push_back('"');
+}
+} // namespace
+
+Tracer& Tracer::instance() {
+  // 有意不析构：行情线程可能在进程退出时仍持有缓冲
+  static Tracer* t = new Tracer();
+  return *t;
+}
+
+void Tracer::start(size_t buffer_events, uint32_t sample_every) {
+  std::lock_guard<std::mutex> lk(mu_);
+  size_t cap = 1024;
+  while (cap < buffer_events) cap <<= 1;
+  // 重复启动时复用已登记的线程缓冲，只清空内容
+  if (capacity_ == 0) capacity_ = cap;
+  for (auto& b : buffers_) b->head.store(0, std::memory_order_relaxed);
+  sample_every_ = sample_every > 0 ? sample_every : 1;
+  epoch_ns_ = now_ns();
+  trace_detail::g_enabled.store(true, std::memory_order_release);
+  std::cout << "[Trace] recording, " << capacity_ << " events/thread, sampling 1/" << sample_every_ << " ticks"
+            << std::endl;
+}
+
+ThreadBuffer* Tracer::register_thread() {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto* b = new ThreadBuffer();
+  b->ring.resize(capacity_);
+  b->mask = capacity_ - 1;
+  b->tid = static_cast<int>(buffers_.size()) + 1;
+  const char* role = ThreadManager::thread_name();
+  b->name = role ? role : "thread-" + std::to_string(b->tid);
+  buffers_.emplace_back(b);
+  trace_detail::tls_buf = b;
+  return b;
+}
+
+void Tracer::record(char ph, const char* cat, const char* name) {
+  ThreadBuffer* b = trace_detail::tls_buf;
+  if (!b) b = instance().register_thread();
+  const uint64_t h = b->head.load(std::memory_order_relaxed);
+  Event& e = b->ring[h & b->mask];
+  e.name = name;
+  e.cat = cat;
+  e.ts_ns = now_ns();
+  e.ph = ph;
+  b->head.store(h + 1, std::memory_order_release);
+}
+
+const char* Tracer::intern(const std::string& s) {
+  std::lock_guard<std::mutex> lk(mu_);
+  return names_.insert(s).first->c_str();
+}
+
+bool Tracer::stop_and_write(const std::string& path) {
+  if (!trace_detail::g_enabled.exchange(false)) return false;
+  std::lock_guard<std::mutex> lk(mu_);
+  std::string out;
+  out.reserve(1 << 20);
+  out.append("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+  bool first = true;
+  uint64_t total = 0, overwritten = 0;
+  char buf[160];
+  for (const auto& b : buffers_) {
+    std::snprintf(buf, sizeof(buf), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                  first ? "" : ",\n", b->tid);
+    out.append(buf);
+    append_json_string(&out, b->name.c_str());
+    out.append("}}");
+    first = false;
+    const uint64_t head = b->head.load(std::memory_order_acquire);
+    const uint64_t begin = head > b->ring.size() ? head - b->ring.size() : 0;
+    overwritten += begin;
+    // 覆盖会截掉早期的B，丢弃其后无配对的E，避免时间线错层
+    int depth = 0;
+    for (uint64_t i = begin; i < head; ++i) {
+      const Event& e = b->ring[i & b->mask];
+      if (e.ph == 'E') {
+        if (depth == 0) continue;
+        --depth;
+      } else if (e.ph == 'B') {
+        ++depth;
+      }
+      // 时间戳以微秒为单位（Chrome trace-event约定），保留纳秒精度
+      const uint64_t rel = e.ts_ns > epoch_ns_ ? e.ts_ns - epoch_ns_ : 0;
+      out.append(",\n{\"name\":");
+      append_json_string(&out, e.name);
+      out.append(",\"cat\":");
+      append_json_string(&out, e.cat);
+      std::snprintf(buf, sizeof(buf), ",\"ph\":\"%c\",\"ts\":%llu.%03llu,\"pid\":1,\"tid\":%d%s}", e.ph,
+                    static_cast<unsigned long long>(rel / 1000), static_cast<unsigned long long>(rel % 1000), b->tid,
+                    e.ph == 'i' ? ",\"s\":\"t\"" : "");
+      out.append(buf);
+      ++total;
+    }
+  }
+  out.append("\n]}\n");
+
+  std::string tmp = path + ".tmp";
+  std::FILE* f = std::fopen(tmp.c_str(), "wb");
+  if (!f) {
+    std::cerr << "[Trace] cannot open " << tmp << std::endl;
+    return false;
+  }
+  bool ok = std::fwrite(out.data(), 1, out.size(), f) == out.size();
+  ok = (std::fclose(f) == 0) && ok;
+  std::error_code ec;
+  if (ok) std::filesystem::rename(tmp, path, ec);
+  if (!ok || ec) {
+    std::filesystem::remove(tmp, ec);
+    std::cerr << "[Trace] write failed: " << path << std::endl;
+    return false;
+  }
+  std::cout << "[Trace] wrote " << total << " events to " << path;
+  if (overwritten) std::cout << " (" << overwritten << " oldest overwritten)";
+  std::cout << std::endl;
+  return true;
+}
+
+} // namespace ts
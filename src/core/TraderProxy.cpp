@@ -1,9 +1,17 @@
 #include "TradingSystem/TraderProxy.h"
+#include "TradingSystem/Log.h"
+#include "TradingSystem/Tracer.h"
 #include <chrono>
 
 namespace ts {
 TraderProxy::TraderProxy(std::unique_ptr<ITrader> inner, RiskManager* risk)
-    : inner_(std::move(inner)), risk_(risk) {}
+    : inner_(std::move(inner)), risk_(risk) {
+  auto& r = MetricsRegistry::instance();
+  submitted_ = r.counter("ts_orders_submitted_total", "Orders passed risk checks and sent to the trader");
+  cancels_ = r.counter("ts_order_cancels_total", "Cancel requests sent to the trader");
+  modifies_ = r.counter("ts_order_modifies_total", "Modify (cancel-replace) requests sent to the trader");
+  risk_rejected_ = r.counter("ts_orders_risk_rejected_total", "Orders blocked by pre-trade risk checks");
+}
 
 bool TraderProxy::connect(const std::string& front_addr) {
   return inner_->connect(front_addr);
@@ -14,8 +22,15 @@ bool TraderProxy::login(const std::string& broker_id, const std::string& user_id
 }
 
 std::string TraderProxy::place_order(const OrderRequest& req) {
+  TS_TRACE_SCOPE_ALWAYS("order", "place_order");
   std::string reason;
-  if (!risk_->can_place(req, &reason)) {
+  bool allowed;
+  {
+    TS_TRACE_SCOPE("risk", "risk.can_place");
+    allowed = risk_->can_place(req, &reason);
+  }
+  if (!allowed) {
+    risk_rejected_.inc();
     OrderStatusEvent ev;
     ev.order_id = "REJECT_" + req.instrument + "_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
     ev.status = "Rejected";
@@ -24,18 +39,51 @@ std::string TraderProxy::place_order(const OrderRequest& req) {
     return ev.order_id;
   }
   // 先暂存请求，用于在Accepted事件到来时注册ID
+  const size_t queued = pending_register_reqs_.size();
   pending_register_reqs_.push_back(req);
+  submitted_.inc();
   auto id = inner_->place_order(req);
   risk_->on_order_placed(req.instrument);
-  // 回退保障：若未在Accepted事件处注册，仍进行一次注册
-  risk_->register_order(id, req);
+  // 回退保障：若未在Accepted事件处注册，仍进行一次注册；
+  // 已注册的不再重复，否则同步成交后会把已完结订单重新挂回风控
+  if (pending_register_reqs_.size() > queued) {
+    pending_register_reqs_.pop_back();
+    // 渠道未能报出（返回空ID）时不登记
+    if (!id.empty()) risk_->register_order(id, req);
+  }
   return id;
 }
 
 bool TraderProxy::cancel_order(const std::string& order_id) {
+  TS_TRACE_SCOPE_ALWAYS("order", "cancel_order");
+  cancels_.inc();
   return inner_->cancel_order(order_id);
 }
 
+std::string TraderProxy::modify_order(const std::string& order_id, double new_price, int new_qty) {
+  TS_TRACE_SCOPE_ALWAYS("order", "modify_order");
+  std::string reason;
+  bool allowed;
+  {
+    TS_TRACE_SCOPE("risk", "risk.can_modify");
+    allowed = risk_->can_modify(order_id, new_price, new_qty, &reason);
+  }
+  if (!allowed) {
+    // 改单被拒时原订单仍在途，不发Rejected回报以免上层误判订单终结；以空ID告知调用方
+    risk_rejected_.inc();
+    TS_LOG_WARN(Risk, "[Risk] modify rejected order_id=", order_id, " reason=", reason);
+    return std::string();
+  }
+  // 先复制原始请求：撤单+新单的渠道可能在返回前同步回报旧单Canceled
+  OrderRequest req = *risk_->pending_request(order_id);
+  req.price = new_price;
+  req.volume = new_qty;
+  modifies_.inc();
+  std::string id = inner_->modify_order(order_id, new_price, new_qty);
+  if (!id.empty()) risk_->on_order_modified(order_id, id, req);
+  return id;
+}
+
 void TraderProxy::set_order_status_handler(OrderStatusHandler handler) {
   user_handler_ = handler;
   // 将内部交易的订单状态回调转发到代理层，以便更新风险并通知上层
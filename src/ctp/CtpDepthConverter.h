@@ -0,0 +1,207 @@
+#pragma once
+#include "TradingSystem/Event.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ts {
+
+// CTP深度行情转换：合约代码经预建的开放寻址表解析为合约序号（代码前16字节作两个机器字比较，无字符串构造），
+// 每合约持有一个预构造的MarketDataEvent，逐笔在原处改写数值与时间字符，稳态下不分配内存。
+// 累计成交量/成交额按合约差分为逐笔增量，与回放源的逐笔语义一致。
+// 与SDK头文件无关：字段名按CThostFtdcDepthMarketDataField访问，由调用方实例化。
+class CtpDepthConverter {
+ public:
+  explicit CtpDepthConverter(size_t expected_instruments = 256) {
+    size_t cap = 16;
+    while (cap < expected_instruments * 2) cap <<= 1;
+    table_.assign(cap, Entry{});
+    set_capacity(cap);
+    states_.reserve(expected_instruments);
+  }
+
+  // 预登记合约（订阅时调用），已存在时返回原序号
+  int add(const char* instrument) {
+    Key k;
+    const size_t len = key_of(instrument, &k);
+    int id = lookup(instrument, k);
+    if (id >= 0) return id;
+    if ((states_.size() + 1) * 2 > table_.size()) grow();
+    id = static_cast<int>(states_.size());
+    states_.emplace_back();
+    State& st = states_.back();
+    st.ev.instrument.assign(instrument, len);
+    st.ev.update_time.assign(kTimeLen, '0');
+    insert(k, id);
+    return id;
+  }
+  int find(const char* instrument) const {
+    Key k;
+    key_of(instrument, &k);
+    return lookup(instrument, k);
+  }
+  size_t size() const { return states_.size(); }
+
+  // 转换一笔深度行情；未登记的合约在慢路径中补登记。返回的事件归转换器所有，下一笔同合约行情前有效
+  template <class Depth>
+  const MarketDataEvent* convert(const Depth& d) {
+    static_assert(sizeof(d.InstrumentID) > kKeyLen, "InstrumentID must allow a 16-byte load");
+    Key k;
+    make_key(d.InstrumentID, &k);
+    int id = lookup(d.InstrumentID, k);
+    if (id < 0) id = add(d.InstrumentID);
+    State& st = states_[static_cast<size_t>(id)];
+    MarketDataEvent& ev = st.ev;
+    ev.last_price = price(d.LastPrice);
+    ev.bid_price = price(d.BidPrice1);
+    ev.ask_price = price(d.AskPrice1);
+    ev.bid_volume = d.BidVolume1;
+    ev.ask_volume = d.AskVolume1;
+    ev.open_interest = d.OpenInterest;
+    // 交易日切换时累计值清零重计；启动后首笔没有基准，增量记0
+    if (std::strncmp(st.trading_day, d.TradingDay, sizeof(st.trading_day) - 1) != 0) {
+      if (st.trading_day[0]) {
+        st.last_volume = 0;
+        st.last_turnover = 0.0;
+      } else {
+        st.last_volume = d.Volume;
+        st.last_turnover = d.Turnover;
+      }
+      std::memcpy(st.trading_day, d.TradingDay, sizeof(st.trading_day) - 1);
+    }
+    const int dv = d.Volume - st.last_volume;
+    ev.volume = dv > 0 ? dv : 0;
+    const double dt = d.Turnover - st.last_turnover;
+    ev.turnover = dt > 0.0 ? dt : 0.0;
+    if (d.Volume >= st.last_volume) {
+      st.last_volume = d.Volume;
+      st.last_turnover = d.Turnover;
+    }
+    // 日期取ActionDay（自然日），为空时退回TradingDay；格式 "YYYY-MM-DD HH:MM:SS.fff"
+    const char* day = d.ActionDay[0] ? d.ActionDay : d.TradingDay;
+    char* t = &ev.update_time[0];
+    t[0] = day[0]; t[1] = day[1]; t[2] = day[2]; t[3] = day[3];
+    t[4] = '-';
+    t[5] = day[4]; t[6] = day[5];
+    t[7] = '-';
+    t[8] = day[6]; t[9] = day[7];
+    t[10] = ' ';
+    std::memcpy(t + 11, d.UpdateTime, 8);
+    const int ms = (d.UpdateMillisec >= 0 && d.UpdateMillisec < 1000) ? d.UpdateMillisec : 0;
+    t[19] = '.';
+    t[20] = static_cast<char>('0' + ms / 100);
+    t[21] = static_cast<char>('0' + ms / 10 % 10);
+    t[22] = static_cast<char>('0' + ms % 10);
+    return &ev;
+  }
+
+ private:
+  static constexpr size_t kTimeLen = 23;
+  static constexpr size_t kKeyLen = 16;
+  // 合约代码前16字节（NUL之后补0），超长代码另比较全名
+  struct Key {
+    uint64_t w[2]{0, 0};
+    bool long_name{false};
+  };
+  // 恰为16字节的代码与同前缀的超长代码键值相同，须同时比较long_name
+  struct Entry {
+    uint64_t w[2]{0, 0};
+    int id{-1};
+    bool long_name{false};
+  };
+  struct State {
+    MarketDataEvent ev;
+    int last_volume{0};
+    double last_turnover{0.0};
+    char trading_day[9]{};
+  };
+
+  // s须至少可读16字节（SDK字段为定长数组；登记路径先复制到本地缓冲）。按字装载后屏蔽首个NUL之后的字节
+  static size_t make_key(const char* s, Key* k) {
+    std::memcpy(k->w, s, kKeyLen);
+    size_t n = 0;
+    for (int i = 0; i < 2; ++i) {
+      const uint64_t v = k->w[i];
+      const uint64_t zero = (v - 0x0101010101010101ULL) & ~v & 0x8080808080808080ULL;
+      if (zero) {
+        const size_t b = lowest_bit(zero) / 8;
+        k->w[i] = b ? (v & (~0ULL >> (64 - 8 * b))) : 0;
+        if (i == 0) k->w[1] = 0;
+        k->long_name = false;
+        return n + b;
+      }
+      n += 8;
+    }
+    k->long_name = s[kKeyLen] != '\0';
+    return kKeyLen + (k->long_name ? std::strlen(s + kKeyLen) : 0);
+  }
+  // 任意长度的C字符串（登记与查询的慢路径）
+  static size_t key_of(const char* s, Key* k) {
+    char buf[kKeyLen + 1] = {};
+    const size_t len = std::strlen(s);
+    std::memcpy(buf, s, len < kKeyLen ? len : kKeyLen);
+    make_key(buf, k);
+    k->long_name = len > kKeyLen;
+    return len;
+  }
+  static size_t lowest_bit(uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward64(&idx, v);
+    return idx;
+#else
+    return static_cast<size_t>(__builtin_ctzll(v));
+#endif
+  }
+  size_t slot_of(const uint64_t* w) const {
+    // 合约代码多为同前缀，差异在低位字节；乘法把每一位扩散到最高位，槽号取最高位（Fibonacci散列）
+    uint64_t h = (w[0] ^ (w[1] * 0xC2B2AE3D27D4EB4FULL)) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(h >> shift_);
+  }
+  void set_capacity(size_t cap) {
+    mask_ = cap - 1;
+    shift_ = 64;
+    while (cap > 1) {
+      cap >>= 1;
+      --shift_;
+    }
+  }
+  // CTP以DBL_MAX表示无效价（如无买卖盘），统一记0
+  static double price(double p) { return p < 1e300 ? p : 0.0; }
+
+  int lookup(const char* s, const Key& k) const {
+    for (size_t i = slot_of(k.w);; i = (i + 1) & mask_) {
+      const Entry& e = table_[i];
+      if (e.id < 0) return -1;
+      if (e.w[0] == k.w[0] && e.w[1] == k.w[1] && e.long_name == k.long_name &&
+          (!k.long_name || states_[static_cast<size_t>(e.id)].ev.instrument == s))
+        return e.id;
+    }
+  }
+  void insert(const Key& k, int id) { insert(Entry{{k.w[0], k.w[1]}, id, k.long_name}); }
+  void insert(const Entry& e) {
+    size_t i = slot_of(e.w);
+    while (table_[i].id >= 0) i = (i + 1) & mask_;
+    table_[i] = e;
+  }
+  void grow() {
+    std::vector<Entry> old;
+    old.swap(table_);
+    table_.assign(old.size() * 2, Entry{});
+    set_capacity(table_.size());
+    for (const Entry& e : old) {
+      if (e.id >= 0) insert(e);
+    }
+  }
+
+  std::vector<Entry> table_;
+  size_t mask_{0};
+  int shift_{64};
+  std::vector<State> states_;
+};
+
+} // namespace ts
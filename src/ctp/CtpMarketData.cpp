@@ -1,6 +1,7 @@
 #ifdef USE_CTP
 #include "ctp/CtpMarketData.h"
 #include "TradingSystem/Event.h"
+#include "TradingSystem/ThreadManager.h"
 #include <iostream>
 #include <cstring>
 
@@ -12,6 +13,7 @@ CtpMarketData::CtpMarketData() {
 }
 
 CtpMarketData::~CtpMarketData() {
+  stop();
   if (api_) {
     api_->Release();
     api_ = nullptr;
@@ -41,6 +43,7 @@ bool CtpMarketData::subscribe(const std::vector<std::string>& instruments) {
   std::vector<char*> buf;
   buf.reserve(instruments.size());
   for (auto& s : instruments) {
+    converter_.add(s.c_str());
     buf.push_back(const_cast<char*>(s.c_str()));
   }
   int ret = api_->SubscribeMarketData(buf.data(), static_cast<int>(buf.size()));
@@ -52,6 +55,11 @@ void CtpMarketData::set_market_data_handler(MarketDataHandler handler) {
   handler_ = std::move(handler);
 }
 
+void CtpMarketData::stop() {
+  std::lock_guard<std::mutex> lk(cb_mu_);
+  stopped_ = true;
+}
+
 void CtpMarketData::OnFrontConnected() {
   std::cout << "[CTP MD] Front connected" << std::endl;
 }
@@ -68,14 +76,15 @@ void CtpMarketData::OnRspUserLogin(CThostFtdcRspUserLoginField* pRspUserLogin,
 
 void CtpMarketData::OnRtnDepthMarketData(CThostFtdcDepthMarketDataField* p) {
   if (!handler_ || !p) return;
-  MarketDataEvent ev;
-  ev.instrument = p->InstrumentID;
-  ev.last_price = p->LastPrice;
-  ev.bid_price = p->BidPrice1;
-  ev.ask_price = p->AskPrice1;
-  ev.volume = p->Volume;
-  ev.update_time = p->UpdateTime;
-  handler_(ev);
+  // 回调线程由SDK创建，首次回调时按feed角色绑核
+  static thread_local bool pinned = false;
+  if (!pinned) {
+    ThreadManager::instance().enter(ThreadRole::Feed);
+    pinned = true;
+  }
+  std::lock_guard<std::mutex> lk(cb_mu_);
+  if (stopped_) return;
+  handler_(*converter_.convert(*p));
 }
 
 } // namespace ts
@@ -1,6 +1,8 @@
 #pragma once
 #ifdef USE_CTP
 #include "TradingSystem/IMarketData.h"
+#include "ctp/CtpDepthConverter.h"
+#include <mutex>
 #include <string>
 
 // CTP headers
@@ -16,6 +18,7 @@ class CtpMarketData : public IMarketData, public CThostFtdcMdSpi {
   bool login(const std::string& broker_id, const std::string& user_id, const std::string& password) override;
   bool subscribe(const std::vector<std::string>& instruments) override;
   void set_market_data_handler(MarketDataHandler handler) override;
+  void stop() override;
 
   // CTP SPI callbacks
   void OnFrontConnected() override;
@@ -26,6 +29,10 @@ class CtpMarketData : public IMarketData, public CThostFtdcMdSpi {
 
  private:
   MarketDataHandler handler_;
+  // SDK回调线程无法汇合：回调在锁内派发，stop()取锁后置位，此后回调直接返回
+  std::mutex cb_mu_;
+  bool stopped_{false};
+  CtpDepthConverter converter_;  // 订阅时在首笔回调前预登记，之后仅SDK回调线程访问
   CThostFtdcMdApi* api_{nullptr};
   std::string front_;
   std::string broker_;
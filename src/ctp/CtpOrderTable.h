@@ -0,0 +1,186 @@
+#pragma once
+#include "TradingSystem/Event.h"
+#include "TradingSystem/ITrader.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ts {
+
+// CTP报单状态表：以本会话OrderRef取模为下标的定长槽位，启动时一次性分配。
+// 回报按OrderRef直接定位槽位，状态机把CTP状态字符归并为统一的订单事件；成交数量与价格只取自OnRtnTrade，
+// OnRtnOrder仅推进状态，避免重复计量。与SDK头文件无关，由CtpTrader把状态字符映射为Report后驱动。
+class CtpOrderTable {
+ public:
+  enum class State : unsigned char { Free, Submitted, Accepted, PartiallyFilled, Filled, Canceled, Rejected };
+  // OnRtnOrder归并后的报告类别
+  enum class Report : unsigned char {
+    Pending,         // 未知/已提交，交易所尚未确认
+    Queueing,        // 在队列中（含部分成交还在队列中）
+    AllTraded,       // 全部成交：等待成交回报补齐后发Filled
+    Done,            // 不在队列中或已撤单：等待成交回报补齐后发Canceled
+    InsertRejected,  // 报单被拒
+  };
+  struct Slot {
+    int order_ref{0};
+    State state{State::Free};
+    bool done_pending{false};  // 交易所已终结但成交回报尚未补齐
+    int traded{0};             // OnRtnTrade累计成交量
+    int exchange_traded{0};    // OnRtnOrder报告的VolumeTraded
+    // 改单（撤单+新单）：替换单预占OrderRef后挂起（parked），待原单完结再报出；原单记录替换单的OrderRef
+    bool parked{false};
+    int replace_ref{0};
+    OrderRequest req;
+    char order_sys_id[21]{};
+    char exchange_id[9]{};
+  };
+
+  explicit CtpOrderTable(size_t capacity = 4096) : slots_(capacity) {}
+
+  static bool terminal(State s) {
+    return s == State::Filled || s == State::Canceled || s == State::Rejected;
+  }
+
+  // 为新报单占用槽位；槽位上仍有未完结订单（在途订单超过容量）时返回nullptr
+  Slot* acquire(int order_ref, const OrderRequest& req) {
+    Slot& s = slots_[index(order_ref)];
+    if (s.state != State::Free && !terminal(s.state)) return nullptr;
+    s = Slot{};
+    s.order_ref = order_ref;
+    s.state = State::Submitted;
+    s.req = req;
+    return &s;
+  }
+  // 为原单old_ref预占替换单槽位（不报出）；原单未知、已完结或已有挂起的替换单时返回nullptr
+  Slot* park(int order_ref, const OrderRequest& req, int old_ref) {
+    Slot* old = find(old_ref);
+    if (!old || terminal(old->state) || old->replace_ref != 0) return nullptr;
+    Slot* s = acquire(order_ref, req);
+    if (!s) return nullptr;
+    s->parked = true;
+    old->replace_ref = order_ref;
+    return s;
+  }
+  // 撤销挂起中的替换单（尚未报出，本地直接终结）：返回需要上送的事件个数（0或1）
+  int cancel_parked(int order_ref, OrderStatusEvent* out) {
+    Slot* s = find(order_ref);
+    if (!s || !s->parked) return 0;
+    s->parked = false;
+    s->state = State::Canceled;
+    fill_event(*s, "Canceled", "canceled before replace", 0, 0.0, out);
+    return 1;
+  }
+  // 原单完结后处理其替换单：已撤销时*send_ref为待报出的替换单OrderRef；已成交或被拒时替换单置Rejected。
+  // 返回需要上送的事件个数（0或1）
+  int resolve_replacement(int old_ref, int* send_ref, OrderStatusEvent* out) {
+    *send_ref = 0;
+    Slot* old = find(old_ref);
+    if (!old || !terminal(old->state) || old->replace_ref == 0) return 0;
+    Slot* s = find(old->replace_ref);
+    old->replace_ref = 0;
+    if (!s || !s->parked) return 0;
+    s->parked = false;
+    if (old->state == State::Canceled) {
+      *send_ref = s->order_ref;
+      return 0;
+    }
+    s->state = State::Rejected;
+    fill_event(*s, "Rejected", old->state == State::Filled ? "original order filled before cancel"
+                                                          : "original order rejected", 0, 0.0, out);
+    return 1;
+  }
+  // 发送失败时归还槽位
+  void release(int order_ref) {
+    Slot* s = find(order_ref);
+    if (s) s->state = State::Free;
+  }
+  Slot* find(int order_ref) {
+    if (order_ref <= 0) return nullptr;
+    Slot& s = slots_[index(order_ref)];
+    return (s.state != State::Free && s.order_ref == order_ref) ? &s : nullptr;
+  }
+  size_t capacity() const { return slots_.size(); }
+
+  // 报单回报：返回需要上送的事件个数（0或1）
+  int on_order(int order_ref, Report r, int volume_traded, const char* order_sys_id, const char* exchange_id,
+               const char* msg, OrderStatusEvent* out) {
+    Slot* s = find(order_ref);
+    if (!s || terminal(s->state)) return 0;
+    if (order_sys_id && order_sys_id[0]) copy(s->order_sys_id, sizeof(s->order_sys_id), order_sys_id);
+    if (exchange_id && exchange_id[0]) copy(s->exchange_id, sizeof(s->exchange_id), exchange_id);
+    s->exchange_traded = std::max(s->exchange_traded, volume_traded);
+    switch (r) {
+      case Report::InsertRejected:
+        s->state = State::Rejected;
+        fill_event(*s, "Rejected", msg ? msg : "insert rejected", 0, 0.0, out);
+        return 1;
+      case Report::Pending:
+      case Report::Queueing:
+      case Report::AllTraded:
+        if (s->state != State::Submitted) return 0;
+        s->state = State::Accepted;
+        fill_event(*s, "Accepted", "accepted", 0, 0.0, out);
+        return 1;
+      case Report::Done:
+        s->done_pending = true;
+        return settle(*s, msg, out);
+    }
+    return 0;
+  }
+
+  // 成交回报：返回需要上送的事件个数（0~2，成交之后可能跟随补齐的Canceled）
+  int on_trade(int order_ref, const char* order_sys_id, int volume, double price, OrderStatusEvent out[2]) {
+    Slot* s = find(order_ref);
+    if (!s || terminal(s->state) || volume <= 0) return 0;
+    // 同一投资者其他会话的成交可能撞上本会话OrderRef，以OrderSysID核对
+    if (s->order_sys_id[0] && order_sys_id && std::strncmp(s->order_sys_id, order_sys_id, sizeof(s->order_sys_id)) != 0)
+      return 0;
+    s->traded += volume;
+    const std::string msg = "px=" + std::to_string(price) + ",qty=" + std::to_string(volume);
+    if (s->traded >= s->req.volume) {
+      s->state = State::Filled;
+      fill_event(*s, "Filled", msg.c_str(), volume, price, &out[0]);
+      return 1;
+    }
+    s->state = State::PartiallyFilled;
+    fill_event(*s, "PartiallyFilled", msg.c_str(), volume, price, &out[0]);
+    return 1 + settle(*s, "canceled", &out[1]);
+  }
+
+  // 报单录入错误（OnRspOrderInsert/OnErrRtnOrderInsert）
+  int on_insert_error(int order_ref, const char* msg, OrderStatusEvent* out) {
+    return on_order(order_ref, Report::InsertRejected, 0, nullptr, nullptr, msg, out);
+  }
+
+ private:
+  size_t index(int order_ref) const { return static_cast<size_t>(order_ref) % slots_.size(); }
+
+  static void copy(char* dst, size_t n, const char* src) {
+    std::strncpy(dst, src, n - 1);
+    dst[n - 1] = '\0';
+  }
+
+  // 交易所已终结：成交回报补齐后才发Canceled，保证风控先记完成交再移除在途订单
+  int settle(Slot& s, const char* msg, OrderStatusEvent* out) {
+    if (!s.done_pending || s.traded < s.exchange_traded) return 0;
+    s.state = State::Canceled;
+    fill_event(s, "Canceled", msg ? msg : "canceled", 0, 0.0, out);
+    return 1;
+  }
+
+  static void fill_event(const Slot& s, const char* status, const char* msg, int qty, double px,
+                         OrderStatusEvent* out) {
+    out->order_id = std::to_string(s.order_ref);
+    out->status = status;
+    out->message = msg;
+    out->instrument = s.req.instrument;
+    out->filled_qty = qty;
+    out->fill_price = px;
+    out->remaining_qty = std::max(0, s.req.volume - s.traded);
+  }
+
+  std::vector<Slot> slots_;
+};
+
+} // namespace ts
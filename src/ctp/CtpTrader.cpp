@@ -1,8 +1,11 @@
 #ifdef USE_CTP
 #include "ctp/CtpTrader.h"
 #include "TradingSystem/Event.h"
-#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <iostream>
 
 namespace ts {
 CtpTrader::CtpTrader() {
@@ -24,58 +27,226 @@ bool CtpTrader::login(const std::string& broker_id, const std::string& user_id,
   strncpy(req.BrokerID, broker_.c_str(), sizeof(req.BrokerID));
   strncpy(req.UserID, user_.c_str(), sizeof(req.UserID));
   strncpy(req.Password, pass_.c_str(), sizeof(req.Password));
-  int ret = api_->ReqUserLogin(&req, ++req_id_);
+  int ret = api_->ReqUserLogin(&req, req_id_.fetch_add(1) + 1);
   std::cout << "[CTP TD] Send login request ret=" << ret << std::endl;
   return ret == 0;
 }
 std::string CtpTrader::place_order(const OrderRequest& r) {
+  int ref;
+  {
+    std::lock_guard<std::mutex> lk(order_mu_);
+    ref = next_order_ref_;
+    if (!orders_.acquire(ref, r)) {
+      std::cerr << "[CTP TD] order table full (" << orders_.capacity() << " live orders), order dropped" << std::endl;
+      return std::string();
+    }
+    ++next_order_ref_;
+  }
+  if (send_insert(ref, r) != 0) {
+    std::lock_guard<std::mutex> lk(order_mu_);
+    orders_.release(ref);
+    return std::string();
+  }
+  return std::to_string(ref);
+}
+int CtpTrader::send_insert(int ref, const OrderRequest& r) {
   CThostFtdcInputOrderField ord{};
   strncpy(ord.BrokerID, broker_.c_str(), sizeof(ord.BrokerID));
   strncpy(ord.InvestorID, user_.c_str(), sizeof(ord.InvestorID));
   strncpy(ord.InstrumentID, r.instrument.c_str(), sizeof(ord.InstrumentID));
+  snprintf(ord.OrderRef, sizeof(ord.OrderRef), "%d", ref);
   ord.Direction = (r.direction == Direction::Buy) ? THOST_FTDC_D_Buy : THOST_FTDC_D_Sell;
   ord.CombOffsetFlag[0] = (r.offset == Offset::Open) ? THOST_FTDC_OF_Open : THOST_FTDC_OF_Close;
-  ord.OrderPriceType = (r.type == OrderType::Limit) ? THOST_FTDC_OPT_LimitPrice : THOST_FTDC_OPT_AnyPrice;
+  ord.CombHedgeFlag[0] = THOST_FTDC_HF_Speculation;
+  ord.OrderPriceType = (r.type == OrderType::Market) ? THOST_FTDC_OPT_AnyPrice : THOST_FTDC_OPT_LimitPrice;
   ord.LimitPrice = r.price;
   ord.VolumeTotalOriginal = r.volume;
-  ord.TimeCondition = THOST_FTDC_TC_GFD;
-  ord.VolumeCondition = THOST_FTDC_VC_AV;
+  // IOC/FOK对应即时成交剩余撤销（任意数量/全部数量）
+  const bool immediate = (r.type == OrderType::IOC || r.type == OrderType::FOK || r.type == OrderType::Market);
+  ord.TimeCondition = immediate ? THOST_FTDC_TC_IOC : THOST_FTDC_TC_GFD;
+  ord.VolumeCondition = (r.type == OrderType::FOK) ? THOST_FTDC_VC_CV : THOST_FTDC_VC_AV;
   ord.ContingentCondition = THOST_FTDC_CC_Immediately;
   ord.MinVolume = 1;
   ord.ForceCloseReason = THOST_FTDC_FCC_NotForceClose;
-  int ret = api_->ReqOrderInsert(&ord, ++req_id_);
-  std::cout << "[CTP TD] ReqOrderInsert ret=" << ret << std::endl;
-  return std::to_string(req_id_);
+  int ret = api_->ReqOrderInsert(&ord, req_id_.fetch_add(1) + 1);
+  std::cout << "[CTP TD] ReqOrderInsert ref=" << ref << " ret=" << ret << std::endl;
+  return ret;
+}
+void CtpTrader::send_replacement(int ref) {
+  OrderRequest r;
+  {
+    std::lock_guard<std::mutex> lk(order_mu_);
+    const CtpOrderTable::Slot* s = orders_.find(ref);
+    if (!s || CtpOrderTable::terminal(s->state)) return;
+    r = s->req;
+  }
+  if (send_insert(ref, r) == 0) return;
+  // 新ID已交给调用方，发送失败只能以回报通知
+  OrderStatusEvent ev;
+  int n;
+  {
+    std::lock_guard<std::mutex> lk(order_mu_);
+    n = orders_.on_insert_error(ref, "replace insert send failed", &ev);
+  }
+  emit(&ev, n);
 }
 bool CtpTrader::cancel_order(const std::string& order_id) {
-  // Minimal example; you'd use CThostFtdcInputOrderActionField with appropriate fields.
-  std::cout << "[CTP TD] Cancel not implemented in scaffold. Id=" << order_id << std::endl;
-  return false;
+  const int ref = std::atoi(order_id.c_str());
+  CThostFtdcInputOrderActionField act{};
+  {
+    OrderStatusEvent ev;
+    int n;
+    {
+      std::lock_guard<std::mutex> lk(order_mu_);
+      n = orders_.cancel_parked(ref, &ev);
+    }
+    // 挂起中的替换单尚未报出，本地撤销即可
+    if (n > 0) {
+      emit(&ev, n);
+      return true;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lk(order_mu_);
+    const CtpOrderTable::Slot* s = orders_.find(ref);
+    if (!s || CtpOrderTable::terminal(s->state)) {
+      std::cerr << "[CTP TD] cancel: unknown or completed order " << order_id << std::endl;
+      return false;
+    }
+    // 以FrontID+SessionID+OrderRef定位报单，交易所确认前即可撤单
+    strncpy(act.InstrumentID, s->req.instrument.c_str(), sizeof(act.InstrumentID));
+    strncpy(act.ExchangeID, s->exchange_id, sizeof(act.ExchangeID));
+  }
+  strncpy(act.BrokerID, broker_.c_str(), sizeof(act.BrokerID));
+  strncpy(act.InvestorID, user_.c_str(), sizeof(act.InvestorID));
+  strncpy(act.UserID, user_.c_str(), sizeof(act.UserID));
+  snprintf(act.OrderRef, sizeof(act.OrderRef), "%d", ref);
+  act.FrontID = front_id_;
+  act.SessionID = session_id_;
+  act.ActionFlag = THOST_FTDC_AF_Delete;
+  int ret = api_->ReqOrderAction(&act, req_id_.fetch_add(1) + 1);
+  std::cout << "[CTP TD] ReqOrderAction ref=" << ref << " ret=" << ret << std::endl;
+  return ret == 0;
+}
+std::string CtpTrader::modify_order(const std::string& order_id, double new_price, int new_qty) {
+  const int old_ref = std::atoi(order_id.c_str());
+  int ref;
+  {
+    std::lock_guard<std::mutex> lk(order_mu_);
+    CtpOrderTable::Slot* s = orders_.find(old_ref);
+    if (!s || CtpOrderTable::terminal(s->state)) return std::string();
+    // 尚未报出的替换单直接改价量
+    if (s->parked) {
+      s->req.price = new_price;
+      s->req.volume = new_qty;
+      return order_id;
+    }
+    OrderRequest r = s->req;
+    r.price = new_price;
+    r.volume = new_qty;
+    ref = next_order_ref_;
+    if (!orders_.park(ref, r, old_ref)) {
+      std::cerr << "[CTP TD] modify: cannot reserve replacement for order " << order_id << std::endl;
+      return std::string();
+    }
+    ++next_order_ref_;
+  }
+  // 新单在原单撤单确认（Canceled）后才报出，避免撤单前成交与新单叠加超量；撤单前已成交的部分照常回报
+  if (!cancel_order(order_id)) {
+    std::lock_guard<std::mutex> lk(order_mu_);
+    CtpOrderTable::Slot* s = orders_.find(old_ref);
+    if (s) s->replace_ref = 0;
+    orders_.release(ref);
+    return std::string();
+  }
+  return std::to_string(ref);
 }
 void CtpTrader::set_order_status_handler(OrderStatusHandler h) { handler_ = std::move(h); }
 
+void CtpTrader::emit(const OrderStatusEvent* evs, int n) {
+  if (!handler_) return;
+  for (int i = 0; i < n; ++i) handler_(evs[i]);
+}
+
 void CtpTrader::OnFrontConnected() { std::cout << "[CTP TD] Front connected\n"; }
 void CtpTrader::OnFrontDisconnected(int nReason) { std::cout << "[CTP TD] Front disconnected reason=" << nReason << "\n"; }
 void CtpTrader::OnRspUserLogin(CThostFtdcRspUserLoginField* pRspUserLogin,
                       CThostFtdcRspInfoField* pRspInfo, int nRequestID, bool bIsLast) {
   std::cout << "[CTP TD] Login response: ErrorID=" << (pRspInfo ? pRspInfo->ErrorID : 0)
             << " Msg=" << (pRspInfo ? pRspInfo->ErrorMsg : "") << std::endl;
+  if (!pRspUserLogin || (pRspInfo && pRspInfo->ErrorID != 0)) return;
+  std::lock_guard<std::mutex> lk(order_mu_);
+  front_id_ = pRspUserLogin->FrontID;
+  session_id_ = pRspUserLogin->SessionID;
+  next_order_ref_ = std::max(next_order_ref_, std::atoi(pRspUserLogin->MaxOrderRef) + 1);
+}
+void CtpTrader::OnRspOrderInsert(CThostFtdcInputOrderField* pInputOrder, CThostFtdcRspInfoField* pRspInfo,
+                                 int nRequestID, bool bIsLast) {
+  if (!pInputOrder || !pRspInfo || pRspInfo->ErrorID == 0) return;
+  const int ref = std::atoi(pInputOrder->OrderRef);
+  OrderStatusEvent evs[2];
+  int n, send_ref;
+  {
+    std::lock_guard<std::mutex> lk(order_mu_);
+    n = orders_.on_insert_error(ref, pRspInfo->ErrorMsg, evs);
+    n += orders_.resolve_replacement(ref, &send_ref, &evs[n]);
+  }
+  emit(evs, n);
+}
+void CtpTrader::OnErrRtnOrderInsert(CThostFtdcInputOrderField* pInputOrder, CThostFtdcRspInfoField* pRspInfo) {
+  OnRspOrderInsert(pInputOrder, pRspInfo, 0, true);
+}
+void CtpTrader::OnRspOrderAction(CThostFtdcInputOrderActionField* pInputOrderAction, CThostFtdcRspInfoField* pRspInfo,
+                                 int nRequestID, bool bIsLast) {
+  // 撤单被拒不改变订单状态，原订单继续按回报推进
+  if (!pInputOrderAction || !pRspInfo || pRspInfo->ErrorID == 0) return;
+  std::cerr << "[CTP TD] cancel rejected ref=" << pInputOrderAction->OrderRef << " ErrorID=" << pRspInfo->ErrorID
+            << " Msg=" << pRspInfo->ErrorMsg << std::endl;
+}
+void CtpTrader::OnErrRtnOrderAction(CThostFtdcOrderActionField* pOrderAction, CThostFtdcRspInfoField* pRspInfo) {
+  if (!pOrderAction || !pRspInfo || pRspInfo->ErrorID == 0) return;
+  std::cerr << "[CTP TD] cancel rejected ref=" << pOrderAction->OrderRef << " ErrorID=" << pRspInfo->ErrorID
+            << " Msg=" << pRspInfo->ErrorMsg << std::endl;
 }
 void CtpTrader::OnRtnOrder(CThostFtdcOrderField* pOrder) {
-  if (!handler_ || !pOrder) return;
-  OrderStatusEvent ev;
-  ev.order_id = pOrder->OrderSysID;
-  ev.status = pOrder->OrderStatus;
-  ev.message = "RtnOrder";
-  handler_(ev);
+  if (!pOrder) return;
+  // 同一投资者其他会话的报单也会推送，只处理本会话的
+  if (pOrder->FrontID != front_id_ || pOrder->SessionID != session_id_) return;
+  CtpOrderTable::Report r;
+  switch (pOrder->OrderStatus) {
+    case THOST_FTDC_OST_AllTraded: r = CtpOrderTable::Report::AllTraded; break;
+    case THOST_FTDC_OST_PartTradedQueueing:
+    case THOST_FTDC_OST_NoTradeQueueing: r = CtpOrderTable::Report::Queueing; break;
+    case THOST_FTDC_OST_PartTradedNotQueueing:
+    case THOST_FTDC_OST_NoTradeNotQueueing:
+    case THOST_FTDC_OST_Canceled: r = CtpOrderTable::Report::Done; break;
+    default: r = CtpOrderTable::Report::Pending; break;
+  }
+  if (pOrder->OrderSubmitStatus == THOST_FTDC_OSS_InsertRejected) r = CtpOrderTable::Report::InsertRejected;
+  const int ref = std::atoi(pOrder->OrderRef);
+  OrderStatusEvent evs[2];
+  int n, send_ref;
+  {
+    std::lock_guard<std::mutex> lk(order_mu_);
+    n = orders_.on_order(ref, r, pOrder->VolumeTraded, pOrder->OrderSysID, pOrder->ExchangeID, pOrder->StatusMsg, evs);
+    n += orders_.resolve_replacement(ref, &send_ref, &evs[n]);
+  }
+  emit(evs, n);
+  // 原单终态先上送，再报出替换单
+  if (send_ref) send_replacement(send_ref);
 }
 void CtpTrader::OnRtnTrade(CThostFtdcTradeField* pTrade) {
-  if (!handler_ || !pTrade) return;
-  OrderStatusEvent ev;
-  ev.order_id = pTrade->OrderSysID;
-  ev.status = "Traded";
-  ev.message = "RtnTrade";
-  handler_(ev);
+  if (!pTrade) return;
+  const int ref = std::atoi(pTrade->OrderRef);
+  OrderStatusEvent evs[3];
+  int n, send_ref;
+  {
+    std::lock_guard<std::mutex> lk(order_mu_);
+    n = orders_.on_trade(ref, pTrade->OrderSysID, pTrade->Volume, pTrade->Price, evs);
+    n += orders_.resolve_replacement(ref, &send_ref, &evs[n]);
+  }
+  emit(evs, n);
+  if (send_ref) send_replacement(send_ref);
 }
 } // namespace ts
-#endif
\ No newline at end of file
+#endif
@@ -2,6 +2,9 @@
 #ifdef USE_CTP
 #include "TradingSystem/ITrader.h"
 #include "ThostTraderApi.h"
+#include "ctp/CtpOrderTable.h"
+#include <atomic>
+#include <mutex>
 #include <string>
 
 namespace ts {
@@ -14,6 +17,9 @@ class CtpTrader : public ITrader, public CThostFtdcTraderSpi {
   bool login(const std::string& broker_id, const std::string& user_id, const std::string& password) override;
   std::string place_order(const OrderRequest& req) override;
   bool cancel_order(const std::string& order_id) override;
+  // CTP无原生改单：立即预占并返回新ID，原单撤单确认（Canceled）后才以新价量报出；
+  // 原单在撤单前已全部成交时新ID回报Rejected。挂起中的新ID可再改单或撤单
+  std::string modify_order(const std::string& order_id, double new_price, int new_qty) override;
   void set_order_status_handler(OrderStatusHandler handler) override;
 
   // SPI callbacks
@@ -21,14 +27,31 @@ class CtpTrader : public ITrader, public CThostFtdcTraderSpi {
   void OnFrontDisconnected(int nReason) override;
   void OnRspUserLogin(CThostFtdcRspUserLoginField* pRspUserLogin,
                       CThostFtdcRspInfoField* pRspInfo, int nRequestID, bool bIsLast) override;
+  void OnRspOrderInsert(CThostFtdcInputOrderField* pInputOrder, CThostFtdcRspInfoField* pRspInfo,
+                        int nRequestID, bool bIsLast) override;
+  void OnErrRtnOrderInsert(CThostFtdcInputOrderField* pInputOrder, CThostFtdcRspInfoField* pRspInfo) override;
+  void OnRspOrderAction(CThostFtdcInputOrderActionField* pInputOrderAction, CThostFtdcRspInfoField* pRspInfo,
+                        int nRequestID, bool bIsLast) override;
+  void OnErrRtnOrderAction(CThostFtdcOrderActionField* pOrderAction, CThostFtdcRspInfoField* pRspInfo) override;
   void OnRtnOrder(CThostFtdcOrderField* pOrder) override;
   void OnRtnTrade(CThostFtdcTradeField* pTrade) override;
 
  private:
   OrderStatusHandler handler_;
   CThostFtdcTraderApi* api_{nullptr};
-  int req_id_{0};
+  std::atomic<int> req_id_{0};  // 报单线程与SPI回调线程（撤单确认后报替换单）均会取号
   std::string broker_, user_, pass_;
+  // 订单ID即本会话OrderRef；登录应答给出FrontID/SessionID与起始OrderRef，回报据此识别本会话订单
+  int front_id_{0};
+  int session_id_{0};
+  int next_order_ref_{1};
+  std::mutex order_mu_;  // 报单线程与SPI回调线程共享状态表
+  CtpOrderTable orders_;
+  void emit(const OrderStatusEvent* evs, int n);
+  // 报出已占槽位的订单；返回ReqOrderInsert的返回值
+  int send_insert(int ref, const OrderRequest& r);
+  // 报出原单撤销后挂起的替换单，发送失败时回报Rejected
+  void send_replacement(int ref);
 };
 }
 #endif
\ No newline at end of file
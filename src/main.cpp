@@ -4,71 +4,32 @@
 #include "TradingSystem/ITrader.h"
 #include "TradingSystem/Event.h"
 #include "TradingSystem/ConfigUtil.h"
+#include "TradingSystem/StrategyFactory.h"
 #include "TradingSystem/BacktestMarketData.h"
 #include "TradingSystem/BacktestTrader.h"
+#include "TradingSystem/BarReplayMarketData.h"
+#include "TradingSystem/SyntheticMarketData.h"
+#include "TradingSystem/TickCleaner.h"
 #include "stub/StubMarketData.h"
 #include "stub/StubTrader.h"
 #ifdef USE_CTP
 #include "ctp/CtpMarketData.h"
 #include "ctp/CtpTrader.h"
 #endif
+#include <atomic>
+#include <csignal>
 #include <iostream>
 #include <memory>
-#include <deque>
-#include <unordered_map>
 
 using namespace ts;
 
-class DualMAStrategy : public Strategy {
-public:
-  DualMAStrategy(int fast, int slow, double slippage)
-    : fast_(fast), slow_(slow), slip_(slippage) {
-      if (fast_ < 1) fast_ = 1; if (slow_ < fast_) slow_ = fast_ + 1;
-    }
-  void on_market_data(const MarketDataEvent& md, ITrader* trader) override {
-    // 本策略基于Bar触发；Tick仅用于日志或扩展（此处空实现）
-    (void)md; (void)trader;
-  }
-  void on_bar(const BarEvent& bar, ITrader* trader) override {
-    auto& dq = bars_[bar.instrument];
-    dq.push_back(bar);
-    if ((int)dq.size() > slow_) dq.pop_front();
-    if ((int)dq.size() < slow_) return;
-
-    double fast_ma = ma(dq, fast_);
-    double slow_ma = ma(dq, slow_);
-
-    auto& pos = position_[bar.instrument];
-    if (fast_ma > slow_ma && pos <= 0) {
-      OrderRequest req{bar.instrument, Direction::Buy, Offset::Open, OrderType::Limit, bar.close + slip_, 1};
-      trader->place_order(req);
-      pos += 1;
-    } else if (fast_ma < slow_ma && pos >= 0) {
-      OrderRequest req{bar.instrument, Direction::Sell, Offset::Open, OrderType::Limit, bar.close - slip_, 1};
-      trader->place_order(req);
-      pos -= 1;
-    }
-  }
-  void on_order_status(const OrderStatusEvent& ev) override {
-    std::cout << "[Strategy] OrderStatus id=" << ev.order_id
-              << " status=" << ev.status
-              << " inst=" << ev.instrument
-              << " qty=" << ev.filled_qty
-              << " px=" << ev.fill_price
-              << " remaining=" << ev.remaining_qty
-              << " msg=" << ev.message << "\n";
-  }
-private:
-  static double ma(const std::deque<BarEvent>& dq, int n) {
-    double s = 0.0; int cnt = 0;
-    for (int i = (int)dq.size() - n; i < (int)dq.size(); ++i) { if (i >= 0) { s += dq[i].close; ++cnt; } }
-    return cnt ? s / cnt : 0.0;
-  }
-  int fast_, slow_;
-  double slip_;
-  std::unordered_map<std::string, std::deque<BarEvent>> bars_;
-  std::unordered_map<std::string, int> position_;
-};
+namespace {
+// Ctrl+C / SIGTERM：请求引擎停止事件循环，照常输出报表
+std::atomic<Engine*> g_engine{nullptr};
+void on_stop_signal(int) {
+  if (Engine* e = g_engine.load()) e->stop();
+}
+} // namespace
 
 int main(int argc, char* argv[]) {
   // 解析命令行参数：支持 -c/--config 指定配置文件路径
@@ -88,8 +49,52 @@ int main(int argc, char* argv[]) {
 
   std::unique_ptr<IMarketData> md;
   std::unique_ptr<ITrader> td;
-  if (cfg.use_backtest) {
-    md = std::make_unique<BacktestMarketData>(cfg.backtest_speed_ms);
+  if (cfg.use_synthetic && !cfg.use_ctp) {
+    SyntheticConfig sc;
+    sc.instruments = cfg.synth_instruments;
+    sc.model = cfg.synth_model;
+    sc.rate = cfg.synth_rate;
+    sc.burst_factor = cfg.synth_burst_factor;
+    sc.burst_prob = cfg.synth_burst_prob;
+    sc.burst_len = cfg.synth_burst_len;
+    sc.zipf = cfg.synth_zipf;
+    sc.vol = cfg.synth_vol;
+    sc.mean_revert = cfg.synth_mean_revert;
+    sc.price = cfg.synth_price;
+    sc.tick_size = cfg.synth_tick_size;
+    sc.seed = cfg.synth_seed;
+    sc.events = cfg.synth_events;
+    auto sm = std::make_unique<SyntheticMarketData>(sc);
+    // 合成行情默认不限速；event节拍时按合成时间戳倍速
+    if (cfg.replay_pacing == "event") sm->set_replay_clock(cfg.replay_speed, cfg.replay_max_gap_ms);
+    if (!cfg.synth_store.empty()) sm->set_store_path(cfg.synth_store);
+    md = std::move(sm);
+    td = std::make_unique<BacktestTrader>();
+  } else if (cfg.use_backtest) {
+    // 回放前清洗：按源文件路径、大小与修改时间命名缓存，命中时直接复用
+    if (cfg.backtest_clean && !cfg.backtest_file.empty()) {
+      std::string cleaned, err;
+      if (ensure_clean_ticks(cfg.backtest_clean_dir, cfg.backtest_file, &cleaned, &err)) {
+        cfg.backtest_file = cleaned;
+      } else {
+        std::cerr << "[Main] tick cleaning failed: " << err << ", replaying raw file" << std::endl;
+      }
+    }
+    const bool event_pacing = (cfg.replay_pacing == "event");
+    if (cfg.backtest_bar_replay) {
+      auto bm = std::make_unique<BarReplayMarketData>(cfg.bar_interval_sec, cfg.bar_cache_dir);
+      if (event_pacing) bm->set_replay_clock(cfg.replay_speed, cfg.replay_max_gap_ms);
+      md = std::move(bm);
+    } else {
+      auto bm = std::make_unique<BacktestMarketData>(cfg.backtest_speed_ms);
+      if (event_pacing) bm->set_replay_clock(cfg.replay_speed, cfg.replay_max_gap_ms);
+      md = std::move(bm);
+    }
+    if (event_pacing) {
+      std::cout << "[Main] replay pacing=event speed=" << cfg.replay_speed << "x max_gap_ms=" << cfg.replay_max_gap_ms << std::endl;
+    } else if (cfg.replay_pacing != "fixed") {
+      std::cerr << "[Main] unknown replay_pacing=" << cfg.replay_pacing << ", using fixed" << std::endl;
+    }
     td = std::make_unique<BacktestTrader>();
     // 将md_front改为CSV路径以兼容引擎连接流程
     if (!cfg.backtest_file.empty()) cfg.md_front = cfg.backtest_file;
@@ -105,7 +110,30 @@ int main(int argc, char* argv[]) {
     td = std::make_unique<StubTrader>();
   }
 
-  auto strat = std::make_unique<DualMAStrategy>(cfg.strat_ma_fast, cfg.strat_ma_slow, cfg.strat_threshold);
-  Engine eng{cfg, std::move(md), std::move(td), std::move(strat)};
-  return eng.run();
+  if (!cfg.strategies.empty()) {
+    std::cout << "[Main] hosting " << cfg.strategies.size() << " strategies" << std::endl;
+  } else {
+    std::cout << "[Main] strategy_type=" << cfg.strategy_type;
+    if (cfg.strategy_type == "python_embed") {
+      std::cout << " module=" << cfg.python_module << " class=" << cfg.python_class << " batch=" << cfg.python_batch_size;
+    } else {
+      std::cout << " class=" << cfg.builtin_class;
+    }
+    std::cout << std::endl;
+  }
+  std::vector<HostedStrategy> strategies;
+  if (!StrategyFactory::create_hosted(cfg, &strategies)) return 1;
+  Engine eng{cfg, std::move(md), std::move(td), std::move(strategies)};
+  // 多场景：每个场景各持一套按同一配置创建的策略实例
+  for (const auto& name : cfg.scenarios) {
+    std::vector<HostedStrategy> replica;
+    if (!StrategyFactory::create_hosted(cfg, &replica)) return 1;
+    eng.add_scenario(name, std::move(replica));
+  }
+  g_engine.store(&eng);
+  std::signal(SIGINT, on_stop_signal);
+  std::signal(SIGTERM, on_stop_signal);
+  int rc = eng.run();
+  g_engine.store(nullptr);
+  return rc;
 }
\ No newline at end of file
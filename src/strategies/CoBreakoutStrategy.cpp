@@ -0,0 +1,78 @@
+#include "TradingSystem/strategies/CoBreakoutStrategy.h"
+#include "TradingSystem/Log.h"
+#include "TradingSystem/StrategyFactory.h"
+#include <algorithm>
+#include <iostream>
+
+namespace ts {
+
+CoBreakoutStrategy::CoBreakoutStrategy(int lookback, int hold_bars, double offset, int entry_timeout_ms)
+    : lookback_(std::max(lookback, 1)),
+      hold_bars_(std::max(hold_bars, 1)),
+      offset_(offset),
+      entry_timeout_ms_(entry_timeout_ms > 0 ? entry_timeout_ms : 500) {}
+
+void CoBreakoutStrategy::on_co_bar(const BarEvent& bar) {
+  auto& dq = closes_[bar.instrument];
+  const bool ready = static_cast<int>(dq.size()) >= lookback_;
+  const double hi = ready ? *std::max_element(dq.begin(), dq.end()) : 0.0;
+  const double lo = ready ? *std::min_element(dq.begin(), dq.end()) : 0.0;
+  dq.push_back(bar.close);
+  while (static_cast<int>(dq.size()) > lookback_) dq.pop_front();
+  if (!ready || busy_[bar.instrument]) return;
+  if (bar.close <= hi && bar.close >= lo) return;
+  BreakoutTrade* t = spawn();
+  if (!t) return;
+  t->inst = bar.instrument;
+  t->dir = bar.close > hi ? Direction::Buy : Direction::Sell;
+  t->limit = t->dir == Direction::Buy ? bar.close + offset_ : bar.close - offset_;
+  busy_[bar.instrument] = true;
+  start(*t);
+}
+
+void CoBreakoutStrategy::run(BreakoutTrade& t) {
+  TS_CO_BEGIN(t);
+  ++entries_;
+  place(t, OrderRequest{t.inst, t.dir, Offset::Open, OrderType::Limit, t.limit, 1});
+  TS_CO_AWAIT(t, await_order(t, entry_timeout_ms_));
+  if (!t.order_done) {
+    TS_LOG_DEBUG(Strategy, "[CoBreakout] entry timeout, cancel id=", t.order_id);
+    cancel(t);
+    TS_CO_AWAIT(t, await_order(t, 0));
+  }
+  if (t.filled_qty <= 0) {
+    ++unfilled_;
+    busy_[t.inst] = false;
+    TS_CO_RETURN(t);
+  }
+  t.qty = t.filled_qty;
+  TS_CO_AWAIT(t, await_bars(t, t.inst, hold_bars_));
+  // 平仓直至全部成交：拒单或部分成交后撤单时，剩余手数在下一根Bar重下
+  t.left = t.qty;
+  while (t.left > 0) {
+    place(t, OrderRequest{t.inst, t.dir == Direction::Buy ? Direction::Sell : Direction::Buy, Offset::Close,
+                          OrderType::Market, 0.0, t.left});
+    TS_CO_AWAIT(t, await_order(t, 0));
+    t.left -= std::min(t.filled_qty, t.left);
+    if (t.left > 0) {
+      ++exit_retries_;
+      TS_LOG_WARN(Strategy, "[CoBreakout] exit ", t.order_status, " on ", t.inst, ", ", t.left, " lot(s) left, retry next bar");
+      TS_CO_AWAIT(t, await_bars(t, t.inst, 1));
+    }
+  }
+  ++round_trips_;
+  busy_[t.inst] = false;
+  TS_CO_END(t);
+}
+
+void CoBreakoutStrategy::on_co_stop() {
+  std::cout << "[CoBreakout] entries=" << entries_ << " unfilled=" << unfilled_ << " round_trips=" << round_trips_
+            << " exit_retries=" << exit_retries_ << " open_frames=" << active_frames() << std::endl;
+}
+
+static bool reg = StrategyFactory::register_strategy("CoBreakoutStrategy", [](const AppConfig& cfg) {
+  return std::make_unique<CoBreakoutStrategy>(cfg.co_lookback_bars, cfg.co_hold_bars, cfg.co_entry_offset,
+                                              cfg.co_entry_timeout_ms);
+});
+
+} // namespace ts
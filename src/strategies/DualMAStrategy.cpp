@@ -0,0 +1,123 @@
+#include "TradingSystem/strategies/DualMAStrategy.h"
+#include "TradingSystem/ITrader.h"
+#include "TradingSystem/LiveConfig.h"
+#include "TradingSystem/Log.h"
+#include "TradingSystem/StrategyFactory.h"
+#include "TradingSystem/TimeUtil.h"
+
+namespace ts {
+
+DualMAStrategy::DualMAStrategy(int fast, int slow, double slippage, int order_timeout_ms) {
+  set_params(fast, slow, slippage, order_timeout_ms);
+}
+
+void DualMAStrategy::set_params(int fast, int slow, double slippage, int order_timeout_ms) {
+  fast_ = fast;
+  slow_ = slow;
+  slip_ = slippage;
+  order_timeout_ms_ = order_timeout_ms;
+  if (fast_ < 1) fast_ = 1;
+  if (slow_ < fast_) slow_ = fast_ + 1;
+}
+
+void DualMAStrategy::on_market_data(const MarketDataEvent& md, ITrader* trader) {
+  // 本策略基于Bar触发；Tick仅用于日志或扩展（此处空实现）
+  (void)md; (void)trader;
+}
+
+void DualMAStrategy::on_bar(const BarEvent& bar, ITrader* trader) {
+  // 热更新：快照版本变化时套用新参数；均线窗口随慢线长度伸缩，已挂订单的超时不变
+  const LiveParams* live = live_config() ? live_config()->current() : nullptr;
+  if (live && live->version != params_version_) {
+    set_params(live->strat_ma_fast, live->strat_ma_slow, live->strat_threshold, live->strat_order_timeout_ms);
+    params_version_ = live->version;
+  }
+  auto& dq = bars_[bar.instrument];
+  dq.push_back(bar);
+  while ((int)dq.size() > slow_) dq.pop_front();
+  if ((int)dq.size() < slow_) return;
+
+  double fast_ma = ma(dq, fast_);
+  double slow_ma = ma(dq, slow_);
+
+  auto& pos = position_[bar.instrument];
+  if (fast_ma > slow_ma && pos <= 0) {
+    OrderRequest req{bar.instrument, Direction::Buy, Offset::Open, OrderType::Limit, bar.close + slip_, 1};
+    pos += 1;
+    place(trader, req, 1);
+  } else if (fast_ma < slow_ma && pos >= 0) {
+    OrderRequest req{bar.instrument, Direction::Sell, Offset::Open, OrderType::Limit, bar.close - slip_, 1};
+    pos -= 1;
+    place(trader, req, -1);
+  }
+}
+
+void DualMAStrategy::on_warmup(const std::string& instrument, const BarRecord* bars, size_t n) {
+  auto& dq = bars_[instrument];
+  for (size_t i = 0; i < n; ++i) {
+    BarEvent b;
+    b.instrument = instrument;
+    b.open = bars[i].open;
+    b.high = bars[i].high;
+    b.low = bars[i].low;
+    b.close = bars[i].close;
+    b.volume = static_cast<int>(bars[i].volume);
+    b.ts = format_datetime_ms(bars[i].ts_ms);
+    dq.push_back(std::move(b));
+  }
+  while ((int)dq.size() > slow_) dq.pop_front();
+}
+
+void DualMAStrategy::place(ITrader* trader, const OrderRequest& req, int sign) {
+  placing_ = true;
+  std::string id = trader->place_order(req);
+  placing_ = false;
+  // 下单期间已同步完结（回测立即成交、风控拒单）的订单不再计时；记录只在本次调用内有效
+  const bool done = completed_.count(id) > 0;
+  completed_.clear();
+  if (order_timeout_ms_ <= 0 || !timers() || id.empty() || done) return;
+  uint64_t tid = timers()->schedule_timer(order_timeout_ms_);
+  pending_[id] = Pending{tid, req.instrument, sign};
+  timer_orders_[tid] = id;
+}
+
+void DualMAStrategy::on_order_status(const OrderStatusEvent& ev) {
+  TS_LOG_DEBUG(Strategy, "[Strategy] OrderStatus id=", ev.order_id, " status=", ev.status,
+               " inst=", ev.instrument, " qty=", ev.filled_qty, " px=", ev.fill_price,
+               " remaining=", ev.remaining_qty, " msg=", ev.message);
+  if (order_timeout_ms_ <= 0 || !timers()) return;
+  if (ev.status != "Filled" && ev.status != "Canceled" && ev.status != "Rejected") return;
+  auto it = pending_.find(ev.order_id);
+  if (it == pending_.end()) {
+    if (placing_) completed_.insert(ev.order_id);
+    return;
+  }
+  if (ev.status != "Filled" && ev.remaining_qty > 0) position_[it->second.instrument] -= it->second.sign * ev.remaining_qty;
+  if (timers()) timers()->cancel_timer(it->second.timer_id);
+  timer_orders_.erase(it->second.timer_id);
+  pending_.erase(it);
+}
+
+void DualMAStrategy::on_timer(uint64_t timer_id, uint64_t user_data, ITrader* trader) {
+  (void)user_data;
+  auto it = timer_orders_.find(timer_id);
+  if (it == timer_orders_.end()) return;
+  // 撤单回报可能同步到达并清理记录，先取出ID
+  std::string order_id = std::move(it->second);
+  timer_orders_.erase(it);
+  TS_LOG_DEBUG(Strategy, "[Strategy] order timeout, cancel id=", order_id);
+  trader->cancel_order(order_id);
+}
+
+double DualMAStrategy::ma(const std::deque<BarEvent>& dq, int n) {
+  double s = 0.0; int cnt = 0;
+  for (int i = (int)dq.size() - n; i < (int)dq.size(); ++i) { if (i >= 0) { s += dq[i].close; ++cnt; } }
+  return cnt ? s / cnt : 0.0;
+}
+
+static bool reg = StrategyFactory::register_strategy("DualMAStrategy", [](const AppConfig& cfg) {
+  return std::make_unique<DualMAStrategy>(cfg.strat_ma_fast, cfg.strat_ma_slow, cfg.strat_threshold,
+                                          cfg.strat_order_timeout_ms);
+});
+
+} // namespace ts
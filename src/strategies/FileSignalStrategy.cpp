@@ -0,0 +1,119 @@
+#include "TradingSystem/strategies/FileSignalStrategy.h"
+#include "TradingSystem/ITrader.h"
+#include "TradingSystem/Log.h"
+#include "TradingSystem/StrategyFactory.h"
+#include "TradingSystem/TimeUtil.h"
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace ts {
+namespace {
+std::string_view trim(std::string_view s) {
+  while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+  return s;
+}
+} // namespace
+
+FileSignalStrategy::FileSignalStrategy(std::string path) : path_(std::move(path)) {
+  if (!file_.open(path_)) {
+    std::cerr << "[FileSignal] cannot open signals file: " << path_ << std::endl;
+  } else {
+    std::cout << "[FileSignal] signals=" << path_ << " bytes=" << file_.size() << std::endl;
+  }
+}
+
+bool FileSignalStrategy::peek(Signal* out) {
+  const char* base = file_.data();
+  const size_t size = file_.size();
+  size_t pos = pos_;
+  while (pos < size) {
+    const char* nl = static_cast<const char*>(std::memchr(base + pos, '\n', size - pos));
+    size_t eol = nl ? static_cast<size_t>(nl - base) : size;
+    std::string_view line(base + pos, eol - pos);
+    size_t line_start = pos;
+    pos = eol + 1;
+    line = trim(line);
+    if (line.empty() || line[0] == '#') { pos_ = pos; continue; }
+    std::string_view cols[8];
+    size_t nc = 0, b = 0;
+    while (nc < 8) {
+      size_t c = line.find(',', b);
+      cols[nc++] = trim(line.substr(b, c == std::string_view::npos ? std::string_view::npos : c - b));
+      if (c == std::string_view::npos) break;
+      b = c + 1;
+    }
+    int64_t ts = nc >= 8 ? parse_datetime_ms(cols[1]) : -1;
+    if (ts < 0) {
+      // 表头或非法行：直接越过
+      if (line_start != 0) ++skipped_;
+      pos_ = pos;
+      continue;
+    }
+    out->id = cols[0];
+    out->ts_ms = ts;
+    auto& r = out->req;
+    r.instrument.assign(cols[2].data(), cols[2].size());
+    r.direction = (cols[3] == "Sell" || cols[3] == "S" || cols[3] == "-1") ? Direction::Sell : Direction::Buy;
+    r.offset = (cols[4] == "Close" || cols[4] == "C") ? Offset::Close : Offset::Open;
+    r.type = cols[5] == "Market" ? OrderType::Market
+           : cols[5] == "IOC"    ? OrderType::IOC
+           : cols[5] == "FOK"    ? OrderType::FOK
+                                 : OrderType::Limit;
+    r.price = 0.0;
+    std::from_chars(cols[6].data(), cols[6].data() + cols[6].size(), r.price);
+    r.volume = 0;
+    std::from_chars(cols[7].data(), cols[7].data() + cols[7].size(), r.volume);
+    if (r.price <= 0.0) r.type = OrderType::Market;
+    if (r.instrument.empty() || r.volume <= 0) { ++skipped_; pos_ = pos; continue; }
+    next_pos_ = pos;
+    return true;
+  }
+  pos_ = pos;
+  return false;
+}
+
+void FileSignalStrategy::on_market_data(const MarketDataEvent& md, ITrader* trader) {
+  if (!file_.is_open() || !trader) return;
+  int64_t now = parse_datetime_ms(md.update_time);
+  if (now < 0) {
+    if (!warned_no_ts_) {
+      std::cerr << "[FileSignal] tick without parseable timestamp (" << md.update_time << "), signals paused" << std::endl;
+      warned_no_ts_ = true;
+    }
+    return;
+  }
+  // 归并：发出所有时间戳不晚于当前行情的信号
+  Signal sig;
+  while (peek(&sig) && sig.ts_ms <= now) {
+    if (sig.ts_ms < last_signal_ts_) {
+      TS_LOG_WARN(Strategy, "[FileSignal] out-of-order signal id=", sig.id);
+    }
+    last_signal_ts_ = sig.ts_ms;
+    advance();
+    ++emitted_;
+    TS_LOG_DEBUG(Strategy, "[FileSignal] signal id=", sig.id, " inst=", sig.req.instrument,
+                 " qty=", sig.req.volume, " px=", sig.req.price);
+    trader->place_order(sig.req);
+  }
+}
+
+void FileSignalStrategy::on_stop(ITrader* trader) {
+  std::cout << "[FileSignal] emitted=" << emitted_ << " skipped=" << skipped_
+            << " remaining_bytes=" << (file_.size() > pos_ ? file_.size() - pos_ : 0) << std::endl;
+}
+
+static bool reg = StrategyFactory::register_strategy("FileSignalStrategy", [](const AppConfig& cfg) -> std::unique_ptr<Strategy> {
+  // 含目录分隔符或盘符的按原样使用，否则视为相对csv_dir
+  std::string path = cfg.signals_file.empty() ? std::string("signals.csv") : cfg.signals_file;
+  if (path.find_first_of(":/\\") == std::string::npos) {
+    path = (std::filesystem::path(cfg.csv_dir) / path).string();
+  }
+  auto s = std::make_unique<FileSignalStrategy>(path);
+  if (!s->ok()) return nullptr;
+  return s;
+});
+
+} // namespace ts
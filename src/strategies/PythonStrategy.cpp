@@ -0,0 +1,359 @@
+#ifdef USE_PY_EMBED
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "TradingSystem/strategies/PythonStrategy.h"
+#include "TradingSystem/ITrader.h"
+#include "TradingSystem/StrategyFactory.h"
+#include "TradingSystem/TimeUtil.h"
+#include <iostream>
+
+namespace ts {
+namespace {
+
+// 持有GIL的RAII守卫
+struct Gil {
+  PyGILState_STATE st;
+  Gil() : st(PyGILState_Ensure()) {}
+  ~Gil() { PyGILState_Release(st); }
+};
+
+// 解释器按进程初始化一次：首个实例初始化并释放主线程状态，最后一个实例析构时终止。
+// 多个PythonStrategy（含场景副本）共享同一解释器，各自经PyGILState_Ensure取得GIL
+std::mutex g_py_mu;
+int g_py_refs = 0;
+PyThreadState* g_py_main = nullptr;
+
+void py_acquire() {
+  std::lock_guard<std::mutex> lk(g_py_mu);
+  if (g_py_refs++ == 0) {
+    Py_InitializeEx(0);
+    g_py_main = PyEval_SaveThread();
+  }
+}
+
+void py_release() {
+  std::lock_guard<std::mutex> lk(g_py_mu);
+  if (--g_py_refs == 0) {
+    PyEval_RestoreThread(g_py_main);
+    g_py_main = nullptr;
+    Py_FinalizeEx();
+  }
+}
+
+void print_py_error(const char* where) {
+  std::cerr << "[PyBridge] error in " << where << std::endl;
+  if (PyErr_Occurred()) PyErr_Print();
+}
+
+// 以缓冲区协议暴露一段连续内存（只读、一维），format为struct模块格式字符
+PyObject* make_view(void* data, Py_ssize_t n, Py_ssize_t itemsize, const char* fmt) {
+  Py_ssize_t shape = n;
+  Py_ssize_t stride = itemsize;
+  Py_buffer buf{};
+  buf.buf = data;
+  buf.obj = nullptr;
+  buf.len = n * itemsize;
+  buf.readonly = 1;
+  buf.itemsize = itemsize;
+  buf.format = const_cast<char*>(fmt);
+  buf.ndim = 1;
+  buf.shape = &shape;  // memoryview会拷贝shape/strides
+  buf.strides = &stride;
+  return PyMemoryView_FromBuffer(&buf);
+}
+
+template <class T>
+const char* fmt_of();
+template <> const char* fmt_of<int32_t>() { return "i"; }
+template <> const char* fmt_of<int64_t>() { return "q"; }
+template <> const char* fmt_of<double>() { return "d"; }
+
+std::string dict_str(PyObject* d, const char* key) {
+  PyObject* v = PyDict_GetItemString(d, key);  // borrowed
+  if (!v || !PyUnicode_Check(v)) return std::string();
+  const char* s = PyUnicode_AsUTF8(v);
+  return s ? std::string(s) : std::string();
+}
+
+} // namespace
+
+PythonStrategy::PythonStrategy(const std::string& module, const std::string& cls, const std::string& path,
+                               int batch_size)
+    : batch_(batch_size > 0 ? batch_size : 1) {
+  auto alloc = [this](auto& v) { v.assign(static_cast<size_t>(batch_), {}); };
+  alloc(ticks_.inst); alloc(ticks_.ts); alloc(ticks_.last); alloc(ticks_.bid); alloc(ticks_.ask);
+  alloc(ticks_.bid_vol); alloc(ticks_.ask_vol); alloc(ticks_.volume);
+  alloc(bars_.inst); alloc(bars_.ts); alloc(bars_.open); alloc(bars_.high); alloc(bars_.low); alloc(bars_.close);
+  alloc(bars_.volume);
+
+  py_acquire();
+  Gil g;
+  if (!path.empty()) {
+    PyObject* sys_path = PySys_GetObject("path");  // borrowed
+    PyObject* p = PyUnicode_FromString(path.c_str());
+    if (sys_path && p) PyList_Insert(sys_path, 0, p);
+    Py_XDECREF(p);
+  }
+  PyObject* mod = PyImport_ImportModule(module.c_str());
+  PyObject* klass = mod ? PyObject_GetAttrString(mod, cls.c_str()) : nullptr;
+  obj_ = klass ? PyObject_CallNoArgs(klass) : nullptr;
+  Py_XDECREF(klass);
+  Py_XDECREF(mod);
+  if (!obj_) {
+    print_py_error("load strategy");
+    std::cerr << "[PyBridge] cannot load " << module << "." << cls << " (python_path=" << path << ")" << std::endl;
+  } else {
+    has_on_ticks_ = PyObject_HasAttrString(obj_, "on_ticks");
+    has_on_bars_ = PyObject_HasAttrString(obj_, "on_bars");
+    // 列视图挂到策略对象上：self.ticks.last[:n] / self.bars.close[:n]，下标为合约序号见self.instruments
+    PyObject* types = PyImport_ImportModule("types");
+    PyObject* ns_type = types ? PyObject_GetAttrString(types, "SimpleNamespace") : nullptr;
+    auto make_ns = [&](std::initializer_list<std::pair<const char*, PyObject*>> cols) {
+      PyObject* kw = PyDict_New();
+      for (const auto& c : cols) {
+        PyDict_SetItemString(kw, c.first, c.second);
+        views_.push_back(c.second);
+      }
+      PyObject* args = PyTuple_New(0);
+      PyObject* ns = ns_type ? PyObject_Call(ns_type, args, kw) : nullptr;
+      Py_DECREF(args);
+      Py_DECREF(kw);
+      return ns;
+    };
+    auto view = [this](auto& v) {
+      using T = typename std::decay_t<decltype(v)>::value_type;
+      return make_view(v.data(), static_cast<Py_ssize_t>(batch_), sizeof(T), fmt_of<T>());
+    };
+    PyObject* tick_ns = make_ns({{"inst", view(ticks_.inst)}, {"ts", view(ticks_.ts)}, {"last", view(ticks_.last)},
+                                 {"bid", view(ticks_.bid)}, {"ask", view(ticks_.ask)},
+                                 {"bid_vol", view(ticks_.bid_vol)}, {"ask_vol", view(ticks_.ask_vol)},
+                                 {"volume", view(ticks_.volume)}});
+    PyObject* bar_ns = make_ns({{"inst", view(bars_.inst)}, {"ts", view(bars_.ts)}, {"open", view(bars_.open)},
+                                {"high", view(bars_.high)}, {"low", view(bars_.low)}, {"close", view(bars_.close)},
+                                {"volume", view(bars_.volume)}});
+    py_names_ = PyList_New(0);
+    if (tick_ns && bar_ns && py_names_) {
+      PyObject_SetAttrString(obj_, "ticks", tick_ns);
+      PyObject_SetAttrString(obj_, "bars", bar_ns);
+      PyObject_SetAttrString(obj_, "instruments", py_names_);
+    } else {
+      print_py_error("init columns");
+    }
+    Py_XDECREF(tick_ns);
+    Py_XDECREF(bar_ns);
+    Py_XDECREF(ns_type);
+    Py_XDECREF(types);
+    call_optional("on_init", nullptr);
+    std::cout << "[PyBridge] loaded " << module << "." << cls << " batch=" << batch_ << std::endl;
+  }
+}
+
+PythonStrategy::~PythonStrategy() {
+  {
+    Gil g;
+    for (PyObject* v : views_) Py_XDECREF(v);
+    Py_XDECREF(py_names_);
+    Py_XDECREF(obj_);
+  }
+  py_release();
+}
+
+int32_t PythonStrategy::intern(const std::string& inst) {
+  auto it = ids_.find(inst);
+  if (it != ids_.end()) return it->second;
+  int32_t id = static_cast<int32_t>(names_.size());
+  names_.push_back(inst);
+  ids_.emplace(inst, id);
+  return id;
+}
+
+void PythonStrategy::sync_instruments() {
+  for (; names_synced_ < names_.size(); ++names_synced_) {
+    PyObject* s = PyUnicode_FromString(names_[names_synced_].c_str());
+    PyList_Append(py_names_, s);
+    Py_XDECREF(s);
+  }
+}
+
+void PythonStrategy::on_market_data(const MarketDataEvent& md, ITrader* trader) {
+  if (!obj_ || !has_on_ticks_) return;
+  std::lock_guard<std::recursive_mutex> lk(mu_);
+  trader_ = trader;
+  size_t i = n_ticks_++;
+  ticks_.inst[i] = intern(md.instrument);
+  ticks_.ts[i] = parse_datetime_ms(md.update_time);
+  ticks_.last[i] = md.last_price;
+  ticks_.bid[i] = md.bid_price;
+  ticks_.ask[i] = md.ask_price;
+  ticks_.bid_vol[i] = md.bid_volume;
+  ticks_.ask_vol[i] = md.ask_volume;
+  ticks_.volume[i] = md.volume;
+  if (n_ticks_ >= static_cast<size_t>(batch_)) flush_ticks(trader);
+}
+
+void PythonStrategy::on_bar(const BarEvent& bar, ITrader* trader) {
+  if (!obj_ || !has_on_bars_) return;
+  std::lock_guard<std::recursive_mutex> lk(mu_);
+  trader_ = trader;
+  flush_ticks(trader);  // 保持事件因果顺序
+  size_t i = n_bars_++;
+  bars_.inst[i] = intern(bar.instrument);
+  bars_.ts[i] = parse_datetime_ms(bar.ts);
+  bars_.open[i] = bar.open;
+  bars_.high[i] = bar.high;
+  bars_.low[i] = bar.low;
+  bars_.close[i] = bar.close;
+  bars_.volume[i] = bar.volume;
+  if (n_bars_ >= static_cast<size_t>(batch_)) flush_bars(trader);
+}
+
+void PythonStrategy::flush_ticks(ITrader* trader) {
+  if (n_ticks_ == 0) return;
+  std::vector<Action> actions;
+  {
+    Gil g;
+    sync_instruments();
+    PyObject* res = PyObject_CallMethod(obj_, "on_ticks", "n", static_cast<Py_ssize_t>(n_ticks_));
+    n_ticks_ = 0;
+    if (!res) print_py_error("on_ticks");
+    else collect_actions(res, &actions);
+    Py_XDECREF(res);
+  }
+  execute(actions, trader);
+}
+
+void PythonStrategy::flush_bars(ITrader* trader) {
+  if (n_bars_ == 0) return;
+  std::vector<Action> actions;
+  {
+    Gil g;
+    sync_instruments();
+    PyObject* res = PyObject_CallMethod(obj_, "on_bars", "n", static_cast<Py_ssize_t>(n_bars_));
+    n_bars_ = 0;
+    if (!res) print_py_error("on_bars");
+    else collect_actions(res, &actions);
+    Py_XDECREF(res);
+  }
+  execute(actions, trader);
+}
+
+void PythonStrategy::collect_actions(PyObject* res, std::vector<Action>* out) {
+  if (res == Py_None) return;
+  PyObject* seq = PySequence_Fast(res, "strategy callback must return a list of order dicts or None");
+  if (!seq) { print_py_error("collect orders"); return; }
+  Py_ssize_t n = PySequence_Fast_GET_SIZE(seq);
+  for (Py_ssize_t i = 0; i < n; ++i) {
+    PyObject* d = PySequence_Fast_GET_ITEM(seq, i);
+    if (!PyDict_Check(d)) continue;
+    Action a;
+    std::string act = dict_str(d, "action");
+    if (act == "Cancel" || act == "X") {
+      a.cancel = true;
+      a.order_id = dict_str(d, "order_id");
+      out->push_back(std::move(a));
+      continue;
+    }
+    a.req.instrument = dict_str(d, "instrument");
+    a.req.direction = (dict_str(d, "side") == "Sell") ? Direction::Sell : Direction::Buy;
+    a.req.offset = (dict_str(d, "offset") == "Close") ? Offset::Close : Offset::Open;
+    std::string type = dict_str(d, "type");
+    a.req.type = type == "Market" ? OrderType::Market
+               : type == "IOC"    ? OrderType::IOC
+               : type == "FOK"    ? OrderType::FOK
+                                  : OrderType::Limit;
+    if (PyObject* px = PyDict_GetItemString(d, "price")) a.req.price = PyFloat_AsDouble(px);
+    if (PyObject* q = PyDict_GetItemString(d, "qty")) a.req.volume = static_cast<int>(PyLong_AsLong(q));
+    if (PyErr_Occurred()) { print_py_error("order fields"); continue; }
+    if (PyObject* cid = PyDict_GetItemString(d, "client_order_id")) { Py_INCREF(cid); a.client_id = cid; }
+    if (a.req.instrument.empty() || a.req.volume <= 0) {
+      Py_XDECREF(a.client_id);
+      continue;
+    }
+    out->push_back(std::move(a));
+  }
+  Py_DECREF(seq);
+}
+
+void PythonStrategy::execute(std::vector<Action>& actions, ITrader* trader) {
+  if (actions.empty()) return;
+  if (!trader) {
+    Gil g;
+    for (auto& a : actions) Py_XDECREF(a.client_id);
+    return;
+  }
+  std::vector<std::string> ids(actions.size());
+  for (size_t i = 0; i < actions.size(); ++i) {
+    if (actions[i].cancel) trader->cancel_order(actions[i].order_id);
+    else ids[i] = trader->place_order(actions[i].req);
+  }
+  Gil g;
+  bool notify = PyObject_HasAttrString(obj_, "on_order_placed");
+  for (size_t i = 0; i < actions.size(); ++i) {
+    auto& a = actions[i];
+    if (!a.cancel && notify) {
+      const auto& r = a.req;
+      PyObject* d = Py_BuildValue("{s:s,s:s,s:s,s:s,s:s,s:d,s:i}", "order_id", ids[i].c_str(),
+                                  "instrument", r.instrument.c_str(),
+                                  "side", r.direction == Direction::Buy ? "Buy" : "Sell",
+                                  "offset", r.offset == Offset::Open ? "Open" : "Close",
+                                  "type", r.type == OrderType::Market ? "Market"
+                                        : r.type == OrderType::IOC    ? "IOC"
+                                        : r.type == OrderType::FOK    ? "FOK" : "Limit",
+                                  "price", r.price, "qty", r.volume);
+      if (d && a.client_id) PyDict_SetItemString(d, "client_order_id", a.client_id);
+      if (d) call_optional("on_order_placed", d);
+      Py_XDECREF(d);
+    }
+    Py_XDECREF(a.client_id);
+  }
+}
+
+bool PythonStrategy::call_optional(const char* name, PyObject* arg) {
+  if (!PyObject_HasAttrString(obj_, name)) return false;
+  PyObject* res = arg ? PyObject_CallMethod(obj_, name, "O", arg) : PyObject_CallMethod(obj_, name, nullptr);
+  if (!res) print_py_error(name);
+  Py_XDECREF(res);
+  return res != nullptr;
+}
+
+void PythonStrategy::on_order_status(const OrderStatusEvent& ev) {
+  if (!obj_) return;
+  std::lock_guard<std::recursive_mutex> lk(mu_);
+  flush_ticks(trader_);
+  flush_bars(trader_);
+  Gil g;
+  if (!PyObject_HasAttrString(obj_, "on_order_status")) return;
+  PyObject* d = Py_BuildValue("{s:s,s:s,s:s,s:s,s:i,s:d,s:i}", "order_id", ev.order_id.c_str(),
+                              "status", ev.status.c_str(), "message", ev.message.c_str(),
+                              "instrument", ev.instrument.c_str(), "filled_qty", ev.filled_qty,
+                              "fill_price", ev.fill_price, "remaining_qty", ev.remaining_qty);
+  if (d) call_optional("on_order_status", d);
+  else print_py_error("on_order_status");
+  Py_XDECREF(d);
+}
+
+void PythonStrategy::on_start(ITrader* trader) {
+  if (!obj_) return;
+  std::lock_guard<std::recursive_mutex> lk(mu_);
+  trader_ = trader;
+  Gil g;
+  call_optional("on_start", nullptr);
+}
+
+void PythonStrategy::on_stop(ITrader* trader) {
+  if (!obj_) return;
+  std::lock_guard<std::recursive_mutex> lk(mu_);
+  flush_ticks(trader);
+  flush_bars(trader);
+  Gil g;
+  call_optional("on_stop", nullptr);
+}
+
+static bool reg = StrategyFactory::register_strategy("PythonStrategy", [](const AppConfig& cfg) -> std::unique_ptr<Strategy> {
+  auto s = std::make_unique<PythonStrategy>(cfg.python_module, cfg.python_class, cfg.python_path, cfg.python_batch_size);
+  if (!s->ok()) return nullptr;
+  return s;
+});
+
+} // namespace ts
+#endif
@@ -1,4 +1,5 @@
 #include "stub/StubMarketData.h"
+#include "TradingSystem/ThreadManager.h"
 #include "TradingSystem/Event.h"
 #include <iostream>
 #include <chrono>
@@ -32,6 +33,7 @@ void StubMarketData::set_market_data_handler(IMarketData::MarketDataHandler hand
 }
 
 void StubMarketData::run_loop() {
+  ThreadManager::instance().enter(ThreadRole::Feed);
   std::uniform_real_distribution<double> dist(100.0, 500.0);
   int ticks = 0;
   while (running_.load() && ticks < 200) {
@@ -51,7 +53,9 @@ void StubMarketData::run_loop() {
   running_.store(false);
 }
 
-StubMarketData::~StubMarketData() {
+StubMarketData::~StubMarketData() { stop(); }
+
+void StubMarketData::stop() {
   running_.store(false);
   if (worker_.joinable()) worker_.join();
 }
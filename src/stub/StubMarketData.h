@@ -13,6 +13,7 @@ class StubMarketData : public IMarketData {
   bool login(const std::string& broker_id, const std::string& user_id, const std::string& password) override;
   bool subscribe(const std::vector<std::string>& instruments) override;
   void set_market_data_handler(MarketDataHandler handler) override;
+  void stop() override;
  private:
   void run_loop();
   std::vector<std::string> instruments_;
@@ -1,4 +1,5 @@
 #include "stub/StubTrader.h"
+#include "TradingSystem/Log.h"
 #include <iostream>
 #include <cstdlib>
 #include <thread>
@@ -17,9 +18,9 @@ bool StubTrader::login(const std::string& broker_id, const std::string& user_id,
 
 std::string StubTrader::place_order(const OrderRequest& req) {
   std::string id = "STUB_" + std::to_string(std::rand());
-  std::cout << "[StubTD] Place order id=" << id << " " << req.instrument
-            << " dir=" << (req.direction == Direction::Buy ? "Buy":"Sell")
-            << " vol=" << req.volume << " price=" << req.price << std::endl;
+  TS_LOG_INFO(Trader, "[StubTD] Place order id=", id, " ", req.instrument,
+              " dir=", (req.direction == Direction::Buy ? "Buy" : "Sell"),
+              " vol=", req.volume, " price=", req.price);
   if (handler_) {
     OrderStatusEvent ev; ev.order_id = id; ev.status = "Accepted"; ev.message = "Order accepted";
     ev.instrument = req.instrument; ev.filled_qty = 0; ev.fill_price = 0.0; ev.remaining_qty = req.volume;
@@ -42,6 +43,16 @@ bool StubTrader::cancel_order(const std::string& order_id) {
   return true;
 }
 
+std::string StubTrader::modify_order(const std::string& order_id, double new_price, int new_qty) {
+  TS_LOG_INFO(Trader, "[StubTD] Modify order ", order_id, " vol=", new_qty, " price=", new_price);
+  if (handler_) {
+    OrderStatusEvent ev{order_id, "Modified", "Order modified"};
+    ev.remaining_qty = new_qty;
+    handler_(ev);
+  }
+  return order_id;
+}
+
 void StubTrader::set_order_status_handler(OrderStatusHandler handler) {
   handler_ = std::move(handler);
 }
@@ -8,6 +8,7 @@ class StubTrader : public ITrader {
   bool login(const std::string& broker_id, const std::string& user_id, const std::string& password) override;
   std::string place_order(const OrderRequest& req) override;
   bool cancel_order(const std::string& order_id) override;
+  std::string modify_order(const std::string& order_id, double new_price, int new_qty) override;
   void set_order_status_handler(OrderStatusHandler handler) override;
  private:
   OrderStatusHandler handler_;
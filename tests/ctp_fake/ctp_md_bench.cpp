@@ -0,0 +1,135 @@
+// 深度行情回调基准：旧回调（只拷贝部分字段）、按字符串查表的同语义转换与CtpDepthConverter就地改写，另测转换与查表单项耗时
+#include "ctp/CtpMarketData.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static std::atomic<long> g_allocs{0};
+void* operator new(size_t n) {
+  ++g_allocs;
+  void* p = std::malloc(n);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+using namespace ts;
+
+namespace {
+// 与转换器输出相同的字符串做法：逐笔构造合约键查哈希表做成交量差分，时间格式化为新字符串
+struct NaiveState {
+  int last_volume{0};
+  double last_turnover{0.0};
+  std::string trading_day;
+};
+
+MarketDataEvent naive_convert(const CThostFtdcDepthMarketDataField& d,
+                              std::unordered_map<std::string, NaiveState>* states) {
+  MarketDataEvent ev;
+  ev.instrument = d.InstrumentID;
+  auto price = [](double p) { return p < 1e300 ? p : 0.0; };
+  ev.last_price = price(d.LastPrice);
+  ev.bid_price = price(d.BidPrice1);
+  ev.ask_price = price(d.AskPrice1);
+  ev.bid_volume = d.BidVolume1;
+  ev.ask_volume = d.AskVolume1;
+  ev.open_interest = d.OpenInterest;
+  NaiveState& st = (*states)[ev.instrument];
+  if (st.trading_day != d.TradingDay) {
+    st.last_volume = st.trading_day.empty() ? d.Volume : 0;
+    st.last_turnover = st.trading_day.empty() ? d.Turnover : 0.0;
+    st.trading_day = d.TradingDay;
+  }
+  ev.volume = d.Volume > st.last_volume ? d.Volume - st.last_volume : 0;
+  ev.turnover = d.Turnover > st.last_turnover ? d.Turnover - st.last_turnover : 0.0;
+  if (d.Volume >= st.last_volume) {
+    st.last_volume = d.Volume;
+    st.last_turnover = d.Turnover;
+  }
+  const char* day = d.ActionDay[0] ? d.ActionDay : d.TradingDay;
+  char t[32];
+  std::snprintf(t, sizeof(t), "%.4s-%.2s-%.2s %.8s.%03d", day, day + 4, day + 6, d.UpdateTime, d.UpdateMillisec);
+  ev.update_time = t;
+  return ev;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const int N = argc > 1 ? std::atoi(argv[1]) : 2000000;
+  std::vector<std::string> subs;
+  for (int i = 0; i < 200; ++i) subs.push_back("rb" + std::to_string(2400 + i));
+  std::vector<CThostFtdcDepthMarketDataField> feed(256);
+  for (size_t i = 0; i < feed.size(); ++i) {
+    auto& d = feed[i];
+    std::memset(&d, 0, sizeof(d));
+    std::strcpy(d.InstrumentID, subs[i % subs.size()].c_str());
+    std::strcpy(d.TradingDay, "20240102");
+    std::strcpy(d.ActionDay, "20240102");
+    std::strcpy(d.UpdateTime, "10:15:30");
+    d.UpdateMillisec = static_cast<int>(i % 1000);
+    d.Volume = static_cast<int>(1000 + i);
+    d.LastPrice = 3500 + static_cast<double>(i % 10);
+    d.Turnover = d.Volume * d.LastPrice * 10;
+  }
+  auto ns_per = [&](std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / N;
+  };
+
+  CtpMarketData md;
+  md.subscribe(subs);
+  const MarketDataEvent* last = nullptr;
+  md.set_market_data_handler([&](const MarketDataEvent& e) { last = &e; });
+  std::function<void(const MarketDataEvent&)> h = [&](const MarketDataEvent& e) { last = &e; };
+  std::unordered_map<std::string, NaiveState> naive_states;
+  const char* names[] = {"old", "string", "converter"};
+  for (int mode = 0; mode < 3; ++mode) {
+    long a0 = g_allocs;
+    double sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; ++i) {
+      auto& p = feed[i & 255];
+      if (mode == 0) {
+        // 改动前的回调：只拷贝合约、价格、累计成交量与不带日期的时间
+        MarketDataEvent ev;
+        ev.instrument = p.InstrumentID;
+        ev.last_price = p.LastPrice;
+        ev.bid_price = p.BidPrice1;
+        ev.ask_price = p.AskPrice1;
+        ev.volume = p.Volume;
+        ev.update_time = p.UpdateTime;
+        h(ev);
+        sink += last->last_price + last->instrument.size();
+      } else if (mode == 1) {
+        h(naive_convert(p, &naive_states));
+        sink += last->last_price + last->instrument.size();
+      } else {
+        md.OnRtnDepthMarketData(&p);
+        sink += last->last_price + last->instrument.size();
+      }
+    }
+    std::printf("%-9s %.1f ns/callback, %.3f allocs/callback (sink %g)\n", names[mode], ns_per(t0),
+                double(g_allocs - a0) / N, sink);
+  }
+
+  CtpDepthConverter c;
+  std::unordered_map<std::string, int> ids;
+  for (const auto& s : subs) ids.emplace(s, c.add(s.c_str()));
+  double sink = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; ++i) sink += c.convert(feed[i & 255])->volume;
+  std::printf("convert   %.1f ns\n", ns_per(t0));
+  t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; ++i) sink += ids.find(feed[i & 255].InstrumentID)->second;
+  std::printf("lookup    %.1f ns (std::string key)\n", ns_per(t0));
+  t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; ++i) sink += c.find(feed[i & 255].InstrumentID);
+  std::printf("lookup    %.1f ns (converter, sink %g)\n", ns_per(t0), sink);
+  return 0;
+}
@@ -0,0 +1,100 @@
+// CtpMarketData/CtpDepthConverter场景：增量成交量与成交额、时间戳拼接、无效价、合约键查表与stop后不再派发
+#include "ctp/CtpMarketData.h"
+#include <cfloat>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace ts;
+
+static int g_fail = 0;
+#define CHECK(c) do { if (!(c)) { std::printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #c); ++g_fail; } } while (0)
+
+static void fill(CThostFtdcDepthMarketDataField& d, const char* inst, const char* day, const char* t, int ms, int vol,
+                 double px) {
+  std::memset(&d, 0, sizeof(d));
+  std::strcpy(d.TradingDay, day);
+  std::strcpy(d.ActionDay, day);
+  std::strcpy(d.InstrumentID, inst);
+  std::strcpy(d.UpdateTime, t);
+  d.UpdateMillisec = ms;
+  d.Volume = vol;
+  d.Turnover = vol * px * 10;
+  d.OpenInterest = 12345;
+  d.LastPrice = px;
+  d.BidPrice1 = px - 1;
+  d.BidVolume1 = 7;
+  d.AskPrice1 = DBL_MAX;
+  d.AskVolume1 = 0;
+}
+
+int main() {
+  std::printf("1) depth conversion\n");
+  {
+    CtpMarketData md;
+    md.subscribe({"rb2410", "rb2501"});
+    std::vector<MarketDataEvent> got;
+    md.set_market_data_handler([&](const MarketDataEvent& e) { got.push_back(e); });
+    CThostFtdcDepthMarketDataField d;
+    fill(d, "rb2410", "20240102", "09:00:00", 500, 1000, 3500);
+    md.OnRtnDepthMarketData(&d);
+    fill(d, "rb2410", "20240102", "09:00:00", 500, 1012, 3501);
+    md.OnRtnDepthMarketData(&d);
+    fill(d, "rb2410", "20240103", "21:00:01", 0, 30, 3502);
+    md.OnRtnDepthMarketData(&d);
+    CHECK(got.size() == 3);
+    if (got.size() == 3) {
+      // 首笔无基准记0；同日按累计值差分；换日后重新累计
+      CHECK(got[0].volume == 0 && got[0].turnover == 0);
+      CHECK(got[1].volume == 12 && got[1].turnover == 1012 * 3501.0 * 10 - 1000 * 3500.0 * 10);
+      CHECK(got[2].volume == 30);
+      CHECK(got[0].update_time == "2024-01-02 09:00:00.500");
+      CHECK(got[2].update_time == "2024-01-03 21:00:01.000");
+      CHECK(got[1].bid_price == 3500 && got[1].bid_volume == 7);
+      CHECK(got[1].ask_price == 0 && got[1].ask_volume == 0);  // DBL_MAX记0
+      CHECK(got[1].open_interest == 12345);
+    }
+    std::printf("2) stop: callbacks after stop are dropped\n");
+    md.stop();
+    fill(d, "rb2501", "20240102", "09:00:02", 0, 5, 3600);
+    md.OnRtnDepthMarketData(&d);
+    CHECK(got.size() == 3);
+  }
+
+  std::printf("3) instrument keys\n");
+  {
+    CtpDepthConverter c(4);
+    const char* names[] = {"a", "rb2410", "12345678", "123456789", "1234567890123456", "12345678901234567",
+                           "12345678901234567890ABC", "12345678901234567890ABD"};
+    for (auto n : names) c.add(n);
+    CHECK(c.size() == 8);
+    for (int i = 0; i < 8; ++i) {
+      CThostFtdcDepthMarketDataField d{};
+      // 合约代码之后残留非零字节，键只取到结尾的'\0'
+      std::memset(d.InstrumentID, 'x', sizeof(d.InstrumentID));
+      std::strcpy(d.InstrumentID, names[i]);
+      std::strcpy(d.TradingDay, "20240102");
+      std::strcpy(d.UpdateTime, "09:00:00");
+      const MarketDataEvent* e = c.convert(d);
+      CHECK(c.find(names[i]) == i);
+      CHECK(e && e->instrument == names[i]);
+    }
+    CHECK(c.find("rb2411") == -1);
+  }
+  {
+    // 先登记超长代码，再查同前缀、恰为16字节的代码
+    CtpDepthConverter c;
+    CHECK(c.add("ABCDEFGHIJKLMNOPQ") == 0);
+    CHECK(c.find("ABCDEFGHIJKLMNOP") == -1);
+    CThostFtdcDepthMarketDataField d{};
+    std::strcpy(d.InstrumentID, "ABCDEFGHIJKLMNOP");
+    std::strcpy(d.TradingDay, "20240102");
+    std::strcpy(d.UpdateTime, "09:00:00");
+    const MarketDataEvent* e = c.convert(d);
+    CHECK(e && e->instrument == "ABCDEFGHIJKLMNOP");
+    CHECK(c.size() == 2 && c.find("ABCDEFGHIJKLMNOP") == 1 && c.find("ABCDEFGHIJKLMNOPQ") == 0);
+  }
+
+  std::printf(g_fail ? "%d check(s) failed\n" : "all checks passed\n", g_fail);
+  return g_fail ? 1 : 0;
+}
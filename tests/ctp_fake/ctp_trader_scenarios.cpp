@@ -0,0 +1,182 @@
+// CtpTrader回报状态机场景：以头文件兼容的API替身直接驱动SPI回调，经TraderProxy与RiskManager核对事件与持仓
+#include "ctp/CtpTrader.h"
+#include "TradingSystem/TraderProxy.h"
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace ts;
+
+static int g_fail = 0;
+#define CHECK(c) do { if (!(c)) { std::printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #c); ++g_fail; } } while (0)
+
+static void rtn_order(CtpTrader* t, const std::string& ref, char st, int traded, int front = 7, int sess = 99,
+                      char sub = THOST_FTDC_OSS_Accepted) {
+  CThostFtdcOrderField o{};
+  std::snprintf(o.OrderRef, sizeof(o.OrderRef), "%12s", ref.c_str());
+  o.FrontID = front;
+  o.SessionID = sess;
+  std::snprintf(o.OrderSysID, sizeof(o.OrderSysID), "SYS%s", ref.c_str());
+  std::strcpy(o.ExchangeID, "SHFE");
+  o.OrderStatus = st;
+  o.OrderSubmitStatus = sub;
+  o.VolumeTraded = traded;
+  std::strcpy(o.StatusMsg, "msg");
+  t->OnRtnOrder(&o);
+}
+
+static void rtn_trade(CtpTrader* t, const std::string& ref, int vol, double px) {
+  CThostFtdcTradeField f{};
+  std::snprintf(f.OrderRef, sizeof(f.OrderRef), "%12s", ref.c_str());
+  std::snprintf(f.OrderSysID, sizeof(f.OrderSysID), "SYS%s", ref.c_str());
+  f.Volume = vol;
+  f.Price = px;
+  t->OnRtnTrade(&f);
+}
+
+int main() {
+  RiskConfig rc;
+  rc.max_pos_per_instrument = 100;
+  rc.max_orders_per_bar = 100;
+  rc.min_order_interval_ms = 0;
+  RiskManager risk(rc);
+  auto owned = std::make_unique<CtpTrader>();
+  CtpTrader* t = owned.get();
+  TraderProxy px(std::move(owned), &risk);
+  std::vector<OrderStatusEvent> evs;
+  px.set_order_status_handler([&](const OrderStatusEvent& e) {
+    std::printf("  ev id=%s %s fill=%d@%g rem=%d msg=%s\n", e.order_id.c_str(), e.status.c_str(), e.filled_qty,
+                e.fill_price, e.remaining_qty, e.message.c_str());
+    evs.push_back(e);
+  });
+  auto last = [&](const std::string& id) -> std::string {
+    for (auto it = evs.rbegin(); it != evs.rend(); ++it)
+      if (it->order_id == id) return it->status;
+    return std::string();
+  };
+  auto pos = [&]() { return risk.positions().count("rb2410") ? risk.positions().at("rb2410") : 0; };
+
+  CThostFtdcRspUserLoginField lg{};
+  lg.FrontID = 7;
+  lg.SessionID = 99;
+  std::strcpy(lg.MaxOrderRef, "100");
+  CThostFtdcRspInfoField ok{};
+  t->OnRspUserLogin(&lg, &ok, 1, true);
+
+  OrderRequest r;
+  r.instrument = "rb2410";
+  r.direction = Direction::Buy;
+  r.offset = Offset::Open;
+  r.type = OrderType::Limit;
+  r.price = 10;
+  r.volume = 3;
+
+  std::printf("1) fill in two trades\n");
+  std::string a = px.place_order(r);
+  CHECK(a == "101");
+  CHECK(std::string(g_api->inserts.back().OrderRef) == "101");
+  CHECK(g_api->inserts.back().TimeCondition == THOST_FTDC_TC_GFD);
+  rtn_order(t, a, THOST_FTDC_OST_Unknown, 0, 7, 99, THOST_FTDC_OSS_InsertSubmitted);
+  rtn_order(t, a, THOST_FTDC_OST_NoTradeQueueing, 0);
+  rtn_trade(t, a, 1, 10);
+  rtn_order(t, a, THOST_FTDC_OST_PartTradedQueueing, 1);
+  rtn_order(t, a, THOST_FTDC_OST_AllTraded, 3);
+  rtn_trade(t, a, 2, 11);
+  CHECK(last(a) == "Filled");
+  CHECK(pos() == 3);
+  CHECK(risk.pending_request(a) == nullptr);
+
+  std::printf("2) cancel with trade arriving after the cancel report\n");
+  r.volume = 2;
+  std::string b = px.place_order(r);
+  rtn_order(t, b, THOST_FTDC_OST_NoTradeQueueing, 0);
+  CHECK(px.cancel_order(b));
+  const auto& act = g_api->actions.back();
+  CHECK(std::string(act.OrderRef) == b && act.FrontID == 7 && act.SessionID == 99);
+  CHECK(std::string(act.ExchangeID) == "SHFE");
+  rtn_order(t, b, THOST_FTDC_OST_Canceled, 1);
+  CHECK(last(b) == "Accepted");  // 成交补齐前不发Canceled
+  rtn_trade(t, b, 1, 12);
+  CHECK(last(b) == "Canceled");
+  CHECK(pos() == 4);
+  CHECK(risk.pending_request(b) == nullptr);
+  CHECK(!px.cancel_order(b));
+
+  std::printf("3) insert error\n");
+  std::string d = px.place_order(r);
+  CThostFtdcInputOrderField in = g_api->inserts.back();
+  CThostFtdcRspInfoField bad{};
+  bad.ErrorID = 31;
+  std::strcpy(bad.ErrorMsg, "no money");
+  t->OnRspOrderInsert(&in, &bad, 0, true);
+  CHECK(last(d) == "Rejected");
+  CHECK(risk.pending_request(d) == nullptr);
+
+  std::printf("4) other session ignored\n");
+  std::string e = px.place_order(r);
+  rtn_order(t, e, THOST_FTDC_OST_Canceled, 0, 8, 5);
+  CHECK(risk.pending_request(e) != nullptr);
+
+  std::printf("5) modify: replacement sent only after the original is canceled\n");
+  size_t ins0 = g_api->inserts.size();
+  std::string m = px.modify_order(e, 9.5, 1);
+  CHECK(!m.empty() && m != e);
+  CHECK(g_api->inserts.size() == ins0);
+  CHECK(risk.pending_request(e) != nullptr && risk.pending_request(m) != nullptr);
+  rtn_order(t, e, THOST_FTDC_OST_Canceled, 0);
+  CHECK(last(e) == "Canceled");
+  CHECK(g_api->inserts.size() == ins0 + 1);
+  CHECK(std::string(g_api->inserts.back().OrderRef) == m);
+  CHECK(g_api->inserts.back().LimitPrice == 9.5 && g_api->inserts.back().VolumeTotalOriginal == 1);
+  rtn_order(t, m, THOST_FTDC_OST_NoTradeQueueing, 0);
+  CHECK(last(m) == "Accepted");
+
+  std::printf("6) modify: original fills before the cancel takes effect\n");
+  r.volume = 1;
+  std::string g = px.place_order(r);
+  rtn_order(t, g, THOST_FTDC_OST_NoTradeQueueing, 0);
+  ins0 = g_api->inserts.size();
+  const int pos0 = pos();
+  std::string gm = px.modify_order(g, 9.0, 1);
+  rtn_trade(t, g, 1, 10);
+  rtn_order(t, g, THOST_FTDC_OST_AllTraded, 1);
+  CHECK(last(g) == "Filled");
+  CHECK(last(gm) == "Rejected");
+  CHECK(g_api->inserts.size() == ins0);
+  CHECK(pos() == pos0 + 1);
+  CHECK(risk.pending_request(gm) == nullptr);
+
+  std::printf("7) modify and cancel a parked replacement\n");
+  std::string h = px.place_order(r);
+  std::string hm = px.modify_order(h, 9.0, 1);
+  ins0 = g_api->inserts.size();
+  CHECK(px.modify_order(hm, 8.5, 2) == hm);
+  CHECK(px.modify_order(h, 8.0, 1).empty());  // 原单已有挂起的替换单
+  CHECK(px.cancel_order(hm));
+  CHECK(last(hm) == "Canceled");
+  rtn_order(t, h, THOST_FTDC_OST_Canceled, 0);
+  CHECK(g_api->inserts.size() == ins0);
+  CHECK(risk.pending_request(h) == nullptr && risk.pending_request(hm) == nullptr);
+
+  std::printf("8) send failure\n");
+  g_api->fail_next = true;
+  CHECK(px.place_order(r).empty());
+  std::string n = px.place_order(r);
+  CHECK(!n.empty());
+
+  std::printf("9) table wrap\n");
+  {
+    CtpOrderTable tbl(4);
+    OrderRequest q;
+    q.volume = 1;
+    for (int i = 1; i <= 4; ++i) tbl.acquire(i, q);
+    CHECK(tbl.acquire(5, q) == nullptr);
+    OrderStatusEvent ev[2];
+    tbl.on_order(1, CtpOrderTable::Report::Done, 0, "", "", "x", ev);
+    CHECK(tbl.acquire(5, q) != nullptr);
+    CHECK(tbl.find(1) == nullptr);
+  }
+
+  std::printf(g_fail ? "%d check(s) failed\n" : "all checks passed\n", g_fail);
+  return g_fail ? 1 : 0;
+}
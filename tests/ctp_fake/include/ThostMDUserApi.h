@@ -0,0 +1,37 @@
+#pragma once
+#include <cstring>
+struct CThostFtdcRspInfoField { int ErrorID; char ErrorMsg[81]; };
+struct CThostFtdcReqUserLoginField { char TradingDay[9]; char BrokerID[11]; char UserID[16]; char Password[41]; };
+struct CThostFtdcRspUserLoginField { int FrontID; int SessionID; char MaxOrderRef[13]; };
+// 字段顺序与类型取自 6.6.x SDK
+struct CThostFtdcDepthMarketDataField {
+  char TradingDay[9]; char reserve1[31]; char ExchangeID[9]; char reserve2[31];
+  double LastPrice, PreSettlementPrice, PreClosePrice, PreOpenInterest, OpenPrice, HighestPrice, LowestPrice;
+  int Volume; double Turnover; double OpenInterest; double ClosePrice, SettlementPrice, UpperLimitPrice, LowerLimitPrice, PreDelta, CurrDelta;
+  char UpdateTime[9]; int UpdateMillisec;
+  double BidPrice1; int BidVolume1; double AskPrice1; int AskVolume1;
+  double BidPrice2; int BidVolume2; double AskPrice2; int AskVolume2;
+  double BidPrice3; int BidVolume3; double AskPrice3; int AskVolume3;
+  double BidPrice4; int BidVolume4; double AskPrice4; int AskVolume4;
+  double BidPrice5; int BidVolume5; double AskPrice5; int AskVolume5;
+  double AveragePrice; char ActionDay[9]; char InstrumentID[81]; char ExchangeInstID[81];
+  double BandingUpperPrice, BandingLowerPrice;
+};
+class CThostFtdcMdSpi {
+ public:
+  virtual ~CThostFtdcMdSpi() = default;
+  virtual void OnFrontConnected() {}
+  virtual void OnFrontDisconnected(int) {}
+  virtual void OnRspUserLogin(CThostFtdcRspUserLoginField*, CThostFtdcRspInfoField*, int, bool) {}
+  virtual void OnRtnDepthMarketData(CThostFtdcDepthMarketDataField*) {}
+};
+class CThostFtdcMdApi {
+ public:
+  static CThostFtdcMdApi* CreateFtdcMdApi(const char* = "", bool = false, bool = false) { return new CThostFtdcMdApi(); }
+  void RegisterSpi(CThostFtdcMdSpi*) {}
+  void RegisterFront(char*) {}
+  void Init() {}
+  void Release() { delete this; }
+  int ReqUserLogin(CThostFtdcReqUserLoginField*, int) { return 0; }
+  int SubscribeMarketData(char**, int) { return 0; }
+};
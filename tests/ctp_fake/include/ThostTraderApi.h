@@ -0,0 +1,72 @@
+#pragma once
+// 头文件兼容的CTP交易API替身：仅含CtpTrader用到的类型与常量，值取自官方SDK
+#include <cstring>
+#include <vector>
+#include <string>
+typedef char TThostFtdcOrderRefType[13];
+#define THOST_FTDC_D_Buy '0'
+#define THOST_FTDC_D_Sell '1'
+#define THOST_FTDC_OF_Open '0'
+#define THOST_FTDC_OF_Close '1'
+#define THOST_FTDC_HF_Speculation '1'
+#define THOST_FTDC_OPT_AnyPrice '1'
+#define THOST_FTDC_OPT_LimitPrice '2'
+#define THOST_FTDC_TC_IOC '1'
+#define THOST_FTDC_TC_GFD '3'
+#define THOST_FTDC_VC_AV '1'
+#define THOST_FTDC_VC_CV '3'
+#define THOST_FTDC_CC_Immediately '1'
+#define THOST_FTDC_FCC_NotForceClose '0'
+#define THOST_FTDC_AF_Delete '0'
+#define THOST_FTDC_OST_AllTraded '0'
+#define THOST_FTDC_OST_PartTradedQueueing '1'
+#define THOST_FTDC_OST_PartTradedNotQueueing '2'
+#define THOST_FTDC_OST_NoTradeQueueing '3'
+#define THOST_FTDC_OST_NoTradeNotQueueing '4'
+#define THOST_FTDC_OST_Canceled '5'
+#define THOST_FTDC_OST_Unknown 'a'
+#define THOST_FTDC_OSS_InsertSubmitted '0'
+#define THOST_FTDC_OSS_Accepted '3'
+#define THOST_FTDC_OSS_InsertRejected '4'
+struct CThostFtdcRspInfoField { int ErrorID; char ErrorMsg[81]; };
+struct CThostFtdcReqUserLoginField { char TradingDay[9]; char BrokerID[11]; char UserID[16]; char Password[41]; };
+struct CThostFtdcRspUserLoginField { int FrontID; int SessionID; char MaxOrderRef[13]; };
+struct CThostFtdcInputOrderField { char BrokerID[11]; char InvestorID[13]; char InstrumentID[81]; TThostFtdcOrderRefType OrderRef;
+  char OrderPriceType; char Direction; char CombOffsetFlag[5]; char CombHedgeFlag[5]; double LimitPrice; int VolumeTotalOriginal;
+  char TimeCondition; char VolumeCondition; int MinVolume; char ContingentCondition; char ForceCloseReason; };
+struct CThostFtdcInputOrderActionField { char BrokerID[11]; char InvestorID[13]; TThostFtdcOrderRefType OrderRef; int FrontID; int SessionID;
+  char ExchangeID[9]; char OrderSysID[21]; char ActionFlag; char UserID[16]; char InstrumentID[81]; };
+struct CThostFtdcOrderActionField { TThostFtdcOrderRefType OrderRef; int FrontID; int SessionID; };
+struct CThostFtdcOrderField { TThostFtdcOrderRefType OrderRef; int FrontID; int SessionID; char OrderSysID[21]; char ExchangeID[9];
+  char OrderStatus; char OrderSubmitStatus; int VolumeTraded; char StatusMsg[81]; };
+struct CThostFtdcTradeField { TThostFtdcOrderRefType OrderRef; char OrderSysID[21]; double Price; int Volume; };
+class CThostFtdcTraderSpi {
+ public:
+  virtual ~CThostFtdcTraderSpi() = default;
+  virtual void OnFrontConnected() {}
+  virtual void OnFrontDisconnected(int) {}
+  virtual void OnRspUserLogin(CThostFtdcRspUserLoginField*, CThostFtdcRspInfoField*, int, bool) {}
+  virtual void OnRspOrderInsert(CThostFtdcInputOrderField*, CThostFtdcRspInfoField*, int, bool) {}
+  virtual void OnErrRtnOrderInsert(CThostFtdcInputOrderField*, CThostFtdcRspInfoField*) {}
+  virtual void OnRspOrderAction(CThostFtdcInputOrderActionField*, CThostFtdcRspInfoField*, int, bool) {}
+  virtual void OnErrRtnOrderAction(CThostFtdcOrderActionField*, CThostFtdcRspInfoField*) {}
+  virtual void OnRtnOrder(CThostFtdcOrderField*) {}
+  virtual void OnRtnTrade(CThostFtdcTradeField*) {}
+};
+class CThostFtdcTraderApi {
+ public:
+  static CThostFtdcTraderApi* CreateFtdcTraderApi(const char* = "");
+  void RegisterSpi(CThostFtdcTraderSpi* s) { spi = s; }
+  void RegisterFront(char*) {}
+  void Init() {}
+  void Release() { delete this; }
+  int ReqUserLogin(CThostFtdcReqUserLoginField*, int) { return 0; }
+  int ReqOrderInsert(CThostFtdcInputOrderField* f, int) { inserts.push_back(*f); return fail_next ? (fail_next = false, -1) : 0; }
+  int ReqOrderAction(CThostFtdcInputOrderActionField* f, int) { actions.push_back(*f); return 0; }
+  CThostFtdcTraderSpi* spi{nullptr};
+  bool fail_next{false};
+  std::vector<CThostFtdcInputOrderField> inserts;
+  std::vector<CThostFtdcInputOrderActionField> actions;
+};
+inline CThostFtdcTraderApi* g_api = nullptr;
+inline CThostFtdcTraderApi* CThostFtdcTraderApi::CreateFtdcTraderApi(const char*) { return g_api = new CThostFtdcTraderApi(); }
@@ -0,0 +1,31 @@
+// 逐Tick数据清洗工具：并行切块校验 + 有序归并，输出规范化CSV与异常报告
+// 用法：tick_cleaner <ticks.csv> <clean.csv> [anomalies.csv] [threads]
+#include "TradingSystem/TickCleaner.h"
+#include <iostream>
+#include <string>
+
+using namespace ts;
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0] << " <ticks.csv> <clean.csv> [anomalies.csv] [threads]" << std::endl;
+    return 2;
+  }
+  TickCleanOptions opts;
+  std::string anomalies = argc > 3 ? argv[3] : "";
+  if (argc > 4) {
+    try { opts.threads = static_cast<unsigned>(std::max(0, std::stoi(argv[4]))); } catch (...) {}
+  }
+  TickCleanReport rep;
+  std::string err;
+  if (!clean_tick_file(argv[1], argv[2], anomalies, opts, &rep, &err)) {
+    std::cerr << "[Clean] " << err << std::endl;
+    return 1;
+  }
+  std::cout << "[Clean] lines=" << rep.lines << " kept=" << rep.kept << " threads=" << rep.threads
+            << " ms=" << rep.elapsed_ms << std::endl;
+  for (int i = 0; i < static_cast<int>(TickAnomaly::Count); ++i) {
+    std::cout << "  " << tick_anomaly_name(static_cast<TickAnomaly>(i)) << "=" << rep.counts[i] << std::endl;
+  }
+  return 0;
+}